@@ -44,7 +44,9 @@ public class Character2DEditor : ModuleRules
             });
         
         
-        PrivateDependencyModuleNames.AddRange(new string[] {"MeshUtilitiesCommon"
+        PrivateDependencyModuleNames.AddRange(new string[] {"MeshUtilitiesCommon",
+            "ImageCore",
+            "Json"
         });
     }
 }
\ No newline at end of file
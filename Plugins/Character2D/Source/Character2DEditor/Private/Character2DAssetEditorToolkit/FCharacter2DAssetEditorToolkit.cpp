@@ -18,6 +18,21 @@ const FName FCharacter2DAssetEditorToolkit::SpriteDetailsTabID(TEXT("Character2D
 const FName FCharacter2DAssetEditorToolkit::ActionsTabID(TEXT("Character2DAssetEditor_Actions"));
 const FName FCharacter2DAssetEditorToolkit::PresetsTabID(TEXT("Character2DAssetEditor_Presets"));
 
+namespace
+{
+	/**
+	 * Категория свойства верхнего уровня ассета, которому принадлежит узел: поля слоёв,
+	 * наборов выражений и векторов имеют свои категории, но показываются вместе с владельцем
+	 */
+	FString GetOwningAssetCategory(const FPropertyAndParent& PropertyAndParent)
+	{
+		const FProperty* TopLevel = PropertyAndParent.ParentProperties.Num() > 0
+			? PropertyAndParent.ParentProperties.Last()
+			: &PropertyAndParent.Property;
+		return TopLevel->GetMetaData(TEXT("Category"));
+	}
+}
+
 void FCharacter2DAssetEditorToolkit::InitEditor(EToolkitMode::Type Mode,
                                                 const TSharedPtr<IToolkitHost>& Host,
                                                 UCharacter2DAsset* InAsset)
@@ -135,13 +150,13 @@ void FCharacter2DAssetEditorToolkit::InitEditor(EToolkitMode::Type Mode,
 						switch (CurrentMode)
 						{
 						case ECharacter2DEditMode::Body:
-							NewPart->Mesh = AssetBeingEdited->Body.Mesh;
+							NewPart->Mesh = AssetBeingEdited->Body.Mesh.LoadSynchronous();
 							break;
 						case ECharacter2DEditMode::Arms:
-							NewPart->Mesh = AssetBeingEdited->Arms.Mesh;
+							NewPart->Mesh = AssetBeingEdited->Arms.Mesh.LoadSynchronous();
 							break;
 						case ECharacter2DEditMode::Head:
-							NewPart->Mesh = AssetBeingEdited->Head.Mesh;
+							NewPart->Mesh = AssetBeingEdited->Head.Mesh.LoadSynchronous();
 							break;
 						default:
 							break;
@@ -389,17 +404,8 @@ TSharedRef<IDetailsView> FCharacter2DAssetEditorToolkit::CreateSkeletalDetailsVi
     DetailsView->SetIsPropertyVisibleDelegate(
         FIsPropertyVisible::CreateLambda([](const FPropertyAndParent& PropertyAndParent) -> bool
         {
-            const FProperty* Property = &PropertyAndParent.Property;
-            const FString PropertyName = Property->GetName();
-            const FString CategoryName = Property->GetMetaData(TEXT("Category"));
-
-            // Показываем свойства, относящиеся к Skeletal или связанные с Body/Arms/Head/GlobalScale/SkeletalGlobalOffset
-            if (CategoryName.Contains(TEXT("Skeletal")) ||
-                PropertyName.Contains(TEXT("Body")) ||
-                PropertyName.Contains(TEXT("Arms")) ||
-                PropertyName.Contains(TEXT("Head")) ||
-                PropertyName.Contains(TEXT("GlobalScale")) ||
-                PropertyName.Contains(TEXT("SkeletalGlobalOffset")))
+            // Скелетные части (Body/Arms/Head), общее смещение и масштаб — категория Skeletal ассета
+            if (GetOwningAssetCategory(PropertyAndParent) == TEXT("Skeletal"))
             {
                 return true;
             }
@@ -438,26 +444,9 @@ TSharedRef<IDetailsView> FCharacter2DAssetEditorToolkit::CreateSpriteDetailsView
 	DetailsView->SetIsPropertyVisibleDelegate(
 		FIsPropertyVisible::CreateLambda([](const FPropertyAndParent& PropertyAndParent) -> bool
 		{
-			const FProperty* Property = &PropertyAndParent.Property;
-			const FString PropertyName = Property->GetName();
-			const FString CategoryName = Property->GetMetaData(TEXT("Category"));
-
-			// Скрываем нежелательные категории
-			if (CategoryName.Contains(TEXT("Skeletal")) ||
-				CategoryName.Contains(TEXT("Visual Novel")) ||
-				CategoryName.Contains(TEXT("General")))
-			{
-				return false;
-			}
-
-			// Показываем категории связанные со спрайтами
-			if (CategoryName.StartsWith(TEXT("Sprite")) ||
-				CategoryName == TEXT("Blink") ||
-				CategoryName == TEXT("Talk") ||
-				CategoryName.Contains(TEXT("Blink|")) ||
-				CategoryName.Contains(TEXT("Talk|")) ||
-				CategoryName.Contains(TEXT("Sprite|")) ||
-				CategoryName == TEXT("Vector")) // Для компонентов FVector (X, Y, Z)
+			// Слои (SpriteLayers), трансформ, моргание, разговор, наборы выражений и атлас — категории Sprite и Sprite|*
+			const FString CategoryName = GetOwningAssetCategory(PropertyAndParent);
+			if (CategoryName == TEXT("Sprite") || CategoryName.StartsWith(TEXT("Sprite|")))
 			{
 				return true;
 			}
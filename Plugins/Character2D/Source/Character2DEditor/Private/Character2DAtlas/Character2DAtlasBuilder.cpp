@@ -0,0 +1,323 @@
+#include "Character2DAtlas/Character2DAtlasBuilder.h"
+#include "Character2DAsset.h"
+
+#include "PaperSprite.h"
+#include "Engine/Texture2D.h"
+#include "ImageCore.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/ObjectSaveContext.h"
+
+static const TCHAR* SpriteAtlasTextureName = TEXT("SpriteAtlas");
+
+// ─────────────────────────────────────────────────────────────────────────────
+// helper-структуры
+// ─────────────────────────────────────────────────────────────────────────────
+struct FAtlasSourceFrame
+{
+	UPaperSprite* Sprite   = nullptr;
+	const FImage* Image    = nullptr;
+	FIntRect      PixelRect;              // обрезанная область в исходной текстуре
+	FBox2D        LocalRect = FBox2D(ForceInit);
+	FIntPoint     AtlasPos  = FIntPoint::ZeroValue;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Обрезка одного спрайта
+// ─────────────────────────────────────────────────────────────────────────────
+static bool TrimSprite(UPaperSprite* Sprite, const FImage& Image, FAtlasSourceFrame& OutFrame)
+{
+	const TArray<FVector4>& BakedRenderData = Sprite->BakedRenderData;
+	if (BakedRenderData.Num() < 3)
+		return false;
+
+	FBox2D XYBounds(ForceInit);
+	FBox2D UVBounds(ForceInit);
+	for (const FVector4& XYUV : BakedRenderData)
+	{
+		XYBounds += FVector2D(XYUV.X, XYUV.Y);
+		UVBounds += FVector2D(XYUV.Z, XYUV.W);
+	}
+
+	const FVector2D UVSize = UVBounds.GetSize();
+	if (UVSize.X <= UE_SMALL_NUMBER || UVSize.Y <= UE_SMALL_NUMBER)
+		return false;
+
+	// XY вправо/вверх, UV вправо/вниз; повёрнутые в листе спрайты этому не подчиняются
+	const FVector2D Scale(XYBounds.GetSize().X / UVSize.X, XYBounds.GetSize().Y / UVSize.Y);
+	auto UVToXY = [&](double U, double V)
+	{
+		return FVector2D(XYBounds.Min.X + (U - UVBounds.Min.X) * Scale.X,
+		                 XYBounds.Max.Y - (V - UVBounds.Min.Y) * Scale.Y);
+	};
+
+	const double Tolerance = 0.5 * FMath::Max(Scale.X / Image.SizeX, Scale.Y / Image.SizeY);
+	for (const FVector4& XYUV : BakedRenderData)
+	{
+		if (!UVToXY(XYUV.Z, XYUV.W).Equals(FVector2D(XYUV.X, XYUV.Y), Tolerance))
+			return false;
+	}
+
+	const FIntRect Region(
+		FMath::Clamp(FMath::FloorToInt(UVBounds.Min.X * Image.SizeX), 0, Image.SizeX),
+		FMath::Clamp(FMath::FloorToInt(UVBounds.Min.Y * Image.SizeY), 0, Image.SizeY),
+		FMath::Clamp(FMath::CeilToInt(UVBounds.Max.X * Image.SizeX), 0, Image.SizeX),
+		FMath::Clamp(FMath::CeilToInt(UVBounds.Max.Y * Image.SizeY), 0, Image.SizeY));
+
+	const TArrayView64<const FColor> Pixels = Image.AsBGRA8();
+	FIntRect Trimmed(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
+	for (int32 Y = Region.Min.Y; Y < Region.Max.Y; ++Y)
+	for (int32 X = Region.Min.X; X < Region.Max.X; ++X)
+	{
+		if (Pixels[(int64)Y * Image.SizeX + X].A > 0)
+		{
+			Trimmed.Include(FIntPoint(X, Y));
+		}
+	}
+	if (Trimmed.Min.X > Trimmed.Max.X)
+		return false;
+
+	// +1px прозрачной каймы под билинейную фильтрацию
+	Trimmed.Min = FIntPoint(FMath::Max(Trimmed.Min.X - 1, Region.Min.X), FMath::Max(Trimmed.Min.Y - 1, Region.Min.Y));
+	Trimmed.Max = FIntPoint(FMath::Min(Trimmed.Max.X + 2, Region.Max.X), FMath::Min(Trimmed.Max.Y + 2, Region.Max.Y));
+
+	OutFrame.Sprite    = Sprite;
+	OutFrame.Image     = &Image;
+	OutFrame.PixelRect = Trimmed;
+
+	const FVector2D TopLeft     = UVToXY((double)Trimmed.Min.X / Image.SizeX, (double)Trimmed.Min.Y / Image.SizeY);
+	const FVector2D BottomRight = UVToXY((double)Trimmed.Max.X / Image.SizeX, (double)Trimmed.Max.Y / Image.SizeY);
+	OutFrame.LocalRect = FBox2D(FVector2D(TopLeft.X, BottomRight.Y), FVector2D(BottomRight.X, TopLeft.Y));
+	return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Упаковка полками: кадры по убыванию высоты, ширина — степень двойки
+// ─────────────────────────────────────────────────────────────────────────────
+static FIntPoint PackFrames(TArray<FAtlasSourceFrame>& Frames)
+{
+	const int32 Padding = Character2DAtlasBuilder::FramePadding;
+
+	int64 TotalArea = 0;
+	int32 MaxWidth  = 0;
+	for (const FAtlasSourceFrame& Frame : Frames)
+	{
+		TotalArea += (int64)(Frame.PixelRect.Width() + Padding) * (Frame.PixelRect.Height() + Padding);
+		MaxWidth   = FMath::Max(MaxWidth, Frame.PixelRect.Width() + Padding * 2);
+	}
+
+	const int32 AtlasWidth = (int32)FMath::RoundUpToPowerOfTwo(
+		(uint32)FMath::Max(MaxWidth, FMath::CeilToInt(FMath::Sqrt((double)TotalArea))));
+
+	TArray<FAtlasSourceFrame*> Sorted;
+	for (FAtlasSourceFrame& Frame : Frames)
+	{
+		Sorted.Add(&Frame);
+	}
+	Sorted.Sort([](const FAtlasSourceFrame& A, const FAtlasSourceFrame& B)
+	{
+		return A.PixelRect.Height() > B.PixelRect.Height();
+	});
+
+	FIntPoint Cursor(Padding, Padding);
+	int32 ShelfHeight = 0;
+	for (FAtlasSourceFrame* Frame : Sorted)
+	{
+		if (Cursor.X + Frame->PixelRect.Width() + Padding > AtlasWidth)
+		{
+			Cursor = FIntPoint(Padding, Cursor.Y + ShelfHeight + Padding);
+			ShelfHeight = 0;
+		}
+		Frame->AtlasPos = Cursor;
+		Cursor.X   += Frame->PixelRect.Width() + Padding;
+		ShelfHeight = FMath::Max(ShelfHeight, Frame->PixelRect.Height());
+	}
+
+	return FIntPoint(AtlasWidth, (int32)FMath::RoundUpToPowerOfTwo((uint32)(Cursor.Y + ShelfHeight + Padding)));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Character2DAtlasBuilder
+// ─────────────────────────────────────────────────────────────────────────────
+bool Character2DAtlasBuilder::BuildSpriteAtlas(UCharacter2DAsset* Asset)
+{
+	if (!IsValid(Asset))
+		return false;
+
+	TArray<UPaperSprite*> Sprites;
+	Asset->GatherAtlasSprites(Sprites);
+
+	// Исходники читаются один раз на текстуру: слои часто лежат в одном листе.
+	// FImage в куче — кадры держат на него указатель, а рост TMap переносит значения
+	TMap<UTexture2D*, TUniquePtr<FImage>> SourceImages;
+	TArray<FAtlasSourceFrame> Frames;
+	UTexture2D* ReferenceTexture = nullptr;
+
+	for (UPaperSprite* Sprite : Sprites)
+	{
+		UTexture2D* Texture = Sprite->GetBakedTexture();
+		if (!Texture || !Texture->Source.IsValid())
+			continue;
+
+		const TUniquePtr<FImage>* CachedImage = SourceImages.Find(Texture);
+		FImage* Image = CachedImage ? CachedImage->Get() : nullptr;
+		if (!Image)
+		{
+			FImage Mip;
+			if (!Texture->Source.GetMipImage(Mip, 0, 0, 0))
+				continue;
+
+			Image = SourceImages.Add(Texture, MakeUnique<FImage>()).Get();
+			Mip.CopyTo(*Image, ERawImageFormat::BGRA8, Texture->SRGB ? EGammaSpace::sRGB : EGammaSpace::Linear);
+		}
+
+		FAtlasSourceFrame Frame;
+		if (TrimSprite(Sprite, *Image, Frame))
+		{
+			Frames.Add(Frame);
+			ReferenceTexture = ReferenceTexture ? ReferenceTexture : Texture;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("Character2D atlas: '%s' kept out of atlas (rotated, empty or unreadable)"), *Sprite->GetName());
+		}
+	}
+
+	if (Frames.IsEmpty())
+		return false;
+
+	const FIntPoint AtlasSize = PackFrames(Frames);
+	if (AtlasSize.X > 8192 || AtlasSize.Y > 8192)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Character2D atlas for '%s' exceeds 8192px (%dx%d), skipped"), *Asset->GetName(), AtlasSize.X, AtlasSize.Y);
+		return false;
+	}
+
+	TArray<FColor> AtlasPixels;
+	AtlasPixels.SetNumZeroed(AtlasSize.X * AtlasSize.Y);
+
+	FCharacter2DSpriteAtlas NewAtlas;
+	NewAtlas.Frames.Reserve(Frames.Num());
+	for (const FAtlasSourceFrame& Frame : Frames)
+	{
+		const TArrayView64<const FColor> Source = Frame.Image->AsBGRA8();
+		for (int32 Row = 0; Row < Frame.PixelRect.Height(); ++Row)
+		{
+			FMemory::Memcpy(
+				&AtlasPixels[(Frame.AtlasPos.Y + Row) * AtlasSize.X + Frame.AtlasPos.X],
+				&Source[(int64)(Frame.PixelRect.Min.Y + Row) * Frame.Image->SizeX + Frame.PixelRect.Min.X],
+				Frame.PixelRect.Width() * sizeof(FColor));
+		}
+
+		FCharacter2DAtlasFrame& AtlasFrame = NewAtlas.Frames.AddDefaulted_GetRef();
+		AtlasFrame.SourceSprite = FSoftObjectPath(Frame.Sprite);
+		AtlasFrame.LocalRect    = Frame.LocalRect;
+		AtlasFrame.Material     = Frame.Sprite->GetDefaultMaterial();
+		AtlasFrame.UVRect       = FBox2D(
+			FVector2D((double)Frame.AtlasPos.X / AtlasSize.X, (double)Frame.AtlasPos.Y / AtlasSize.Y),
+			FVector2D((double)(Frame.AtlasPos.X + Frame.PixelRect.Width()) / AtlasSize.X,
+			          (double)(Frame.AtlasPos.Y + Frame.PixelRect.Height()) / AtlasSize.Y));
+	}
+
+	// Текстура атласа — вложенный объект ассета, уходит в тот же пакет
+	UTexture2D* AtlasTexture = FindObject<UTexture2D>(Asset, SpriteAtlasTextureName);
+	if (!AtlasTexture)
+	{
+		AtlasTexture = NewObject<UTexture2D>(Asset, SpriteAtlasTextureName);
+	}
+
+	AtlasTexture->PreEditChange(nullptr);
+	AtlasTexture->Source.Init(AtlasSize.X, AtlasSize.Y, 1, 1, TSF_BGRA8, reinterpret_cast<const uint8*>(AtlasPixels.GetData()));
+	AtlasTexture->SRGB                = ReferenceTexture->SRGB;
+	AtlasTexture->Filter              = ReferenceTexture->Filter;
+	AtlasTexture->LODGroup            = ReferenceTexture->LODGroup;
+	AtlasTexture->MipGenSettings      = ReferenceTexture->MipGenSettings;
+	AtlasTexture->CompressionSettings = ReferenceTexture->CompressionSettings;
+	AtlasTexture->PostEditChange();
+
+	NewAtlas.Texture    = AtlasTexture;
+	NewAtlas.SourceHash = Asset->ComputeSpriteAtlasHash();
+	Asset->SpriteAtlas  = MoveTemp(NewAtlas);
+
+	UE_LOG(LogTemp, Log, TEXT("Character2D atlas for '%s': %d frames, %dx%d"), *Asset->GetName(), Frames.Num(), AtlasSize.X, AtlasSize.Y);
+	return true;
+}
+
+void Character2DAtlasBuilder::ClearSpriteAtlas(UCharacter2DAsset* Asset)
+{
+	if (!IsValid(Asset))
+		return;
+
+	// Вынести текстуру из пакета, иначе она сохранится вместе с ассетом
+	if (UTexture2D* AtlasTexture = FindObject<UTexture2D>(Asset, SpriteAtlasTextureName))
+	{
+		AtlasTexture->ClearFlags(RF_Public | RF_Standalone);
+		AtlasTexture->Rename(nullptr, GetTransientPackage(), REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+	}
+	Asset->SpriteAtlas = FCharacter2DSpriteAtlas();
+}
+
+void Character2DAtlasBuilder::UpdateSpriteAtlas(UCharacter2DAsset* Asset)
+{
+	if (!IsValid(Asset))
+		return;
+
+	if (!Asset->bBuildSpriteAtlas)
+	{
+		if (Asset->SpriteAtlas.Texture || !Asset->SpriteAtlas.Frames.IsEmpty())
+		{
+			ClearSpriteAtlas(Asset);
+		}
+		return;
+	}
+
+	// Входы атласа не менялись — пересборка (чтение исходников, упаковка, PostEditChange текстуры) не нужна
+	if (Asset->IsSpriteAtlasUpToDate())
+		return;
+
+	if (!BuildSpriteAtlas(Asset))
+	{
+		ClearSpriteAtlas(Asset);
+	}
+}
+
+void Character2DAtlasBuilder::HandlePreSavePackage(UPackage* Package, FObjectPreSaveContext SaveContext)
+{
+	if (!Package)
+		return;
+
+	// Процедурные сохранения (автосейв, ресейв коммандлетом) не меняют содержимое пакета.
+	// Кук тоже процедурный, но он пересобирает устаревший атлас: спрайт могли поправить без пересохранения персонажа,
+	// а cooked-сборка хэш не сверяет и спрайтов из атласа не грузит
+	const bool bCooking = SaveContext.IsCooking();
+	if (SaveContext.IsProceduralSave() && !bCooking)
+		return;
+
+	// Сначала собрать ассеты: сборка создаёт объекты в том же пакете
+	TArray<UCharacter2DAsset*> Assets;
+	ForEachObjectWithPackage(Package, [&Assets](UObject* Object)
+	{
+		if (UCharacter2DAsset* Asset = Cast<UCharacter2DAsset>(Object))
+		{
+			Assets.Add(Asset);
+		}
+		return true;
+	}, false);
+
+	for (UCharacter2DAsset* Asset : Assets)
+	{
+		const bool bStaleAtCook = bCooking && Asset->bBuildSpriteAtlas && !Asset->IsSpriteAtlasUpToDate();
+		UpdateSpriteAtlas(Asset);
+
+		if (bStaleAtCook)
+		{
+			// Не собранный атлас снят (UpdateSpriteAtlas): слои рисуются исходными спрайтами, а не старыми кадрами
+			UE_LOG(LogTemp, Display, TEXT("Character2D atlas for '%s' was stale at cook: %s"), *Asset->GetName(),
+				Asset->SpriteAtlas.IsValid() ? TEXT("rebuilt") : TEXT("removed, sprites are drawn individually"));
+		}
+		if (bCooking && Asset->SpriteAtlas.IsValid() && !Asset->IsSpriteAtlasUpToDate())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Character2D atlas for '%s' is stale and could not be rebuilt for cook"), *Asset->GetName());
+		}
+	}
+}
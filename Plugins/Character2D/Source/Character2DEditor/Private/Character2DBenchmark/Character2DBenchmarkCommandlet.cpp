@@ -0,0 +1,435 @@
+#include "Character2DBenchmark/Character2DBenchmarkCommandlet.h"
+#include "Character2DActor.h"
+#include "Character2DAsset.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "PaperSprite.h"
+#include "PaperFlipbook.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectArray.h"
+
+#include <atomic>
+
+// ─────────────────────────────────────────────────────────────
+// helper-ы
+// ─────────────────────────────────────────────────────────────
+namespace
+{
+	double Percentile(TArray<double> Values, double Fraction)
+	{
+		if (Values.IsEmpty())
+			return 0.0;
+
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	}
+
+	double Mean(const TArray<double>& Values)
+	{
+		double Sum = 0.0;
+		for (const double Value : Values)
+			Sum += Value;
+		return Values.IsEmpty() ? 0.0 : Sum / Values.Num();
+	}
+
+	/**
+	 * Подменяет GMalloc на время коммандлета и считает запрошенные выделения всех потоков.
+	 * Ставится один раз, прогоны только включают счёт. Один статический экземпляр, Inner
+	 * после установки не сбрасывается: поток, прочитавший GMalloc до снятия обёртки,
+	 * продолжает ходить через неё во внутренний аллокатор.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		void Install()
+		{
+			if (GMalloc == this)
+				return;
+
+			Inner = GMalloc;
+			GMalloc = this;
+		}
+
+		/** GMalloc возвращается внутреннему аллокатору; сама обёртка остаётся рабочей */
+		void Uninstall()
+		{
+			SetCounting(false);
+			if (GMalloc == this)
+			{
+				GMalloc = Inner;
+			}
+		}
+
+		/** Обнуляет счётчики перед прогоном; счёт при этом выключен */
+		void ResetCounters()
+		{
+			SetCounting(false);
+			NumAllocations.store(0, std::memory_order_relaxed);
+			AllocatedBytes.store(0, std::memory_order_relaxed);
+		}
+
+		void SetCounting(bool bInCounting) { bCounting.store(bInCounting, std::memory_order_relaxed); }
+		uint64 GetNumAllocations() const { return NumAllocations.load(std::memory_order_relaxed); }
+		uint64 GetAllocatedBytes() const { return AllocatedBytes.load(std::memory_order_relaxed); }
+
+		// TryMalloc/MallocZeroed по умолчанию идут через Malloc — считаются один раз
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count(Size);
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			Count(Size);
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		void Count(SIZE_T Size)
+		{
+			// Realloc в 0 — это освобождение
+			if (Size > 0 && bCounting.load(std::memory_order_relaxed))
+			{
+				NumAllocations.fetch_add(1, std::memory_order_relaxed);
+				AllocatedBytes.fetch_add(Size, std::memory_order_relaxed);
+			}
+		}
+
+		FMalloc* Inner = nullptr;
+		std::atomic<bool> bCounting{false};
+		std::atomic<uint64> NumAllocations{0};
+		std::atomic<uint64> AllocatedBytes{0};
+	};
+
+	FCountingMalloc GCountingMalloc;
+
+	UPaperFlipbook* CreateFlipbook(UObject* Outer, const TCHAR* Name, UPaperSprite* Sprite, int32 NumFrames)
+	{
+		UPaperFlipbook* Flipbook = NewObject<UPaperFlipbook>(Outer, Name, RF_Transient);
+		FScopedFlipbookMutator Mutator(Flipbook);
+		Mutator.FramesPerSecond = 12.0f;
+		for (int32 Index = 0; Index < NumFrames; ++Index)
+		{
+			FPaperFlipbookKeyFrame& Frame = Mutator.KeyFrames.AddDefaulted_GetRef();
+			Frame.Sprite = Sprite;
+			Frame.FrameRun = 1;
+		}
+		return Flipbook;
+	}
+}
+
+UCharacter2DBenchmarkCommandlet::UCharacter2DBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+const TCHAR* UCharacter2DBenchmarkCommandlet::GetWorkloadName(EWorkload Workload)
+{
+	switch (Workload)
+	{
+	case EWorkload::Idle:    return TEXT("Idle");
+	case EWorkload::Blink:   return TEXT("Blink");
+	case EWorkload::Talk:    return TEXT("Talk");
+	case EWorkload::Emotion: return TEXT("Emotion");
+	case EWorkload::Fade:    return TEXT("Fade");
+	case EWorkload::Move:    return TEXT("Move");
+	case EWorkload::Mixed:   return TEXT("Mixed");
+	}
+	return TEXT("Unknown");
+}
+
+// ─────────────────────────────────────────────────────────────
+// Main
+// ─────────────────────────────────────────────────────────────
+int32 UCharacter2DBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString CountsParam = TEXT("1,10,100,1000");
+	FString WorkloadsParam = TEXT("Idle,Blink,Talk,Emotion,Fade,Move,Mixed");
+	FString OutputDir = FPaths::ProjectSavedDir() / TEXT("Character2D") / TEXT("Benchmark");
+	FParse::Value(*Params, TEXT("Counts="), CountsParam);
+	FParse::Value(*Params, TEXT("Workloads="), WorkloadsParam);
+	FParse::Value(*Params, TEXT("Output="), OutputDir);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), NumWarmupFrames);
+	NumFrames = FMath::Max(NumFrames, 1);
+	NumWarmupFrames = FMath::Max(NumWarmupFrames, 0);
+
+	TArray<int32> Counts;
+	TArray<FString> Tokens;
+	CountsParam.ParseIntoArray(Tokens, TEXT(","));
+	for (const FString& Token : Tokens)
+	{
+		const int32 Count = FCString::Atoi(*Token);
+		if (Count > 0)
+			Counts.Add(Count);
+	}
+
+	TArray<EWorkload> Workloads;
+	WorkloadsParam.ParseIntoArray(Tokens, TEXT(","));
+	for (const FString& Token : Tokens)
+	{
+		for (EWorkload Workload : {EWorkload::Idle, EWorkload::Blink, EWorkload::Talk, EWorkload::Emotion, EWorkload::Fade, EWorkload::Move, EWorkload::Mixed})
+		{
+			if (Token.TrimStartAndEnd().Equals(GetWorkloadName(Workload), ESearchCase::IgnoreCase))
+				Workloads.AddUnique(Workload);
+		}
+	}
+
+	if (Counts.IsEmpty() || Workloads.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Character2DBenchmark: nothing to run (Counts=%s, Workloads=%s)"), *CountsParam, *WorkloadsParam);
+		return 1;
+	}
+
+	UCharacter2DAsset* Asset = CreateSyntheticAsset();
+	Asset->AddToRoot();
+
+	// Обёртка ставится до первого мира и снимается после последнего: между прогонами только счётчики
+	GCountingMalloc.Install();
+
+	TArray<FRunResult> Results;
+	for (const EWorkload Workload : Workloads)
+	{
+		for (const int32 Count : Counts)
+		{
+			FRunResult& Result = Results.Add_GetRef(Run(Asset, Workload, Count));
+			UE_LOG(LogTemp, Display, TEXT("Character2DBenchmark: %-8s x%5d  mean %.3f ms  p95 %.3f ms  max %.3f ms  spawn %.1f ms  allocs %llu (%llu KB)  objects %+d"),
+				GetWorkloadName(Workload), Count, Mean(Result.FrameMs), Percentile(Result.FrameMs, 0.95), Percentile(Result.FrameMs, 1.0),
+				Result.SpawnMs, Result.NumAllocations, Result.AllocatedBytes / 1024, Result.ObjectDelta);
+		}
+	}
+
+	GCountingMalloc.Uninstall();
+	Asset->RemoveFromRoot();
+	return WriteResults(Results, OutputDir) ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Синтетический ассет
+// ─────────────────────────────────────────────────────────────
+UCharacter2DAsset* UCharacter2DBenchmarkCommandlet::CreateSyntheticAsset() const
+{
+	UCharacter2DAsset* Asset = NewObject<UCharacter2DAsset>(GetTransientPackage(), TEXT("Character2DBenchmarkAsset"), RF_Transient);
+
+	// Геометрия спрайтам не нужна: с -nullrhi меряется только game thread
+	UPaperSprite* Sprite = NewObject<UPaperSprite>(Asset, TEXT("BenchmarkSprite"), RF_Transient);
+
+	// Тот же состав, что у персонажа из старого фиксированного набора: тело, руки, голова и четыре слоя лица
+	Asset->AddSpriteLayer(TEXT("Body"), Sprite);
+	Asset->AddSpriteLayer(TEXT("Arms"), Sprite);
+	const int32 HeadId = Asset->AddSpriteLayer(TEXT("Head"), Sprite);
+	Asset->AddSpriteLayer(TEXT("Eyebrow"), Sprite, HeadId);
+	Asset->AddSpriteLayer(TEXT("Eyes"), Sprite, HeadId);
+	Asset->BlinkLayerId = Asset->AddSpriteLayer(TEXT("Eyelids"), Sprite, HeadId);
+	Asset->TalkLayerId = Asset->AddSpriteLayer(TEXT("Mouth"), Sprite, HeadId);
+
+	// Частые моргания, чтобы за прогон их было заметное число
+	FCharacter2DBlinkSettings& Blink = Asset->BlinkSettings;
+	Blink.BlinkFlipbook = CreateFlipbook(Asset, TEXT("BenchmarkBlink"), Sprite, 4);
+	Blink.BlinkIntervalMin = 0.5f;
+	Blink.BlinkIntervalMax = 1.5f;
+
+	Asset->TalkSettings.TalkFlipbook = CreateFlipbook(Asset, TEXT("BenchmarkTalk"), Sprite, 6);
+
+	// Сценарии сами включают моргание и разговор
+	Asset->bAutoBlink = false;
+	Asset->bAutoTalk = false;
+	return Asset;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Прогон
+// ─────────────────────────────────────────────────────────────
+UCharacter2DBenchmarkCommandlet::FRunResult UCharacter2DBenchmarkCommandlet::Run(UCharacter2DAsset* Asset, EWorkload Workload, int32 NumCharacters) const
+{
+	FRunResult Result;
+	Result.Workload = Workload;
+	Result.NumCharacters = NumCharacters;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("Character2DBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	TArray<ACharacter2DActor*> Actors;
+	Actors.Reserve(NumCharacters);
+
+	const uint64 SpawnStart = FPlatformTime::Cycles64();
+	for (int32 Index = 0; Index < NumCharacters; ++Index)
+	{
+		const FTransform Transform(FVector((Index % 32) * 200.0f, 0.0f, (Index / 32) * 300.0f));
+		ACharacter2DActor* Actor = World->SpawnActorDeferred<ACharacter2DActor>(ACharacter2DActor::StaticClass(), Transform,
+			nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		Actor->CharacterAsset = Asset;
+		Actor->BlinkSeed = Index + 1;
+		Actor->FinishSpawning(Transform);
+		Actors.Add(Actor);
+	}
+	Result.SpawnMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - SpawnStart);
+
+	// Команды сценария — тоже время game thread, поэтому входят в кадр
+	Result.FrameMs.Reserve(NumFrames);
+	GCountingMalloc.ResetCounters();
+	for (int32 Frame = 0; Frame < NumWarmupFrames + NumFrames; ++Frame)
+	{
+		// Прогрев (первые пулы, кэши) в счёт выделений не входит
+		if (Frame == NumWarmupFrames)
+			GCountingMalloc.SetCounting(true);
+
+		const uint64 FrameStart = FPlatformTime::Cycles64();
+		for (int32 Index = 0; Index < Actors.Num(); ++Index)
+		{
+			DriveWorkload(Workload, Actors[Index], Index, Frame);
+		}
+		World->Tick(LEVELTICK_All, FrameDeltaTime);
+		const double FrameMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FrameStart);
+
+		++GFrameCounter;
+		if (Frame >= NumWarmupFrames)
+			Result.FrameMs.Add(FrameMs);
+	}
+
+	Result.NumAllocations = GCountingMalloc.GetNumAllocations();
+	Result.AllocatedBytes = GCountingMalloc.GetAllocatedBytes();
+	GCountingMalloc.SetCounting(false);
+	Result.ObjectDelta = GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsBefore;
+
+	for (ACharacter2DActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	return Result;
+}
+
+void UCharacter2DBenchmarkCommandlet::DriveWorkload(EWorkload Workload, ACharacter2DActor* Actor, int32 Index, int32 Frame) const
+{
+	// Двухсекундный цикл; персонажи сдвинуты по фазе, чтобы команды не приходились на один кадр
+	constexpr int32 CycleFrames = 120;
+	const int32 Shifted = Frame + Index * 7;
+	const int32 Phase = Shifted % CycleFrames;
+	const int32 Cycle = Shifted / CycleFrames;
+	const bool bMixed = Workload == EWorkload::Mixed;
+
+	if ((Workload == EWorkload::Blink || bMixed) && Frame == 0)
+	{
+		Actor->EnableBlinking(true);
+	}
+
+	if ((Workload == EWorkload::Talk || bMixed) && Phase == 0)
+	{
+		Actor->EnableTalking(!Actor->IsTalking());
+	}
+
+	if ((Workload == EWorkload::Emotion || bMixed) && Phase == (bMixed ? 20 : 0))
+	{
+		static const ECharacter2DEmotionEffect Emotions[] =
+		{
+			ECharacter2DEmotionEffect::Shake,
+			ECharacter2DEmotionEffect::Pulse,
+			ECharacter2DEmotionEffect::ColorShift,
+			ECharacter2DEmotionEffect::Bounce,
+			ECharacter2DEmotionEffect::Flash
+		};
+		Actor->PlayEmotionWithDefaults(Emotions[(Cycle + Index) % UE_ARRAY_COUNT(Emotions)]);
+	}
+
+	if (Workload == EWorkload::Fade || bMixed)
+	{
+		if (Phase == (bMixed ? 40 : 0))
+			Actor->PlayFadeOut(0.5f);
+		else if (Phase == (bMixed ? 100 : 60))
+			Actor->PlayFadeIn(0.5f);
+	}
+
+	if ((Workload == EWorkload::Move || bMixed) && Phase == (bMixed ? 60 : 0))
+	{
+		const float Direction = (Cycle % 2 == 0) ? 1.0f : -1.0f;
+		Actor->MoveToLocation(Actor->GetActorLocation() + FVector(100.0f * Direction, 0.0f, 0.0f), 1.0f);
+	}
+}
+
+// ─────────────────────────────────────────────────────────────
+// CSV / JSON
+// ─────────────────────────────────────────────────────────────
+bool UCharacter2DBenchmarkCommandlet::WriteResults(const TArray<FRunResult>& Results, const FString& OutputDir) const
+{
+	// Summary.csv и Results.json несут одинаковые поля прогона (в JSON ещё сырые FrameMs)
+	FString Csv = TEXT("Workload,Characters,Frames,MeanMs,MedianMs,P95Ms,MaxMs,SpawnMs,Allocations,AllocatedBytes,AllocatedKB,ObjectDelta\n");
+	for (const FRunResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%s,%d,%d,%.4f,%.4f,%.4f,%.4f,%.2f,%llu,%llu,%llu,%d\n"),
+			GetWorkloadName(Result.Workload), Result.NumCharacters, Result.FrameMs.Num(),
+			Mean(Result.FrameMs), Percentile(Result.FrameMs, 0.5), Percentile(Result.FrameMs, 0.95), Percentile(Result.FrameMs, 1.0),
+			Result.SpawnMs, Result.NumAllocations, Result.AllocatedBytes, Result.AllocatedBytes / 1024, Result.ObjectDelta);
+	}
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("Frames"), NumFrames);
+	Writer->WriteValue(TEXT("WarmupFrames"), NumWarmupFrames);
+	Writer->WriteValue(TEXT("FrameDeltaTime"), FrameDeltaTime);
+	Writer->WriteArrayStart(TEXT("Runs"));
+	for (const FRunResult& Result : Results)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("Workload"), GetWorkloadName(Result.Workload));
+		Writer->WriteValue(TEXT("Characters"), Result.NumCharacters);
+		Writer->WriteValue(TEXT("Frames"), Result.FrameMs.Num());
+		Writer->WriteValue(TEXT("MeanMs"), Mean(Result.FrameMs));
+		Writer->WriteValue(TEXT("MedianMs"), Percentile(Result.FrameMs, 0.5));
+		Writer->WriteValue(TEXT("P95Ms"), Percentile(Result.FrameMs, 0.95));
+		Writer->WriteValue(TEXT("MaxMs"), Percentile(Result.FrameMs, 1.0));
+		Writer->WriteValue(TEXT("SpawnMs"), Result.SpawnMs);
+		Writer->WriteValue(TEXT("Allocations"), static_cast<int64>(Result.NumAllocations));
+		Writer->WriteValue(TEXT("AllocatedBytes"), static_cast<int64>(Result.AllocatedBytes));
+		Writer->WriteValue(TEXT("AllocatedKB"), static_cast<int64>(Result.AllocatedBytes / 1024));
+		Writer->WriteValue(TEXT("ObjectDelta"), Result.ObjectDelta);
+		Writer->WriteArrayStart(TEXT("FrameMs"));
+		for (const double FrameMs : Result.FrameMs)
+			Writer->WriteValue(FrameMs);
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	const FString CsvPath = OutputDir / TEXT("Summary.csv");
+	const FString JsonPath = OutputDir / TEXT("Results.json");
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(Json, *JsonPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Character2DBenchmark: failed to write results to %s"), *OutputDir);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Character2DBenchmark: results written to %s"), *FPaths::ConvertRelativePathToFull(OutputDir));
+	return true;
+}
@@ -0,0 +1,507 @@
+// ============================================================================
+// Character2DContourMesh.cpp   (контурный режим Character2DMeshGenerator)
+// ============================================================================
+//   маска Alpha > Threshold  →  контуры по границам пикселей (marching squares)
+//   →  Douglas-Peucker  →  дыры склеиваются с внешним контуром  →  ear clipping
+// Всё работает в пиксельных координатах текстуры (Y вниз) и вызывается из worker-потоков.
+
+#include "Character2DBuilderWindow/Character2DMeshGenerator.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// геометрия 2D
+// ─────────────────────────────────────────────────────────────────────────────
+// в double: на 8k-текстурах произведения координат не помещаются в мантиссу float
+static FORCEINLINE double Cross2D(const FVector2f& O, const FVector2f& A, const FVector2f& B)
+{
+	return (double(A.X) - O.X) * (double(B.Y) - O.Y) - (double(A.Y) - O.Y) * (double(B.X) - O.X);
+}
+
+static float SignedArea(const TArray<FVector2f>& Loop)
+{
+	double Area = 0.0;
+	for (int32 i = 0, j = Loop.Num() - 1; i < Loop.Num(); j = i++)
+		Area += double(Loop[j].X) * Loop[i].Y - double(Loop[i].X) * Loop[j].Y;
+	return float(Area * 0.5);
+}
+
+static float PointSegmentDistSquared(const FVector2f& P, const FVector2f& A, const FVector2f& B)
+{
+	const FVector2f AB = B - A;
+	const float     Len2 = AB.SizeSquared();
+	const float     T = Len2 > 0.f ? FMath::Clamp(FVector2f::DotProduct(P - A, AB) / Len2, 0.f, 1.f) : 0.f;
+	return FVector2f::DistSquared(P, A + AB * T);
+}
+
+static bool PointInTriangle(const FVector2f& P, const FVector2f& A, const FVector2f& B, const FVector2f& C)
+{
+	// треугольник CCW (Cross2D(A,B,C) > 0), граница считается внутренней
+	return Cross2D(A, B, P) >= 0.0 && Cross2D(B, C, P) >= 0.0 && Cross2D(C, A, P) >= 0.0;
+}
+
+static bool PointInPolygon(const TArray<FVector2f>& Poly, const FVector2f& P)
+{
+	bool bInside = false;
+	for (int32 i = 0, j = Poly.Num() - 1; i < Poly.Num(); j = i++)
+	{
+		const FVector2f& A = Poly[i];
+		const FVector2f& B = Poly[j];
+		if ((A.Y > P.Y) != (B.Y > P.Y) &&
+		    P.X < (B.X - A.X) * (P.Y - A.Y) / (B.Y - A.Y) + A.X)
+			bInside = !bInside;
+	}
+	return bInside;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// маска + трассировка
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** Бинарная маска области спрайта. Диагональные "седла" 2x2 закрашиваются —
+ *  иначе контур касается сам себя в точке и ear clipping на нём ломается. */
+static void BuildContourMask(const FCharacter2DAlphaMask& Mask, int32 X0, int32 Y0, int32 W, int32 H,
+                             uint8 AlphaThreshold, TArray<uint8>& OutBits)
+{
+	OutBits.SetNumUninitialized(W * H);
+	for (int32 Y = 0; Y < H; ++Y)
+	{
+		const uint8* Src = Mask.Alpha.GetData() + (Y0 + Y) * Mask.Width + X0;
+		uint8*       Dst = OutBits.GetData() + Y * W;
+		for (int32 X = 0; X < W; ++X)
+			Dst[X] = Src[X] > AlphaThreshold ? 1 : 0;
+	}
+
+	// пиксели только добавляются, поэтому цикл конечен (обычно 1-2 прохода)
+	for (bool bChanged = true; bChanged; )
+	{
+		bChanged = false;
+		for (int32 Y = 1; Y < H; ++Y)
+		for (int32 X = 1; X < W; ++X)
+		{
+			uint8& TL = OutBits[(Y-1)*W + X-1];
+			uint8& TR = OutBits[(Y-1)*W + X];
+			uint8& BL = OutBits[Y*W + X-1];
+			uint8& BR = OutBits[Y*W + X];
+
+			if (TL && BR && !TR && !BL)      { TR = 1; bChanged = true; }
+			else if (TR && BL && !TL && !BR) { TL = 1; bChanged = true; }
+		}
+	}
+}
+
+/** Контуры по рёбрам пикселей: непрозрачное справа по ходу (Y вниз),
+ *  внешние контуры получают положительную площадь, дыры — отрицательную. В контур попадают только углы. */
+static void TraceContours(const TArray<uint8>& Bits, int32 W, int32 H, TArray<TArray<FVector2f>>& OutLoops)
+{
+	// 0 +X, 1 +Y, 2 -X, 3 -Y
+	static const FIntPoint Dirs[4] = { {1,0}, {0,1}, {-1,0}, {0,-1} };
+	constexpr uint8 None = 0xFF;
+
+	const int32 Stride = W + 1;
+	auto IsSet = [&Bits, W, H](int32 X, int32 Y) { return X >= 0 && Y >= 0 && X < W && Y < H && Bits[Y*W + X]; };
+
+	// без сёдел у каждой вершины решётки не больше одного исходящего ребра
+	TArray<uint8> OutDir;
+	OutDir.Init(None, Stride * (H + 1));
+	for (int32 Y = 0; Y < H; ++Y)
+	for (int32 X = 0; X < W; ++X)
+	{
+		if (!IsSet(X, Y)) continue;
+		if (!IsSet(X, Y-1)) OutDir[Y*Stride + X]         = 0;
+		if (!IsSet(X+1, Y)) OutDir[Y*Stride + X+1]       = 1;
+		if (!IsSet(X, Y+1)) OutDir[(Y+1)*Stride + X+1]   = 2;
+		if (!IsSet(X-1, Y)) OutDir[(Y+1)*Stride + X]     = 3;
+	}
+
+	for (int32 Start = 0; Start < OutDir.Num(); ++Start)
+	{
+		if (OutDir[Start] == None) continue;
+
+		TArray<FVector2f> Loop;
+		const uint8 FirstDir = OutDir[Start];
+		uint8 PrevDir = None;
+		int32 X = Start % Stride, Y = Start / Stride, Cur = Start;
+
+		while (OutDir[Cur] != None)
+		{
+			const uint8 Dir = OutDir[Cur];
+			OutDir[Cur] = None;
+			if (Dir != PrevDir)
+				Loop.Add(FVector2f(X, Y));
+			PrevDir = Dir;
+			X += Dirs[Dir].X;
+			Y += Dirs[Dir].Y;
+			Cur = Y * Stride + X;
+		}
+		// старт посреди прямого участка — не угол
+		if (PrevDir == FirstDir && Loop.Num() > 0)
+			Loop.RemoveAt(0);
+
+		if (Loop.Num() >= 3)
+			OutLoops.Add(MoveTemp(Loop));
+	}
+}
+
+/** Douglas-Peucker для замкнутого контура: якоря — точка 0 и самая удалённая от неё */
+static void SimplifyClosed(TArray<FVector2f>& Loop, float Tolerance)
+{
+	const int32 N = Loop.Num();
+	if (Tolerance <= 0.f || N <= 4)
+		return;
+
+	int32 Far = 0;
+	for (int32 i = 1; i < N; ++i)
+		if (FVector2f::DistSquared(Loop[0], Loop[i]) > FVector2f::DistSquared(Loop[0], Loop[Far]))
+			Far = i;
+
+	TBitArray<> Keep(false, N);
+	Keep[0]   = true;
+	Keep[Far] = true;
+
+	const float Tol2 = Tolerance * Tolerance;
+	TArray<TPair<int32,int32>, TInlineAllocator<64>> Stack;
+	Stack.Emplace(0, Far);
+	Stack.Emplace(Far, N);          // N ≡ 0
+
+	while (Stack.Num() > 0)
+	{
+		const TPair<int32,int32> Span = Stack.Pop(EAllowShrinking::No);
+		const FVector2f& A = Loop[Span.Key];
+		const FVector2f& B = Loop[Span.Value % N];
+
+		int32 Split = INDEX_NONE;
+		float MaxD  = Tol2;
+		for (int32 i = Span.Key + 1; i < Span.Value; ++i)
+		{
+			const float D = PointSegmentDistSquared(Loop[i], A, B);
+			if (D > MaxD) { MaxD = D; Split = i; }
+		}
+		if (Split != INDEX_NONE)
+		{
+			Keep[Split] = true;
+			Stack.Emplace(Span.Key, Split);
+			Stack.Emplace(Split, Span.Value);
+		}
+	}
+
+	TArray<FVector2f> Out;
+	for (TConstSetBitIterator<> It(Keep); It; ++It)
+		Out.Add(Loop[It.GetIndex()]);
+	Loop = MoveTemp(Out);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// дыры + ear clipping  (полигоны — индексы в общий массив точек, CCW)
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** M лежит внутри угла полигона при вершине Poly[i] */
+static bool IsLocallyInside(const TArray<FVector2f>& Pts, const TArray<int32>& Poly, int32 i, const FVector2f& M)
+{
+	const int32 N = Poly.Num();
+	const FVector2f& V  = Pts[Poly[i]];
+	const FVector2f& Pv = Pts[Poly[(i + N - 1) % N]];
+	const FVector2f& Nx = Pts[Poly[(i + 1) % N]];
+
+	if (Cross2D(Pv, V, Nx) >= 0.0)
+		return Cross2D(V, Nx, M) >= 0.0 && Cross2D(V, M, Pv) >= 0.0;
+	return !(Cross2D(V, Pv, M) > 0.0 && Cross2D(V, M, Nx) > 0.0);
+}
+
+/** Мост от самой правой вершины дыры к видимой вершине внешнего контура (Eberly) */
+static void MergeHole(const TArray<FVector2f>& Pts, TArray<int32>& Outer, const TArray<int32>& Hole)
+{
+	int32 HM = 0;
+	for (int32 i = 1; i < Hole.Num(); ++i)
+		if (Pts[Hole[i]].X > Pts[Hole[HM]].X)
+			HM = i;
+	const FVector2f M = Pts[Hole[HM]];
+	const int32     N = Outer.Num();
+
+	// ближайшее пересечение луча +X с рёбрами контура
+	int32 Bridge = INDEX_NONE;
+	float BestX  = MAX_flt;
+	for (int32 i = 0; i < N; ++i)
+	{
+		const FVector2f& A = Pts[Outer[i]];
+		const FVector2f& B = Pts[Outer[(i + 1) % N]];
+		if (A.Y == B.Y || M.Y < FMath::Min(A.Y, B.Y) || M.Y > FMath::Max(A.Y, B.Y))
+			continue;
+
+		const float X = A.X + (M.Y - A.Y) * (B.X - A.X) / (B.Y - A.Y);
+		if (X >= M.X && X < BestX)
+		{
+			BestX  = X;
+			// луч попал в вершину — она и есть мост, иначе конец ребра с большим X
+			Bridge = (A.Y == M.Y) ? i : (B.Y == M.Y) ? (i + 1) % N : (A.X > B.X ? i : (i + 1) % N);
+		}
+	}
+	if (Bridge == INDEX_NONE)
+		return;   // после упрощения дыра вышла за контур — пропускаем
+
+	// вершины внутри треугольника (M, I, P) загораживают P — берём ближайшую к лучу по углу
+	const FVector2f I(BestX, M.Y);
+	const FVector2f P = Pts[Outer[Bridge]];
+	if (P != I)
+	{
+		const bool bCCW = Cross2D(M, I, P) > 0.0;
+		float BestTan = MAX_flt;
+		for (int32 i = 0; i < N; ++i)
+		{
+			const FVector2f& V = Pts[Outer[i]];
+			if (V == P || V.X < M.X) continue;
+
+			const bool bInside = bCCW ? PointInTriangle(V, M, I, P) : PointInTriangle(V, M, P, I);
+			if (!bInside) continue;
+
+			const float Tan = FMath::Abs(V.Y - M.Y) / FMath::Max(V.X - M.X, KINDA_SMALL_NUMBER);
+			if (Tan < BestTan && IsLocallyInside(Pts, Outer, i, M))
+			{
+				BestTan = Tan;
+				Bridge  = i;
+			}
+		}
+	}
+
+	// вершина могла уже стать мостом для другой дыры — берём копию, в угол которой смотрит M
+	if (!IsLocallyInside(Pts, Outer, Bridge, M))
+	{
+		for (int32 i = 0; i < N; ++i)
+		{
+			if (i != Bridge && Outer[i] == Outer[Bridge] && IsLocallyInside(Pts, Outer, i, M))
+			{
+				Bridge = i;
+				break;
+			}
+		}
+	}
+
+	// ..., P, M, <дыра>, M, P, ...
+	TArray<int32> Merged;
+	Merged.Reserve(N + Hole.Num() + 2);
+	Merged.Append(Outer.GetData(), Bridge + 1);
+	for (int32 k = 0; k < Hole.Num(); ++k)
+		Merged.Add(Hole[(HM + k) % Hole.Num()]);
+	Merged.Add(Hole[HM]);
+	Merged.Add(Outer[Bridge]);
+	Merged.Append(Outer.GetData() + Bridge + 1, N - Bridge - 1);
+	Outer = MoveTemp(Merged);
+}
+
+/**
+ * Ear clipping CCW-полигона; треугольники пишутся в OutTris по три индекса, CCW.
+ * false — остаток без ушей (самопересечение после упрощения), покрытие неполное.
+ */
+static bool EarClip(const TArray<FVector2f>& Pts, const TArray<int32>& Poly, TArray<int32>& OutTris)
+{
+	const int32 N = Poly.Num();
+	if (N < 3) return true;
+
+	TArray<int32> Prev, Next;
+	Prev.SetNumUninitialized(N);
+	Next.SetNumUninitialized(N);
+	for (int32 i = 0; i < N; ++i)
+	{
+		Prev[i] = (i + N - 1) % N;
+		Next[i] = (i + 1) % N;
+	}
+
+	auto IsEar = [&](int32 i)
+	{
+		const FVector2f& A = Pts[Poly[Prev[i]]];
+		const FVector2f& B = Pts[Poly[i]];
+		const FVector2f& C = Pts[Poly[Next[i]]];
+		if (Cross2D(A, B, C) <= 0.0)
+			return false;
+
+		// копии вершин моста совпадают с углами уха — их не считаем
+		for (int32 j = Next[Next[i]]; j != Prev[i]; j = Next[j])
+		{
+			const FVector2f& V = Pts[Poly[j]];
+			if (V != A && V != B && V != C && PointInTriangle(V, A, B, C))
+				return false;
+		}
+		return true;
+	};
+
+	int32 Cur = 0, Remaining = N, Stall = 0;
+	while (Remaining > 3)
+	{
+		if (IsEar(Cur))
+		{
+			OutTris.Append({ Poly[Prev[Cur]], Poly[Cur], Poly[Next[Cur]] });
+			Next[Prev[Cur]] = Next[Cur];
+			Prev[Next[Cur]] = Prev[Cur];
+			Cur = Next[Cur];
+			--Remaining;
+			Stall = 0;
+			continue;
+		}
+
+		Cur = Next[Cur];
+		if (++Stall < Remaining)
+			continue;
+
+		// ни одного уха: выбрасываем вырожденную (коллинеарную) вершину, иначе остаток
+		// самопересекается после упрощения — триангулировать его честно нельзя
+		int32 Degenerate = INDEX_NONE;
+		for (int32 k = 0, j = Cur; k < Remaining; ++k, j = Next[j])
+		{
+			if (FMath::IsNearlyZero(Cross2D(Pts[Poly[Prev[j]]], Pts[Poly[j]], Pts[Poly[Next[j]]])))
+			{
+				Degenerate = j;
+				break;
+			}
+		}
+		if (Degenerate == INDEX_NONE)
+			return false;
+
+		Next[Prev[Degenerate]] = Next[Degenerate];
+		Prev[Next[Degenerate]] = Prev[Degenerate];
+		Cur = Next[Degenerate];
+		--Remaining;
+		Stall = 0;
+	}
+
+	if (Cross2D(Pts[Poly[Prev[Cur]]], Pts[Poly[Cur]], Pts[Poly[Next[Cur]]]) > 0.0)
+		OutTris.Append({ Poly[Prev[Cur]], Poly[Cur], Poly[Next[Cur]] });
+	return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Контурный меш из спрайта
+// ─────────────────────────────────────────────────────────────────────────────
+bool Character2DMeshGenerator::GenerateContourMeshFromSprite(
+	const FCharacter2DAlphaMask& Mask,
+	const FVector2D&             SourceUV,
+	const FVector2D&             SourceDim,
+	const FVector&               Offset,
+	uint8                        AlphaThreshold,
+	float                        Tolerance,
+	float                        MeshScale,
+	FCharacter2DSpriteGeometry&  Out)
+{
+	if (Mask.Alpha.Num() != Mask.Width * Mask.Height || SourceDim.X <= 0.0 || SourceDim.Y <= 0.0)
+		return false;
+
+	// область спрайта в текстуре
+	const int32 X0 = FMath::Clamp(FMath::FloorToInt32(SourceUV.X), 0, Mask.Width);
+	const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(SourceUV.Y), 0, Mask.Height);
+	const int32 X1 = FMath::Clamp(FMath::CeilToInt32(SourceUV.X + SourceDim.X), X0, Mask.Width);
+	const int32 Y1 = FMath::Clamp(FMath::CeilToInt32(SourceUV.Y + SourceDim.Y), Y0, Mask.Height);
+	const int32 W  = X1 - X0;
+	const int32 H  = Y1 - Y0;
+	if (W <= 0 || H <= 0)
+		return false;
+
+	TArray<uint8> Bits;
+	BuildContourMask(Mask, X0, Y0, W, H, AlphaThreshold, Bits);
+
+	TArray<TArray<FVector2f>> Loops;
+	TraceContours(Bits, W, H, Loops);
+
+	// упрощение; контуры площадью меньше Tolerance² (пылинки, микродырки) отбрасываем
+	const float MinArea = FMath::Max(Tolerance * Tolerance, 0.5f);
+	TArray<FVector2f>     Pts;
+	TArray<TArray<int32>> Outers, Holes;
+	TArray<int32>         OuterLoop;        // индекс в Loops для point-in-polygon
+	for (int32 L = 0; L < Loops.Num(); ++L)
+	{
+		TArray<FVector2f>& Loop = Loops[L];
+		const float AreaBefore = SignedArea(Loop);
+		SimplifyClosed(Loop, Tolerance);
+		const float Area = SignedArea(Loop);
+		if (Loop.Num() < 3 || FMath::Abs(Area) < MinArea || (Area > 0.f) != (AreaBefore > 0.f))
+		{
+			Loop.Reset();
+			continue;
+		}
+
+		TArray<int32> Indices;
+		for (const FVector2f& P : Loop)
+			Indices.Add(Pts.Add(P));
+
+		if (Area > 0.f)
+		{
+			Outers.Add(MoveTemp(Indices));
+			OuterLoop.Add(L);
+		}
+		else
+		{
+			Holes.Add(MoveTemp(Indices));
+		}
+	}
+	if (Outers.IsEmpty())
+		return false;
+
+	// дыра → наименьший внешний контур, который её содержит; склейка в порядке убывания X (Eberly)
+	TArray<TArray<int32>> HolesByOuter;
+	HolesByOuter.SetNum(Outers.Num());
+	for (int32 h = 0; h < Holes.Num(); ++h)
+	{
+		const FVector2f Probe = Pts[Holes[h][0]];
+		int32 Best = INDEX_NONE;
+		float BestArea = MAX_flt;
+		for (int32 o = 0; o < Outers.Num(); ++o)
+		{
+			const TArray<FVector2f>& OuterPts = Loops[OuterLoop[o]];
+			const float Area = SignedArea(OuterPts);
+			if (Area < BestArea && PointInPolygon(OuterPts, Probe))
+			{
+				BestArea = Area;
+				Best = o;
+			}
+		}
+		if (Best != INDEX_NONE)
+			HolesByOuter[Best].Add(h);
+	}
+
+	TArray<int32> Tris;
+	for (int32 o = 0; o < Outers.Num(); ++o)
+	{
+		auto MaxX = [&](int32 h)
+		{
+			float X = -MAX_flt;
+			for (int32 Idx : Holes[h]) X = FMath::Max(X, Pts[Idx].X);
+			return X;
+		};
+		HolesByOuter[o].Sort([&](int32 A, int32 B) { return MaxX(A) > MaxX(B); });
+
+		for (int32 h : HolesByOuter[o])
+			MergeHole(Pts, Outers[o], Holes[h]);
+
+		// частичный меш теряет непрозрачные пиксели — пусть вызывающий возьмёт сетку
+		if (!EarClip(Pts, Outers[o], Tris))
+			return false;
+	}
+	if (Tris.IsEmpty())
+		return false;
+
+	// в буфер: одна вершина и один instance на точку, те же формулы, что в grid-режиме
+	const float CenterX = SourceDim.X * .5f;
+	const float BottomZ = SourceDim.Y * .5f;
+
+	TArray<int32> Remap;
+	Remap.Init(INDEX_NONE, Pts.Num());
+	for (int32 t = 0; t < Tris.Num(); t += 3)
+	{
+		// CCW в координатах текстуры (Y вниз) → тот же порядок обхода, что у ячеек сетки
+		const int32 Corners[3] = { Tris[t], Tris[t + 2], Tris[t + 1] };
+		for (int32 PtIdx : Corners)
+		{
+			if (Remap[PtIdx] == INDEX_NONE)
+			{
+				const FVector2D P(Pts[PtIdx].X + X0, Pts[PtIdx].Y + Y0);
+				const float FlippedY = SourceDim.Y - (P.Y - SourceUV.Y);
+
+				const int32 Vertex = Out.Positions.Add(FVector3f(
+					(P.X - CenterX) * MeshScale + Offset.X,
+					 Offset.Z,
+					(FlippedY - BottomZ) * MeshScale + Offset.Y));
+
+				Remap[PtIdx] = Out.InstanceVertices.Add(Vertex);
+				Out.InstanceUVs.Add(FVector2f( ((P - SourceUV) / SourceDim).ClampAxes(0.f,1.f) ));
+			}
+			Out.Triangles.Add(Remap[PtIdx]);
+		}
+	}
+	return true;
+}
@@ -25,6 +25,13 @@
 #include "Engine/Texture2D.h"
 
 #include "Logging/LogMacros.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Async/ParallelFor.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+
+#define LOCTEXT_NAMESPACE "Character2DMeshGenerator"
 
 // ─────────────────────────────────────────────────────────────────────────────
 // helper-структура
@@ -36,6 +43,16 @@ struct FSpriteEntry
 	bool           bUseGridMesh   = true;
 	int32          GridCellSize   = 32;
 	uint8          AlphaThreshold = 64;
+	bool           bExactCoverage = false;
+	bool           bMergeCells    = false;
+	bool           bUseContour    = false;
+	float          ContourTolerance = 1.5f;
+
+	// снимок для worker-потоков (заполняется на game thread)
+	int32          MaskIndex      = INDEX_NONE;
+	int32          CoverageIndex  = INDEX_NONE;
+	FVector2D      SourceUV       = FVector2D::ZeroVector;
+	FVector2D      SourceSize     = FVector2D::ZeroVector;
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -48,103 +65,324 @@ bool Character2DMeshGenerator::IsTextureFormatSupported(UTexture2D* Texture)
 	       Texture->GetPlatformData()->PixelFormat == PF_B8G8R8A8;
 }
 
+/** Копия альфы mip 0. BulkData нельзя лочить из нескольких потоков — читаем один раз на game thread */
+static bool ReadAlphaMask(UTexture2D* Texture, FCharacter2DAlphaMask& OutMask)
+{
+	check(IsInGameThread());
+
+	const FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	const void* Data = Mip.BulkData.LockReadOnly();
+	if (!Data) return false;
+	ON_SCOPE_EXIT { Mip.BulkData.Unlock(); };
+
+	OutMask.Width  = Mip.SizeX;
+	OutMask.Height = Mip.SizeY;
+	OutMask.Alpha.SetNumUninitialized(OutMask.Width * OutMask.Height);
+
+	const FColor* Colors = static_cast<const FColor*>(Data);
+	uint8*        Alpha  = OutMask.Alpha.GetData();
+	const int32   Width  = OutMask.Width;
+
+	ParallelFor(OutMask.Height, [Colors, Alpha, Width](int32 Y)
+	{
+		const FColor* Src = Colors + Y * Width;
+		uint8*        Dst = Alpha  + Y * Width;
+		for (int32 X = 0; X < Width; ++X)
+			Dst[X] = Src[X].A;
+	});
+	return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Summed-area table покрытия
+// ─────────────────────────────────────────────────────────────────────────────
+void FCharacter2DCoverageTable::Build(const FCharacter2DAlphaMask& Mask, uint8 AlphaThreshold)
+{
+	Width  = Mask.Width;
+	Height = Mask.Height;
+
+	const int32 Stride = Width + 1;
+	Sum.SetNumUninitialized(Stride * (Height + 1));
+	FMemory::Memzero(Sum.GetData(), Stride * sizeof(uint32));
+
+	const uint8* Alpha = Mask.Alpha.GetData();
+	uint32*      Table = Sum.GetData();
+	const int32  W     = Width;
+	const int32  H     = Height;
+
+	// 1) префиксные суммы по строкам — строки независимы
+	ParallelFor(H, [Alpha, Table, W, Stride, AlphaThreshold](int32 Y)
+	{
+		const uint8* Src = Alpha + Y * W;
+		uint32*      Dst = Table + (Y + 1) * Stride;
+
+		uint32 Run = 0;
+		Dst[0] = 0;
+		for (int32 X = 0; X < W; ++X)
+		{
+			Run += Src[X] > AlphaThreshold ? 1u : 0u;
+			Dst[X + 1] = Run;
+		}
+	});
+
+	// 2) накопление сверху вниз полосами столбцов: Row[x] += Prev[x] — непрерывный цикл, векторизуется
+	constexpr int32 StripWidth = 512;
+	ParallelFor(FMath::DivideAndRoundUp(Stride, StripWidth), [Table, H, Stride](int32 Strip)
+	{
+		const int32 X0 = Strip * StripWidth;
+		const int32 X1 = FMath::Min(X0 + StripWidth, Stride);
+		for (int32 Y = 2; Y <= H; ++Y)
+		{
+			uint32*       Row  = Table + Y * Stride;
+			const uint32* Prev = Row - Stride;
+			for (int32 X = X0; X < X1; ++X)
+				Row[X] += Prev[X];
+		}
+	});
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Grid-меш из спрайта
 // ─────────────────────────────────────────────────────────────────────────────
 bool Character2DMeshGenerator::GenerateGridMeshFromSprite(
-	UPaperSprite*            Sprite,
-	const FVector&           Offset,
-	const FPolygonGroupID&   Group,
-	FMeshDescriptionBuilder& Builder,
-	TArray<FVector2D>&       /*OutUVs*/,
-	int32                    CellSize,
-	uint8                    AlphaThreshold,
-	float                    MeshScale)
+	const FCharacter2DAlphaMask& Mask,
+	const FVector2D&             SourceUV,
+	const FVector2D&             SourceDim,
+	const FVector&               Offset,
+	int32                        CellSize,
+	uint8                        AlphaThreshold,
+	float                        MeshScale,
+	const FCharacter2DCoverageTable* Coverage,
+	bool                         bExactCoverage,
+	bool                         bMergeOpaqueCells,
+	FCharacter2DSpriteGeometry&  Out)
 {
-	if (!IsValid(Sprite) || !IsValid(Sprite->GetSourceTexture()))
+	const int32 Width  = Mask.Width;
+	const int32 Height = Mask.Height;
+	if (CellSize <= 0 || Mask.Alpha.Num() != Width * Height)
 		return false;
 
-	UTexture2D* Texture = Sprite->GetSourceTexture();
-	if (!IsTextureFormatSupported(Texture))
-		return false;
+	const uint8* Alpha = Mask.Alpha.GetData();
 
-	const FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
-	const int32 Width  = Mip.SizeX;
-	const int32 Height = Mip.SizeY;
+	const bool bTable = Coverage && Coverage->Width == Width && Coverage->Height == Height;
+	const bool bExact = bTable && bExactCoverage;
+	const bool bMerge = bTable && bMergeOpaqueCells;
 
-	const void* Data = Mip.BulkData.LockReadOnly();
-	if (!Data) return false;
-	ON_SCOPE_EXIT { Mip.BulkData.Unlock(); };
+	// сетка ячеек; точный режим проходит и неполные ячейки у правого/нижнего края
+	const int32 NumX = bExact ? FMath::DivideAndRoundUp(Width,  CellSize) : (Width  >= CellSize ? (Width  - CellSize) / CellSize + 1 : 0);
+	const int32 NumY = bExact ? FMath::DivideAndRoundUp(Height, CellSize) : (Height >= CellSize ? (Height - CellSize) / CellSize + 1 : 0);
+	auto LineX = [Width,  CellSize](int32 I) { return FMath::Min(I * CellSize, Width);  };
+	auto LineY = [Height, CellSize](int32 I) { return FMath::Min(I * CellSize, Height); };
 
-	const FColor* Colors = static_cast<const FColor*>(Data);
+	// 1) занятость: 0 — пусто, 1 — есть непрозрачное, 2 — целиком непрозрачна (кандидат на слияние)
+	TArray<uint8> Cells;
+	Cells.SetNumZeroed(NumX * NumY);
+	for (int32 CY = 0; CY < NumY; ++CY)
+	for (int32 CX = 0; CX < NumX; ++CX)
+	{
+		const int32 X  = CX * CellSize,  Y  = CY * CellSize;
+		const int32 X1 = LineX(CX + 1),  Y1 = LineY(CY + 1);
+
+		if (bExact)
+		{
+			if (!Coverage->IsAnyOpaque(X, Y, X1, Y1))
+				continue;
+		}
+		else
+		{
+			// дальние углы последней ячейки лежат за краем текстуры
+			const int32 SX = FMath::Min(X + CellSize, Width  - 1);
+			const int32 SY = FMath::Min(Y + CellSize, Height - 1);
+
+			const uint8 A0 = Alpha[Y*Width + X];
+			const uint8 A1 = Alpha[Y*Width + SX];
+			const uint8 A2 = Alpha[SY*Width + X];
+			const uint8 A3 = Alpha[SY*Width + SX];
+			const uint8 A4 = Alpha[(Y+CellSize/2)*Width + (X+CellSize/2)];
+
+			const uint8 AlphaMax = FMath::Max( FMath::Max(A0,A1),
+			                                   FMath::Max(FMath::Max(A2,A3),A4) );
+			if (AlphaMax <= AlphaThreshold)
+				continue;
+		}
+		Cells[CY*NumX + CX] = (bMerge && Coverage->IsFullyOpaque(X, Y, X1, Y1)) ? 2 : 1;
+	}
 
-	const FVector2D SourceUV  = Sprite->GetSourceUV();
-	const FVector2D SourceDim = Sprite->GetSourceSize();
 	const float CenterX = SourceDim.X * .5f;
 	const float BottomZ = SourceDim.Y * .5f;
 
-	TMap<FIntPoint,FVertexID> Vertices;
+	TMap<FIntPoint,int32> Vertices;
 
-	for (int32 Y = 0; Y <= Height - CellSize; Y += CellSize)
-	for (int32 X = 0; X <= Width  - CellSize; X += CellSize)
+	// instance в точке текстуры; вершины на линиях сетки общие для соседних ячеек
+	auto AddCorner = [&](const FVector2D& P, bool bShared) -> int32
 	{
-		const uint8 A0 = Colors[Y*Width + X].A;
-		const uint8 A1 = Colors[Y*Width + (X+CellSize)].A;
-		const uint8 A2 = Colors[(Y+CellSize)*Width + X].A;
-		const uint8 A3 = Colors[(Y+CellSize)*Width + (X+CellSize)].A;
-		const uint8 A4 = Colors[(Y+CellSize/2)*Width + (X+CellSize/2)].A;
-
-		const uint8 AlphaMax = FMath::Max( FMath::Max(A0,A1),
-		                                   FMath::Max(FMath::Max(A2,A3),A4) );
-		if (AlphaMax <= AlphaThreshold)
-			continue;
+		const FIntPoint Key{ (int32)P.X,(int32)P.Y };
+		int32 Vertex = INDEX_NONE;
+		if (const int32* Found = bShared ? Vertices.Find(Key) : nullptr)
+		{
+			Vertex = *Found;
+		}
+		else
+		{
+			const float LocalY   = P.Y - SourceUV.Y;
+			const float FlippedY = SourceDim.Y - LocalY;
 
+			const FVector3f Pos(
+				(P.X - CenterX) * MeshScale + Offset.X,
+				 Offset.Z,
+				(FlippedY - BottomZ) * MeshScale + Offset.Y);
+
+			Vertex = Out.Positions.Add(Pos);
+			if (bShared)
+				Vertices.Add(Key, Vertex);
+		}
+		Out.InstanceUVs.Add(FVector2f( ((P-SourceUV) / SourceDim).ClampAxes(0.f,1.f) ));
+		return Out.InstanceVertices.Add(Vertex);
+	};
+
+	// прямоугольник ячеек [CX0,CX1) x [CY0,CY1) двумя треугольниками
+	auto EmitQuad = [&](int32 CX0, int32 CY0, int32 CX1, int32 CY1)
+	{
 		const FVector2D P[4] =
 		{
-			{ (float)X,           (float)Y },
-			{ (float)(X+CellSize), (float)Y },
-			{ (float)X,           (float)(Y+CellSize) },
-			{ (float)(X+CellSize), (float)(Y+CellSize) }
+			{ (float)LineX(CX0), (float)LineY(CY0) },
+			{ (float)LineX(CX1), (float)LineY(CY0) },
+			{ (float)LineX(CX0), (float)LineY(CY1) },
+			{ (float)LineX(CX1), (float)LineY(CY1) }
 		};
 
-		FVertexInstanceID Inst[4];
+		int32 Inst[4];
 		for (int32 i=0;i<4;++i)
+			Inst[i] = AddCorner(P[i], true);
+
+		Out.Triangles.Append({ Inst[0],Inst[2],Inst[1] });
+		Out.Triangles.Append({ Inst[1],Inst[2],Inst[3] });
+	};
+
+	if (!bMerge)
+	{
+		for (int32 CY = 0; CY < NumY; ++CY)
+		for (int32 CX = 0; CX < NumX; ++CX)
+			if (Cells[CY*NumX + CX])
+				EmitQuad(CX, CY, CX + 1, CY + 1);
+		return Vertices.Num() > 0;
+	}
+
+	// 2) greedy: непрозрачные ячейки — в максимальные прямоугольники (сначала по X, потом вниз),
+	//    ячейки на границе альфы остаются одиночными
+	TArray<FIntRect> Rects;
+	for (int32 CY = 0; CY < NumY; ++CY)
+	for (int32 CX = 0; CX < NumX; ++CX)
+	{
+		uint8& Cell = Cells[CY*NumX + CX];
+		if (Cell == 0)
+			continue;
+		if (Cell == 1)
 		{
-			const FIntPoint Key{ (int32)P[i].X,(int32)P[i].Y };
-			if (!Vertices.Contains(Key))
-			{
-				const float LocalY   = P[i].Y - SourceUV.Y;
-				const float FlippedY = SourceDim.Y - LocalY;
+			Rects.Add(FIntRect(CX, CY, CX + 1, CY + 1));
+			Cell = 0;
+			continue;
+		}
 
-				const FVector Pos(
-					(P[i].X - CenterX) * MeshScale + Offset.X,
-					 Offset.Z,
-					(FlippedY - BottomZ) * MeshScale + Offset.Y);
+		int32 EndX = CX + 1;
+		while (EndX < NumX && Cells[CY*NumX + EndX] == 2)
+			++EndX;
 
-				Vertices.Add(Key, Builder.AppendVertex(Pos));
-			}
-			Inst[i] = Builder.AppendInstance(Vertices[Key]);
+		int32 EndY = CY + 1;
+		for (; EndY < NumY; ++EndY)
+		{
+			bool bRowFull = true;
+			for (int32 X = CX; X < EndX && bRowFull; ++X)
+				bRowFull = Cells[EndY*NumX + X] == 2;
+			if (!bRowFull)
+				break;
+		}
+
+		for (int32 Y = CY; Y < EndY; ++Y)
+			FMemory::Memzero(&Cells[Y*NumX + CX], EndX - CX);
+		Rects.Add(FIntRect(CX, CY, EndX, EndY));
+	}
 
-			Builder.SetInstanceNormal (Inst[i], FVector(0,1,0));
-			Builder.SetInstanceColor  (Inst[i], FVector4f(1.f));
-			Builder.SetInstanceUV     (Inst[i],
-				( (P[i]-SourceUV) / SourceDim ).ClampAxes(0.f,1.f) );
+	// 3) углы мелких соседей на сторонах большого прямоугольника — T-стыки.
+	//    Такой прямоугольник режем веером из центра, чтобы стороны совпали и не было щелей
+	const int32 LineStride = NumX + 1;
+	TBitArray<> IsCorner(false, LineStride * (NumY + 1));
+	for (const FIntRect& R : Rects)
+	{
+		IsCorner[R.Min.Y*LineStride + R.Min.X] = true;
+		IsCorner[R.Min.Y*LineStride + R.Max.X] = true;
+		IsCorner[R.Max.Y*LineStride + R.Min.X] = true;
+		IsCorner[R.Max.Y*LineStride + R.Max.X] = true;
+	}
+
+	TArray<FIntPoint, TInlineAllocator<64>> Border;
+	for (const FIntRect& R : Rects)
+	{
+		if (R.Width() == 1 && R.Height() == 1)
+		{
+			EmitQuad(R.Min.X, R.Min.Y, R.Max.X, R.Max.Y);
+			continue;
 		}
-		Builder.AppendTriangle(Inst[0],Inst[2],Inst[1],Group);
-		Builder.AppendTriangle(Inst[1],Inst[2],Inst[3],Group);
+
+		// обход по часовой на экране: верх →, право ↓, низ ←, лево ↑
+		Border.Reset();
+		auto AddIfCorner = [&](int32 X, int32 Y) { if (IsCorner[Y*LineStride + X]) Border.Add(FIntPoint(X, Y)); };
+		for (int32 X = R.Min.X; X <  R.Max.X; ++X) AddIfCorner(X, R.Min.Y);
+		for (int32 Y = R.Min.Y; Y <  R.Max.Y; ++Y) AddIfCorner(R.Max.X, Y);
+		for (int32 X = R.Max.X; X >  R.Min.X; --X) AddIfCorner(X, R.Max.Y);
+		for (int32 Y = R.Max.Y; Y >  R.Min.Y; --Y) AddIfCorner(R.Min.X, Y);
+
+		if (Border.Num() == 4)
+		{
+			EmitQuad(R.Min.X, R.Min.Y, R.Max.X, R.Max.Y);
+			continue;
+		}
+
+		const FVector2D Mid(
+			0.5 * (LineX(R.Min.X) + LineX(R.Max.X)),
+			0.5 * (LineY(R.Min.Y) + LineY(R.Max.Y)));
+		const int32 MidInst = AddCorner(Mid, false);
+
+		const int32 First = Out.InstanceVertices.Num();
+		for (const FIntPoint& B : Border)
+			AddCorner(FVector2D(LineX(B.X), LineY(B.Y)), true);
+
+		// тот же обход, что у ячеек сетки
+		for (int32 i = 0; i < Border.Num(); ++i)
+			Out.Triangles.Append({ MidInst, First + (i + 1) % Border.Num(), First + i });
 	}
 	return Vertices.Num() > 0;
 }
 
+/** Треугольники BakedRenderData: по отдельной вершине на угол, как раньше */
+static void BuildBakedGeometry(const TArray<FVector4>& V, const FVector& Offset, float MeshScale,
+                               FCharacter2DSpriteGeometry& Out)
+{
+	Out.bTangentSpace = true;
+	for (int32 i=0;i+2<V.Num();i+=3)
+	for (int32 k=0;k<3;++k)
+	{
+		const FVector4& XYUV = V[i+k];
+		const int32 Vertex = Out.Positions.Add(FVector3f(
+			XYUV.X*MeshScale + Offset.X,
+			 Offset.Z,
+			XYUV.Y*MeshScale + Offset.Y));
+
+		Out.Triangles.Add(Out.InstanceVertices.Add(Vertex));
+		Out.InstanceUVs.Add(FVector2f(XYUV.Z,XYUV.W));
+	}
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // BuildMeshDescriptionAndTextures
 // ─────────────────────────────────────────────────────────────────────────────
-void Character2DMeshGenerator::BuildMeshDescriptionAndTextures(
+bool Character2DMeshGenerator::BuildMeshDescriptionAndTextures(
 	const TArray<TSharedPtr<FCharacter2DLayerCategory>>& Categories,
 	FMeshDescription&            OutDesc,
 	TArray<UTexture*>&           OutTextures,
 	TArray<UPaperSprite*>&       OutUniqueSprites,
-	const FCharacter2DMeshGenerationOptions& Options)
+	const FCharacter2DMeshGenerationOptions& Options,
+	bool                         bShowProgress)
 {
 	OutDesc = FMeshDescription();
 	OutTextures.Reset();
@@ -159,7 +397,7 @@ void Character2DMeshGenerator::BuildMeshDescriptionAndTextures(
 			continue;
 
 		UTexture2D* Tex = Slot->Sprite->GetSourceTexture();
-		if (Cat->bUseGridMesh && !IsTextureFormatSupported(Tex))
+		if ((Cat->bUseGridMesh || Cat->bUseContourMesh) && !IsTextureFormatSupported(Tex))
 			continue;
 
 		Entries.Emplace(FSpriteEntry{
@@ -167,15 +405,152 @@ void Character2DMeshGenerator::BuildMeshDescriptionAndTextures(
 			Slot->Location,
 			Cat->bUseGridMesh,
 			Cat->GridCellSize,
-			Cat->AlphaThreshold});
+			Cat->AlphaThreshold,
+			Cat->bExactAlphaCoverage,
+			Cat->bMergeOpaqueCells,
+			Cat->bUseContourMesh,
+			Cat->ContourTolerance});
+	}
+	if (Entries.IsEmpty()) return true;
+
+	// чтение текстур + геометрия (по спрайту) + слияние
+	FScopedSlowTask SlowTask(Entries.Num() + 2.f, LOCTEXT("BuildingMesh", "Building character mesh..."), bShowProgress);
+
+	// --- альфа-маски grid-текстур (game thread, по одной на текстуру)
+	SlowTask.EnterProgressFrame(1.f, LOCTEXT("ReadingTextures", "Reading sprite textures..."));
+
+	TArray<FCharacter2DAlphaMask> Masks;
+	TMap<UTexture2D*,int32>       MaskByTexture;
+	for (FSpriteEntry& E : Entries)
+	{
+		E.SourceUV   = E.Sprite->GetSourceUV();
+		E.SourceSize = E.Sprite->GetSourceSize();
+		if (!E.bUseGridMesh && !E.bUseContour)
+			continue;
+
+		UTexture2D* Tex = E.Sprite->GetSourceTexture();
+		if (const int32* Found = MaskByTexture.Find(Tex))
+		{
+			E.MaskIndex = *Found;
+			continue;
+		}
+		FCharacter2DAlphaMask Mask;
+		E.MaskIndex = ReadAlphaMask(Tex, Mask) ? Masks.Add(MoveTemp(Mask)) : INDEX_NONE;
+		MaskByTexture.Add(Tex, E.MaskIndex);
+	}
+
+	// --- SAT для точного покрытия и слияния ячеек: одна на пару (маска, порог)
+	TArray<FCharacter2DCoverageTable> Coverage;
+	TMap<TPair<int32,uint8>,int32>    CoverageByKey;
+	for (FSpriteEntry& E : Entries)
+	{
+		if (!E.bUseGridMesh || E.bUseContour || !(E.bExactCoverage || E.bMergeCells) || !Masks.IsValidIndex(E.MaskIndex))
+			continue;
+
+		const TPair<int32,uint8> Key(E.MaskIndex, E.AlphaThreshold);
+		if (const int32* Found = CoverageByKey.Find(Key))
+		{
+			E.CoverageIndex = *Found;
+			continue;
+		}
+		E.CoverageIndex = Coverage.AddDefaulted();
+		Coverage[E.CoverageIndex].Build(Masks[E.MaskIndex], E.AlphaThreshold);
+		CoverageByKey.Add(Key, E.CoverageIndex);
+	}
+
+	// --- геометрия: каждый спрайт в свой буфер, без UObject
+	TArray<FCharacter2DSpriteGeometry> Geometry;
+	Geometry.SetNum(Entries.Num());
+
+	std::atomic<bool>  bCancelled{false};
+	std::atomic<int32> NumBuilt{0};
+	const float MeshScale = Options.MeshScale;
+
+	auto BuildEntry = [&](int32 Index)
+	{
+		if (bCancelled.load(std::memory_order_relaxed))
+			return;
+
+		const FSpriteEntry& E = Entries[Index];
+		if (E.bUseContour)
+		{
+			if (Masks.IsValidIndex(E.MaskIndex)
+				&& !GenerateContourMeshFromSprite(Masks[E.MaskIndex], E.SourceUV, E.SourceSize, E.Offset,
+					E.AlphaThreshold, E.ContourTolerance, MeshScale, Geometry[Index]))
+			{
+				// контур не триангулировался — точная сетка покрывает все непрозрачные пиксели;
+				// SAT строим здесь же: общая таблица для contour-категорий не заводится
+				UE_LOG(LogTemp, Warning, TEXT("Character2D: contour mesh for sprite '%s' could not be triangulated, falling back to grid mesh"),
+					*E.Sprite->GetName());
+
+				FCharacter2DCoverageTable Table;
+				Table.Build(Masks[E.MaskIndex], E.AlphaThreshold);
+				Geometry[Index] = FCharacter2DSpriteGeometry();
+				GenerateGridMeshFromSprite(Masks[E.MaskIndex], E.SourceUV, E.SourceSize, E.Offset,
+					E.GridCellSize, E.AlphaThreshold, MeshScale, &Table,
+					true, E.bMergeCells,
+					Geometry[Index]);
+			}
+		}
+		else if (!E.bUseGridMesh)
+			BuildBakedGeometry(E.Sprite->BakedRenderData, E.Offset, MeshScale, Geometry[Index]);
+		else if (Masks.IsValidIndex(E.MaskIndex))
+			GenerateGridMeshFromSprite(Masks[E.MaskIndex], E.SourceUV, E.SourceSize, E.Offset,
+				E.GridCellSize, E.AlphaThreshold, MeshScale,
+				Coverage.IsValidIndex(E.CoverageIndex) ? &Coverage[E.CoverageIndex] : nullptr,
+				E.bExactCoverage, E.bMergeCells,
+				Geometry[Index]);
+
+		NumBuilt.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	if (!bShowProgress)
+	{
+		// превью: без диалога, game thread участвует в ParallelFor
+		ParallelFor(Entries.Num(), BuildEntry);
 	}
-	if (Entries.IsEmpty()) return;
+	else
+	{
+		// game thread крутит прогресс и кнопку отмены, пока worker'ы строят геометрию
+		UE::Tasks::FTask Task = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+			[&]() { ParallelFor(Entries.Num(), BuildEntry); });
+
+		int32 Reported = 0;
+		for (;;)
+		{
+			const bool bDone = Task.Wait(FTimespan::FromMilliseconds(30));
+			const int32 Built = NumBuilt.load(std::memory_order_relaxed);
+			SlowTask.EnterProgressFrame(float(Built - Reported));
+			Reported = Built;
+
+			if (bDone) break;
+			if (SlowTask.ShouldCancel())
+				bCancelled = true;
+		}
+		SlowTask.EnterProgressFrame(float(Entries.Num() - Reported));
+	}
+	if (bCancelled)
+		return false;
+
+	// --- переносим в MeshDescription (порядок слотов сохранён)
+	SlowTask.EnterProgressFrame(1.f, LOCTEXT("MergingGeometry", "Merging geometry..."));
 
-	// --- готовим MeshDescription
 	FStaticMeshAttributes Attr(OutDesc); Attr.Register();
 	FMeshDescriptionBuilder Bld; Bld.SetMeshDescription(&OutDesc);
 	Bld.EnablePolyGroups(); Bld.SetNumUVLayers(1);
 
+	int32 NumVertices = 0, NumInstances = 0, NumTriangles = 0;
+	for (const FCharacter2DSpriteGeometry& G : Geometry)
+	{
+		NumVertices  += G.Positions.Num();
+		NumInstances += G.InstanceVertices.Num();
+		NumTriangles += G.Triangles.Num() / 3;
+	}
+	OutDesc.ReserveNewVertices(NumVertices);
+	OutDesc.ReserveNewVertexInstances(NumInstances);
+	OutDesc.ReserveNewTriangles(NumTriangles);
+	OutDesc.ReserveNewPolygons(NumTriangles);
+
 	TMap<UPaperSprite*,FPolygonGroupID> GroupBySprite;
 
 	// группы + сбор текстур
@@ -197,41 +572,34 @@ void Character2DMeshGenerator::BuildMeshDescriptionAndTextures(
 			OutTextures.AddUnique(T);
 	}
 
-
-	// генерация треугольников
-	for (const FSpriteEntry& E : Entries)
+	// треугольники
+	TArray<FVertexID>         VertexIDs;
+	TArray<FVertexInstanceID> InstanceIDs;
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
 	{
-		const FPolygonGroupID Group = GroupBySprite[E.Sprite];
+		const FCharacter2DSpriteGeometry& G = Geometry[Index];
+		const FPolygonGroupID Group = GroupBySprite[Entries[Index].Sprite];
 
-		if (E.bUseGridMesh)
-		{
-			TArray<FVector2D> DummyUV;
-			GenerateGridMeshFromSprite(E.Sprite,E.Offset,Group,Bld,
-				DummyUV,E.GridCellSize,E.AlphaThreshold,Options.MeshScale);
-			continue;
-		}
+		VertexIDs.Reset(G.Positions.Num());
+		for (const FVector3f& Pos : G.Positions)
+			VertexIDs.Add(Bld.AppendVertex(FVector(Pos)));
 
-		const TArray<FVector4>& V = E.Sprite->BakedRenderData;
-		for (int32 i=0;i<V.Num();i+=3)
+		InstanceIDs.Reset(G.InstanceVertices.Num());
+		for (int32 i=0;i<G.InstanceVertices.Num();++i)
 		{
-			FVertexInstanceID I[3];
-			for (int32 k=0;k<3;++k)
-			{
-				const FVector4& XYUV = V[i+k];
-				const FVector Pos(
-					XYUV.X*Options.MeshScale + E.Offset.X,
-					 E.Offset.Z,
-					XYUV.Y*Options.MeshScale + E.Offset.Y);
-
-				I[k] = Bld.AppendInstance(Bld.AppendVertex(Pos));
-				Bld.SetInstanceNormal(I[k],FVector(0,1,0));
-				Bld.SetInstanceTangentSpace(I[k],FVector(1,0,0),FVector(0,0,1),1.f);
-				Bld.SetInstanceUV(I[k], FVector2D(XYUV.Z,XYUV.W));
-				Bld.SetInstanceColor(I[k],FVector4f(1.f));
-			}
-			Bld.AppendTriangle(I[0],I[1],I[2],Group);
+			const FVertexInstanceID Inst = Bld.AppendInstance(VertexIDs[G.InstanceVertices[i]]);
+			Bld.SetInstanceNormal(Inst,FVector(0,1,0));
+			if (G.bTangentSpace)
+				Bld.SetInstanceTangentSpace(Inst,FVector(1,0,0),FVector(0,0,1),1.f);
+			Bld.SetInstanceUV(Inst,FVector2D(G.InstanceUVs[i]));
+			Bld.SetInstanceColor(Inst,FVector4f(1.f));
+			InstanceIDs.Add(Inst);
 		}
+
+		for (int32 i=0;i+2<G.Triangles.Num();i+=3)
+			Bld.AppendTriangle(InstanceIDs[G.Triangles[i]],InstanceIDs[G.Triangles[i+1]],InstanceIDs[G.Triangles[i+2]],Group);
 	}
+	return true;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -273,14 +641,25 @@ void Character2DMeshGenerator::GenerateMeshFromOptions(
 
 	IAssetTools& AssetTools = FAssetToolsModule::GetModule().Get();
 
+	// геометрия (4) + сборка меша (1) + материалы (1)
+	FScopedSlowTask SlowTask(6.f, LOCTEXT("GeneratingMesh", "Generating character mesh..."));
+	SlowTask.MakeDialog(/*bShowCancelButton*/ true);
+
 	// 1) MeshDescription
 	FMeshDescription   MeshDesc;
 	TArray<UTexture*>  Textures;
 	TArray<UPaperSprite*> UniqueSprites; 
-	TArray<UPaperSprite*> Dummy;
-	BuildMeshDescriptionAndTextures(Categories,MeshDesc, Textures, UniqueSprites, Options);
+	SlowTask.EnterProgressFrame(4.f);
+	if (!BuildMeshDescriptionAndTextures(Categories,MeshDesc, Textures, UniqueSprites, Options, /*bShowProgress*/ true))
+	{
+		UE_LOG(LogTemp,Log,TEXT("Character2D: mesh generation cancelled"));
+		return;
+	}
 	if (MeshDesc.Polygons().Num() == 0) return;
 
+	// последняя точка отмены: дальше создаются ассеты, прерывать их на полпути нельзя
+	if (SlowTask.ShouldCancel()) return;
+
 	// 2) смещение по Pivot
 	{
 		FStaticMeshAttributes A(MeshDesc);
@@ -326,6 +705,7 @@ void Character2DMeshGenerator::GenerateMeshFromOptions(
 		Mesh->CommitMeshDescription(0,P);
 		Mesh->ImportVersion = EImportStaticMeshVersion::LastVersion;
 
+		SlowTask.EnterProgressFrame(1.f, LOCTEXT("CreatingMaterials", "Creating materials..."));
 		TArray<FStaticMaterial> StaticMats;
 		const int32 NumPG = MeshDesc.PolygonGroups().Num();
 
@@ -344,6 +724,7 @@ void Character2DMeshGenerator::GenerateMeshFromOptions(
 
 		Mesh->SetStaticMaterials(StaticMats);
 
+		SlowTask.EnterProgressFrame(1.f, LOCTEXT("BuildingStaticMesh", "Building static mesh..."));
 		Mesh->Build(); Mesh->PostEditChange(); (void)Mesh->MarkPackageDirty();
 		FAssetRegistryModule::AssetCreated(Mesh);
 
@@ -355,6 +736,7 @@ void Character2DMeshGenerator::GenerateMeshFromOptions(
 	// ----------------------  SKELETAL  MESH ----------------------------
 	// ===================================================================
 	// 3.1 temp StaticMesh
+	SlowTask.EnterProgressFrame(1.f, LOCTEXT("BuildingSkeletalMesh", "Building skeletal mesh..."));
 	UStaticMesh* Temp = NewObject<UStaticMesh>(GetTransientPackage(),NAME_None,RF_Transient);
 	if (!Temp->IsSourceModelValid(0)) Temp->AddSourceModel();
 
@@ -420,6 +802,7 @@ void Character2DMeshGenerator::GenerateMeshFromOptions(
 	SkelMesh->Build();
 
 	// 3.5 материалы
+	SlowTask.EnterProgressFrame(1.f, LOCTEXT("CreatingMaterials", "Creating materials..."));
 	TArray<FSkeletalMaterial> SMat;
 
 	for (int32 i = 0; i < Textures.Num(); ++i)
@@ -466,4 +849,6 @@ void Character2DMeshGenerator::ShowMeshGenerationDialog(
 		Opt.SavePath       = Cfg->SavePath.Path;
 		GenerateMeshFromOptions(Categories,Opt);
 	}
-}
\ No newline at end of file
+}
+
+#undef LOCTEXT_NAMESPACE
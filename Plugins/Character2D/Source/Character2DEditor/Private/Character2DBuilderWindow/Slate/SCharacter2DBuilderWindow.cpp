@@ -326,6 +326,7 @@ TSharedRef<SWidget> SCharacter2DBuilderWindow::BuildCategoryWidget(TSharedPtr<FC
     Box->AddSlot().AutoHeight().Padding(2)
     [
         SNew(SHorizontalBox)
+        .IsEnabled_Lambda([Category]() { return !Category->bUseContourMesh; })
 
         + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
         [
@@ -345,6 +346,48 @@ TSharedRef<SWidget> SCharacter2DBuilderWindow::BuildCategoryWidget(TSharedPtr<FC
         ]
     ];
 
+    // Use Contour Mesh
+    Box->AddSlot().AutoHeight().Padding(2)
+    [
+        SNew(SHorizontalBox)
+
+        + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
+        [
+            SNew(SCheckBox)
+            .IsChecked_Lambda([Category]() {
+                return Category->bUseContourMesh ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+            })
+            .OnCheckStateChanged_Lambda([this, Category](ECheckBoxState State) {
+                Category->bUseContourMesh = (State == ECheckBoxState::Checked);
+                RefreshPreview();
+            })
+        ]
+
+        + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
+        [
+            SNew(STextBlock).Text(LOCTEXT("UseContourMesh", "Use Contour Mesh"))
+            .ToolTipText(LOCTEXT("UseContourMeshTip", "Trace the alpha outline and triangulate it instead of using grid cells"))
+        ]
+    ];
+
+    // Contour Tolerance
+    Box->AddSlot().AutoHeight().Padding(2)
+    [
+        SNew(SNumericEntryBox<float>)
+        .Value_Lambda([Category]() -> TOptional<float> { return Category->ContourTolerance; })
+        .OnValueCommitted_Lambda([this, Category](float NewVal, ETextCommit::Type) {
+            Category->ContourTolerance = FMath::Max(0.f, NewVal);
+            RefreshPreview();
+        })
+        .MinValue(0.f)
+        .AllowSpin(true)
+        .Label()
+        [
+            SNew(STextBlock).Text(LOCTEXT("ContourTolerance", "Contour Tolerance (px)"))
+        ]
+        .IsEnabled_Lambda([Category]() { return Category->bUseContourMesh; })
+    ];
+
     // Grid Cell Size
     Box->AddSlot().AutoHeight().Padding(2)
     [
@@ -360,7 +403,7 @@ TSharedRef<SWidget> SCharacter2DBuilderWindow::BuildCategoryWidget(TSharedPtr<FC
         [
             SNew(STextBlock).Text(LOCTEXT("CellSize", "Cell Size"))
         ]
-        .IsEnabled_Lambda([Category]() { return Category->bUseGridMesh; })
+        .IsEnabled_Lambda([Category]() { return Category->bUseGridMesh && !Category->bUseContourMesh; })
     ];
 
 
@@ -379,7 +422,57 @@ TSharedRef<SWidget> SCharacter2DBuilderWindow::BuildCategoryWidget(TSharedPtr<FC
         [
             SNew(STextBlock).Text(LOCTEXT("AlphaThreshold", "Alpha Threshold"))
         ]
-        .IsEnabled_Lambda([Category]() { return Category->bUseGridMesh; })
+        .IsEnabled_Lambda([Category]() { return Category->bUseGridMesh || Category->bUseContourMesh; })
+    ];
+
+    // Exact Alpha Coverage
+    Box->AddSlot().AutoHeight().Padding(2)
+    [
+        SNew(SHorizontalBox)
+        .IsEnabled_Lambda([Category]() { return Category->bUseGridMesh && !Category->bUseContourMesh; })
+
+        + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
+        [
+            SNew(SCheckBox)
+            .IsChecked_Lambda([Category]() {
+                return Category->bExactAlphaCoverage ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+            })
+            .OnCheckStateChanged_Lambda([this, Category](ECheckBoxState State) {
+                Category->bExactAlphaCoverage = (State == ECheckBoxState::Checked);
+                RefreshPreview();
+            })
+        ]
+
+        + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
+        [
+            SNew(STextBlock).Text(LOCTEXT("ExactAlphaCoverage", "Exact Alpha Coverage"))
+            .ToolTipText(LOCTEXT("ExactAlphaCoverageTip", "Test every pixel of a cell instead of 5 samples, so thin details are kept at large cell sizes"))
+        ]
+    ];
+
+    // Merge Opaque Cells
+    Box->AddSlot().AutoHeight().Padding(2)
+    [
+        SNew(SHorizontalBox)
+        .IsEnabled_Lambda([Category]() { return Category->bUseGridMesh && !Category->bUseContourMesh; })
+
+        + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
+        [
+            SNew(SCheckBox)
+            .IsChecked_Lambda([Category]() {
+                return Category->bMergeOpaqueCells ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+            })
+            .OnCheckStateChanged_Lambda([this, Category](ECheckBoxState State) {
+                Category->bMergeOpaqueCells = (State == ECheckBoxState::Checked);
+                RefreshPreview();
+            })
+        ]
+
+        + SHorizontalBox::Slot().AutoWidth().Padding(4).VAlign(VAlign_Center)
+        [
+            SNew(STextBlock).Text(LOCTEXT("MergeOpaqueCells", "Merge Opaque Cells"))
+            .ToolTipText(LOCTEXT("MergeOpaqueCellsTip", "Merge fully opaque cells into larger quads; cells along the alpha border stay fine"))
+        ]
     ];
 
 
@@ -595,6 +688,10 @@ FReply SCharacter2DBuilderWindow::HandleSaveAsAsset()
         CatData.bUseGridMesh  = Category->bUseGridMesh;
         CatData.GridCellSize  = Category->GridCellSize;
         CatData.AlphaThreshold= Category->AlphaThreshold;
+        CatData.bExactAlphaCoverage = Category->bExactAlphaCoverage;
+        CatData.bMergeOpaqueCells   = Category->bMergeOpaqueCells;
+        CatData.bUseContourMesh     = Category->bUseContourMesh;
+        CatData.ContourTolerance    = Category->ContourTolerance;
 
         for (const auto& Slot : Category->Slots)
         {
@@ -778,6 +875,10 @@ void SCharacter2DBuilderWindow::OnSpritesLoaded(FAssetData LoadedAssetData)
         NewCat->bUseGridMesh   = CatData.bUseGridMesh;
         NewCat->GridCellSize   = CatData.GridCellSize;
         NewCat->AlphaThreshold = CatData.AlphaThreshold;
+        NewCat->bExactAlphaCoverage = CatData.bExactAlphaCoverage;
+        NewCat->bMergeOpaqueCells   = CatData.bMergeOpaqueCells;
+        NewCat->bUseContourMesh     = CatData.bUseContourMesh;
+        NewCat->ContourTolerance    = CatData.ContourTolerance;
 
         for (const auto& SlotData : CatData.Slots)
         {
@@ -9,6 +9,8 @@
 #include "ToolMenuEntry.h"
 #include "IAssetTypeActions.h"
 #include "Character2DAssetEditorToolkit/FAssetTypeActions_Character2DAsset.h"
+#include "Character2DAtlas/Character2DAtlasBuilder.h"
+#include "UObject/ObjectSaveContext.h"
 
 static const FName Character2DTabName("Character2DBuilder");
 
@@ -29,11 +31,15 @@ void FCharacter2DEditorModule::StartupModule()
 	AssetTools.RegisterAssetTypeActions(
 		StaticCastSharedRef<IAssetTypeActions>(Character2DAssetActions.ToSharedRef())
 	);
+
+	// Атлас спрайтов пересобирается перед сохранением/cook ассета
+	PreSavePackageHandle = UPackage::PreSavePackageWithContextEvent.AddStatic(&Character2DAtlasBuilder::HandlePreSavePackage);
 }
 
 void FCharacter2DEditorModule::ShutdownModule()
 {
 	UToolMenus::UnregisterOwner(this);
+	UPackage::PreSavePackageWithContextEvent.Remove(PreSavePackageHandle);
 
 	if (FModuleManager::Get().IsModuleLoaded("AssetTools"))
 	{
@@ -0,0 +1,115 @@
+#include "Character2DResave/Character2DResaveCommandlet.h"
+#include "Character2DAsset.h"
+#include "Character2DCustomVersion.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+UCharacter2DResaveCommandlet::UCharacter2DResaveCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Main
+// ─────────────────────────────────────────────────────────────
+int32 UCharacter2DResaveCommandlet::Main(const FString& Params)
+{
+	FString SearchPath = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Path="), SearchPath);
+	const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+	int32 GCInterval = 50;
+	FParse::Value(*Params, TEXT("GCInterval="), GCInterval);
+	GCInterval = FMath::Max(GCInterval, 1);
+
+	IAssetRegistry& AssetRegistry = FAssetRegistryModule::GetRegistry();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UCharacter2DAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(FName(*SearchPath));
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	UE_LOG(LogTemp, Display, TEXT("Character2DResave: %d assets under %s, target version %d%s"),
+		Assets.Num(), *SearchPath, (int32)FCharacter2DCustomVersion::LatestVersion, bDryRun ? TEXT(" (dry run)") : TEXT(""));
+
+	int32 NumUpToDate = 0;
+	int32 NumResaved = 0;
+	int32 NumFailed = 0;
+
+	for (int32 AssetIndex = 0; AssetIndex < Assets.Num(); ++AssetIndex)
+	{
+		// Предыдущие пакеты уже сохранены: ассеты, их спрайты и текстуры можно выгрузить
+		if (AssetIndex > 0 && AssetIndex % GCInterval == 0)
+			CollectGarbage(RF_NoFlags);
+
+		const FAssetData& AssetData = Assets[AssetIndex];
+		UCharacter2DAsset* Asset = Cast<UCharacter2DAsset>(AssetData.GetAsset());
+		if (!Asset)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Character2DResave: failed to load %s"), *AssetData.GetObjectPathString());
+			++NumFailed;
+			continue;
+		}
+
+		// Версия файла на диске; PostLoad уже перенёс Legacy*-поля
+		const int32 Version = Asset->GetLinkerCustomVersion(FCharacter2DCustomVersion::GUID);
+		if (Version >= FCharacter2DCustomVersion::LatestVersion)
+		{
+			++NumUpToDate;
+			continue;
+		}
+
+		UPackage* Package = Asset->GetPackage();
+		FString Filename;
+		if (!FPackageName::TryConvertLongPackageNameToFilename(Package->GetName(), Filename, FPackageName::GetAssetPackageExtension()))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Character2DResave: no filename for %s"), *Package->GetName());
+			++NumFailed;
+			continue;
+		}
+
+		if (bDryRun)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Character2DResave: would resave %s (version %d)"), *Package->GetName(), Version);
+			++NumResaved;
+			continue;
+		}
+
+		if (IFileManager::Get().IsReadOnly(*Filename))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Character2DResave: %s is read-only, check it out first"), *Filename);
+			++NumFailed;
+			continue;
+		}
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.Error = GWarn;
+		if (UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs))
+		{
+			UE_LOG(LogTemp, Display, TEXT("Character2DResave: %s %d -> %d"), *Package->GetName(), Version, (int32)FCharacter2DCustomVersion::LatestVersion);
+			++NumResaved;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Character2DResave: failed to save %s"), *Filename);
+			++NumFailed;
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Character2DResave: %d resaved, %d up to date, %d failed"), NumResaved, NumUpToDate, NumFailed);
+	return NumFailed > 0 ? 1 : 0;
+}
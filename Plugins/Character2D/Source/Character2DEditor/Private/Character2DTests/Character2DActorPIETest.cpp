@@ -0,0 +1,149 @@
+#include "Character2DActor.h"
+#include "Character2DAsset.h"
+#include "Components/Character2DLayeredSpriteComponent.h"
+
+#include "Engine/Engine.h"
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/PackageName.h"
+#include "PaperSprite.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// ─────────────────────────────────────────────────────────────
+// helper-ы
+// ─────────────────────────────────────────────────────────────
+namespace
+{
+	constexpr int32 NumTestLayers = 3;
+
+	/** Спрайт с настоящей геометрией: у пустого UPaperSprite нет треугольников, и proxy не создаётся */
+	UPaperSprite* CreateOpaqueSprite(UObject* Outer)
+	{
+		constexpr int32 Size = 16;
+		TArray<FColor> Pixels;
+		Pixels.Init(FColor::White, Size * Size);
+
+		UTexture2D* Texture = NewObject<UTexture2D>(Outer, TEXT("Character2DTestTexture"), RF_Transient);
+		Texture->Source.Init(Size, Size, 1, 1, TSF_BGRA8, reinterpret_cast<const uint8*>(Pixels.GetData()));
+		Texture->UpdateResource();
+
+		UPaperSprite* Sprite = NewObject<UPaperSprite>(Outer, TEXT("Character2DTestSprite"), RF_Transient);
+		FSpriteAssetInitParameters InitParams;
+		InitParams.SetTextureAndFill(Texture);
+		Sprite->InitializeSprite(InitParams);
+		return Sprite;
+	}
+
+	UCharacter2DAsset* CreateTestAsset()
+	{
+		UCharacter2DAsset* Asset = NewObject<UCharacter2DAsset>(GetTransientPackage(), NAME_None, RF_Transient);
+		UPaperSprite* Sprite = CreateOpaqueSprite(Asset);
+
+		const int32 BodyId = Asset->AddSpriteLayer(TEXT("Body"), Sprite);
+		const int32 HeadId = Asset->AddSpriteLayer(TEXT("Head"), Sprite, BodyId);
+		Asset->AddSpriteLayer(TEXT("Eyes"), Sprite, HeadId);
+		Asset->bAutoBlink = false;
+		Asset->bAutoTalk = false;
+		return Asset;
+	}
+
+	/** Актёр, расставленный в уровне редактора: OnConstruction отрабатывает, как при размещении */
+	ACharacter2DActor* PlaceActor(UWorld* World, UCharacter2DAsset* Asset, bool bLayered)
+	{
+		ACharacter2DActor* Actor = World->SpawnActorDeferred<ACharacter2DActor>(ACharacter2DActor::StaticClass(), FTransform::Identity,
+			nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		Actor->CharacterAsset = Asset;
+		Actor->bUseLayeredSprites = bLayered;
+		Actor->FinishSpawning(FTransform::Identity);
+		return Actor;
+	}
+
+	/** Копия уровня для PIE тем же путём, что у редактора: дублирование с PPF_DuplicateForPIE, без OnConstruction */
+	UWorld* DuplicateWorldForPlay(UWorld* EditorWorld)
+	{
+		UPackage* PlayPackage = CreatePackage(*FString::Printf(TEXT("/Temp/UEDPIE_0_%s"), *FPackageName::GetShortName(EditorWorld->GetOutermost())));
+		PlayPackage->SetPackageFlags(PKG_PlayInEditor);
+
+		FObjectDuplicationParameters Parameters(EditorWorld, PlayPackage);
+		Parameters.DestName = EditorWorld->GetFName();
+		Parameters.DestClass = EditorWorld->GetClass();
+		Parameters.DuplicateMode = EDuplicateMode::PIE;
+		Parameters.PortFlags = PPF_DuplicateForPIE;
+
+		UWorld* PlayWorld = CastChecked<UWorld>(StaticDuplicateObjectEx(Parameters));
+		PlayWorld->WorldType = EWorldType::PIE;
+		PlayWorld->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.RequiresHitProxies(false));
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::PIE);
+		WorldContext.SetCurrentWorld(PlayWorld);
+		PlayWorld->InitializeActorsForPlay(FURL());
+		PlayWorld->BeginPlay();
+		return PlayWorld;
+	}
+
+	ACharacter2DActor* FindCharacter(UWorld* World)
+	{
+		for (AActor* Actor : World->PersistentLevel->Actors)
+		{
+			if (ACharacter2DActor* Character = Cast<ACharacter2DActor>(Actor))
+				return Character;
+		}
+		return nullptr;
+	}
+}
+
+// ─────────────────────────────────────────────────────────────
+// Актёр уровня после дублирования для PIE
+// ─────────────────────────────────────────────────────────────
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCharacter2DActorPIEDuplicateTest, "Character2D.Actor.PIEDuplicateRebuildsSprites",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCharacter2DActorPIEDuplicateTest::RunTest(const FString& Parameters)
+{
+	UCharacter2DAsset* Asset = CreateTestAsset();
+	Asset->AddToRoot();
+
+	for (const bool bLayered : {true, false})
+	{
+		UWorld* EditorWorld = UWorld::CreateWorld(EWorldType::Editor, false, TEXT("Character2DPIETest"));
+		PlaceActor(EditorWorld, Asset, bLayered);
+
+		UWorld* PlayWorld = DuplicateWorldForPlay(EditorWorld);
+		ACharacter2DActor* Actor = FindCharacter(PlayWorld);
+		if (TestNotNull(TEXT("PIE copy of the placed character"), Actor))
+		{
+			if (bLayered)
+			{
+				TestEqual(TEXT("LayeredSprite layers"), Actor->LayeredSprite->GetNumLayers(), NumTestLayers);
+				TestNotNull(TEXT("LayeredSprite scene proxy"), Actor->LayeredSprite->SceneProxy);
+			}
+			else
+			{
+				TestEqual(TEXT("Sprite layer components"), Actor->SpriteLayerComponents.Num(), NumTestLayers);
+				for (const UPaperSpriteComponent* Component : Actor->SpriteLayerComponents)
+				{
+					TestTrue(TEXT("Sprite layer component registered with a sprite"),
+						Component && Component->IsRegistered() && Component->GetSprite() != nullptr);
+				}
+			}
+		}
+
+		GEngine->DestroyWorldContext(PlayWorld);
+		PlayWorld->DestroyWorld(false);
+		EditorWorld->DestroyWorld(false);
+	}
+
+	Asset->RemoveFromRoot();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCharacter2DAsset;
+class UPackage;
+class FObjectPreSaveContext;
+
+/**
+ * Сборка атласа спрайтов UCharacter2DAsset:
+ * каждый слой и кадр Flipbook обрезается по альфе, упаковывается полками
+ * в одну текстуру (вложенный объект ассета), а в ассет пишутся
+ * прямоугольники кадров в пространстве спрайта и UV атласа.
+ */
+namespace Character2DAtlasBuilder
+{
+    /** Отступ между кадрами в атласе (px) */
+    constexpr int32 FramePadding = 2;
+
+    /** Собирает атлас заново; false, если ни один спрайт не удалось прочитать */
+    bool BuildSpriteAtlas(UCharacter2DAsset* Asset);
+
+    /** Удаляет атлас и его текстуру из ассета */
+    void ClearSpriteAtlas(UCharacter2DAsset* Asset);
+
+    /** Пересобирает атлас, если он включён и устарел; снимает его, если выключен */
+    void UpdateSpriteAtlas(UCharacter2DAsset* Asset);
+
+    /** Обработчик UPackage::PreSavePackageWithContextEvent: атлас актуален при каждом сохранении и cook (устаревший пересобирается при куке) */
+    void HandlePreSavePackage(UPackage* Package, FObjectPreSaveContext SaveContext);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Character2DBenchmarkCommandlet.generated.h"
+
+class UCharacter2DAsset;
+class ACharacter2DActor;
+
+/**
+ * Нагрузочный прогон ACharacter2DActor без рендера:
+ *
+ *   UnrealEditor-Cmd <Project> -run=Character2DBenchmark -nullrhi -unattended
+ *       [-Counts=1,10,100,1000] [-Frames=300] [-Warmup=30]
+ *       [-Workloads=Idle,Blink,Talk,Emotion,Fade,Move,Mixed] [-Output=<dir>]
+ *
+ * Для каждой пары (сценарий, число персонажей) спавнит актёров из синтетического
+ * ассета в отдельном игровом мире, гоняет сценарий фиксированное число кадров
+ * с шагом 1/60 и пишет время кадра game thread, число и объём выделений памяти
+ * за измеряемые кадры (все потоки, через обёртку GMalloc) и прирост UObject'ов
+ * в Summary.csv и Results.json (с покадровыми временами).
+ */
+UCLASS()
+class CHARACTER2DEDITOR_API UCharacter2DBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCharacter2DBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	enum class EWorkload : uint8
+	{
+		Idle,
+		Blink,
+		Talk,
+		Emotion,
+		Fade,
+		Move,
+		Mixed
+	};
+
+	struct FRunResult
+	{
+		EWorkload Workload = EWorkload::Idle;
+		int32 NumCharacters = 0;
+		double SpawnMs = 0.0;
+		TArray<double> FrameMs;
+		/** Выделения за измеряемые кадры (без прогрева); Realloc считается новым выделением */
+		uint64 NumAllocations = 0;
+		uint64 AllocatedBytes = 0;
+		int32 ObjectDelta = 0;
+	};
+
+	static const TCHAR* GetWorkloadName(EWorkload Workload);
+
+	/** Ассет со спрайтами-заглушками на всех слоях и flipbook'ами моргания/разговора */
+	UCharacter2DAsset* CreateSyntheticAsset() const;
+
+	FRunResult Run(UCharacter2DAsset* Asset, EWorkload Workload, int32 NumCharacters) const;
+
+	/** Команды сценария на кадре Frame для актёра Index */
+	void DriveWorkload(EWorkload Workload, ACharacter2DActor* Actor, int32 Index, int32 Frame) const;
+
+	bool WriteResults(const TArray<FRunResult>& Results, const FString& OutputDir) const;
+
+	int32 NumFrames = 300;
+	int32 NumWarmupFrames = 30;
+	float FrameDeltaTime = 1.0f / 60.0f;
+};
@@ -30,6 +30,10 @@ struct FCharacter2DLayerCategoryData
 	UPROPERTY(EditAnywhere) bool  bUseGridMesh   = true;
 	UPROPERTY(EditAnywhere) int32 GridCellSize   = 32;
 	UPROPERTY(EditAnywhere) uint8 AlphaThreshold = 64;
+	UPROPERTY(EditAnywhere) bool  bExactAlphaCoverage = false;
+	UPROPERTY(EditAnywhere) bool  bMergeOpaqueCells   = false;
+	UPROPERTY(EditAnywhere) bool  bUseContourMesh     = false;
+	UPROPERTY(EditAnywhere) float ContourTolerance    = 1.5f;
 
 	UPROPERTY(EditAnywhere) TArray<FCharacter2DLayerSlotData> Slots;
 };
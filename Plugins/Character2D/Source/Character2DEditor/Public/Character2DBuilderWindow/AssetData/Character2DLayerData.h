@@ -51,6 +51,13 @@ struct FCharacter2DLayerCategory
 	bool          bUseGridMesh   = true;
 	int32         GridCellSize   = 32;
 	uint8         AlphaThreshold = 64;
+	/** Grid: покрытие ячейки по всем пикселям (SAT), а не по 5 сэмплам */
+	bool          bExactAlphaCoverage = false;
+	/** Grid: непрозрачные ячейки сливаются в крупные прямоугольники */
+	bool          bMergeOpaqueCells   = false;
+	/** Контур по альфе вместо сетки/BakedRenderData; допуск упрощения в пикселях */
+	bool          bUseContourMesh     = false;
+	float         ContourTolerance    = 1.5f;
 
 	TArray<TSharedPtr<FCharacter2DLayerSlot>> Slots;
 
@@ -14,7 +14,8 @@ struct FPolygonGroupID;
 
 /**
  * Опции генерации меша:
- * - per-category (bUseGridMesh, GridCellSize, AlphaThreshold) задаются в SCharacter2DBuilderWindow
+ * - per-category (bUseGridMesh, GridCellSize, AlphaThreshold, bExactAlphaCoverage,
+ *   bMergeOpaqueCells, bUseContourMesh, ContourTolerance) задаются в SCharacter2DBuilderWindow
  * - глобальные (OutputType, PivotPlacement, AssetName, SavePath, MeshScale) — через UCharacter2DMeshGeneratorOptions
  */
 struct FCharacter2DMeshGenerationOptions
@@ -37,22 +38,107 @@ struct FCharacter2DMeshGenerationOptions
     float   MeshScale      = 1.0f;
 };
 
+/** Альфа-канал mip 0 текстуры, скопированный на game thread: дальше читается из worker-потоков */
+struct FCharacter2DAlphaMask
+{
+    int32         Width  = 0;
+    int32         Height = 0;
+    TArray<uint8> Alpha;
+};
+
+/**
+ * Summed-area table по маске "Alpha > Threshold": число непрозрачных пикселей
+ * в любом прямоугольнике за O(1). Строится один раз на пару (текстура, порог).
+ */
+struct FCharacter2DCoverageTable
+{
+    int32          Width  = 0;
+    int32          Height = 0;
+    /** (Width+1) x (Height+1), нулевые строка и столбец */
+    TArray<uint32> Sum;
+
+    void Build(const FCharacter2DAlphaMask& Mask, uint8 AlphaThreshold);
+
+    /** Непрозрачных пикселей в [X0,X1) x [Y0,Y1), прямоугольник обрезается по текстуре */
+    uint32 CountOpaque(int32 X0, int32 Y0, int32 X1, int32 Y1) const
+    {
+        X0 = FMath::Clamp(X0, 0, Width);  X1 = FMath::Clamp(X1, 0, Width);
+        Y0 = FMath::Clamp(Y0, 0, Height); Y1 = FMath::Clamp(Y1, 0, Height);
+        if (X1 <= X0 || Y1 <= Y0) return 0;
+
+        const int32 Stride = Width + 1;
+        return Sum[Y1*Stride + X1] - Sum[Y0*Stride + X1] - Sum[Y1*Stride + X0] + Sum[Y0*Stride + X0];
+    }
+
+    bool IsAnyOpaque(int32 X0, int32 Y0, int32 X1, int32 Y1) const
+    {
+        return CountOpaque(X0, Y0, X1, Y1) > 0;
+    }
+
+    /** Весь прямоугольник внутри текстуры и непрозрачен */
+    bool IsFullyOpaque(int32 X0, int32 Y0, int32 X1, int32 Y1) const
+    {
+        if (X0 < 0 || Y0 < 0 || X1 > Width || Y1 > Height || X1 <= X0 || Y1 <= Y0) return false;
+        return CountOpaque(X0, Y0, X1, Y1) == uint32(X1 - X0) * uint32(Y1 - Y0);
+    }
+};
+
+/**
+ * Геометрия одного спрайта. Строится в worker-потоке без обращения к UObject,
+ * в FMeshDescription переносится на game thread.
+ */
+struct FCharacter2DSpriteGeometry
+{
+    /** Позиции вершин (соседние ячейки делят вершины) */
+    TArray<FVector3f> Positions;
+    /** Углы треугольников (vertex instance): индекс в Positions и UV */
+    TArray<int32>     InstanceVertices;
+    TArray<FVector2f> InstanceUVs;
+    /** По три индекса в InstanceVertices на треугольник */
+    TArray<int32>     Triangles;
+    /** Задать касательные явно (BakedRenderData) */
+    bool              bTangentSpace = false;
+};
+
 namespace Character2DMeshGenerator
 {
     /**
      * Генерация "grid" меша для одного спрайта:
      * разбивает область на ячейки CellSize, отфильтровывает по AlphaThreshold,
-     * масштабирует вершины по MeshScale.
+     * масштабирует вершины по MeshScale. Потокобезопасна: читает только Mask/Coverage.
+     * bExactCoverage — покрытие по SAT (все пиксели ячейки, включая неполные ячейки у края),
+     * иначе ячейка оценивается по 5 сэмплам. bMergeOpaqueCells — целиком непрозрачные
+     * ячейки жадно сливаются в прямоугольники. Оба режима требуют Coverage.
      */
     static bool GenerateGridMeshFromSprite(
-        UPaperSprite* Sprite,
+        const FCharacter2DAlphaMask& Mask,
+        const FVector2D& SourceUV,
+        const FVector2D& SourceSize,
         const FVector& Offset,
-        const FPolygonGroupID& Group,
-        FMeshDescriptionBuilder& Builder,
-        TArray<FVector2D>& OutUVs,
         int32 CellSize,
         uint8 AlphaThreshold,
-        float MeshScale
+        float MeshScale,
+        const FCharacter2DCoverageTable* Coverage,
+        bool bExactCoverage,
+        bool bMergeOpaqueCells,
+        FCharacter2DSpriteGeometry& OutGeometry
+    );
+
+    /**
+     * Контурный меш спрайта: marching squares по маске Alpha > AlphaThreshold,
+     * упрощение контуров Douglas-Peucker (Tolerance, px), ear clipping с дырами.
+     * Потокобезопасна: читает только Mask. Реализация — Character2DContourMesh.cpp.
+     * false — пустой спрайт или контур не триангулировался; Out не тронут.
+     */
+    bool GenerateContourMeshFromSprite(
+        const FCharacter2DAlphaMask& Mask,
+        const FVector2D& SourceUV,
+        const FVector2D& SourceSize,
+        const FVector& Offset,
+        uint8 AlphaThreshold,
+        float Tolerance,
+        float MeshScale,
+        FCharacter2DSpriteGeometry& OutGeometry
     );
 
     /**
@@ -75,13 +161,17 @@ namespace Character2DMeshGenerator
     /**
      * Собирает MeshDescription и массив текстур из категорий,
      * используя переданные Options для контроля grid/переменных и масштаба.
+     * Геометрия спрайтов строится параллельно (ParallelFor), слияние — в порядке слотов.
+     * bShowProgress — шаг FScopedSlowTask (вложенный в диалог вызывающего) с отменой;
+     * false — отменено, OutDesc неполный.
      */
-    void BuildMeshDescriptionAndTextures(
+    bool BuildMeshDescriptionAndTextures(
         const TArray<TSharedPtr<FCharacter2DLayerCategory>>& Categories,
         FMeshDescription& OutDesc,
         TArray<UTexture*>& OutTextures,
         TArray<UPaperSprite*>& OutUniqueSprites,
-        const FCharacter2DMeshGenerationOptions& Options
+        const FCharacter2DMeshGenerationOptions& Options,
+        bool bShowProgress = false
     );
 
     /** Проверяет, поддерживает ли текстура формат PF_B8G8R8A8 */
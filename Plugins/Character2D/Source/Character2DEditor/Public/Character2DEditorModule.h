@@ -21,4 +21,5 @@ private:
 	void RegisterMenus_Internal();
 
 	TSharedPtr<class FUICommandList> PluginCommands;
+	FDelegateHandle PreSavePackageHandle;
 };
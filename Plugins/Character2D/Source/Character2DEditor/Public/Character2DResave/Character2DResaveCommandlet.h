@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Character2DResaveCommandlet.generated.h"
+
+/**
+ * Пересохраняет UCharacter2DAsset, записанные версией ниже FCharacter2DCustomVersion::LatestVersion:
+ * миграция выполняется при загрузке, после сохранения PostLoad её больше не делает.
+ *
+ *   UnrealEditor-Cmd <Project> -run=Character2DResave [-Path=/Game] [-DryRun] [-GCInterval=50]
+ *
+ * Read-only файлы (не взятые из системы контроля версий) пропускаются с предупреждением.
+ * Каждые GCInterval пакетов загруженное выгружается сборкой мусора, чтобы память
+ * не росла с размером проекта.
+ */
+UCLASS()
+class CHARACTER2DEDITOR_API UCharacter2DResaveCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCharacter2DResaveCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -11,7 +11,7 @@ public class Character2DRuntime : ModuleRules
                         new[] { "Core", "CoreUObject", "Engine", "Paper2D" });
 
                 PrivateDependencyModuleNames.AddRange(
-                        new[] { "SlateCore" });
+                        new[] { "SlateCore", "RenderCore", "RHI" });
 
                 if (Target.bBuildEditor)
                 {
@@ -0,0 +1,120 @@
+#include "Animation/Character2DCurveCache.h"
+#include "Character2DStats.h"
+#include "Curves/CurveFloat.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_STAT(STAT_Character2D_CurveLUTHits);
+DEFINE_STAT(STAT_Character2D_CurveLUTMisses);
+DEFINE_STAT(STAT_Character2D_CurveLUTsCached);
+
+FCharacter2DCurveCache& FCharacter2DCurveCache::Get()
+{
+    static FCharacter2DCurveCache Instance;
+    return Instance;
+}
+
+void FCharacter2DCurveCache::Initialize()
+{
+    PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FCharacter2DCurveCache::PurgeStaleEntries);
+#if WITH_EDITOR
+    PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FCharacter2DCurveCache::OnObjectPropertyChanged);
+#endif
+}
+
+void FCharacter2DCurveCache::Shutdown()
+{
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+#if WITH_EDITOR
+    FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+#endif
+    Entries.Reset();
+}
+
+const FCharacter2DCurveLUT* FCharacter2DCurveCache::FindOrBake(const UCurveFloat* Curve)
+{
+    check(IsInGameThread());
+
+    if (!Curve)
+    {
+        return nullptr;
+    }
+
+    FEntry& Entry = Entries.FindOrAdd(FObjectKey(Curve));
+    bool bNeedsBake = !Entry.Table.IsValid();
+
+#if WITH_EDITOR
+    const uint32 KeysHash = HashCurveKeys(Curve);
+    bNeedsBake |= Entry.KeysHash != KeysHash;
+    Entry.KeysHash = KeysHash;
+#endif
+
+    if (bNeedsBake)
+    {
+        if (!Entry.Table.IsValid())
+        {
+            Entry.Table = MakeUnique<FCharacter2DCurveLUT>();
+            SET_DWORD_STAT(STAT_Character2D_CurveLUTsCached, Entries.Num());
+        }
+        Entry.Table->Bake(Curve);
+
+        ++NumMisses;
+        INC_DWORD_STAT(STAT_Character2D_CurveLUTMisses);
+    }
+    else
+    {
+        ++NumHits;
+        INC_DWORD_STAT(STAT_Character2D_CurveLUTHits);
+    }
+
+    return Entry.Table.Get();
+}
+
+void FCharacter2DCurveCache::PurgeStaleEntries()
+{
+    const int32 NumBefore = Entries.Num();
+    for (auto It = Entries.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().ResolveObjectPtr())
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    if (Entries.Num() != NumBefore)
+    {
+        SET_DWORD_STAT(STAT_Character2D_CurveLUTsCached, Entries.Num());
+    }
+}
+
+void FCharacter2DCurveCache::Invalidate(const UCurveFloat* Curve)
+{
+    check(IsInGameThread());
+
+    // Перезапекание на месте: указатели в запущенных твинах остаются валидны
+    if (FEntry* Entry = Entries.Find(FObjectKey(Curve)))
+    {
+        if (Entry->Table.IsValid())
+        {
+            Entry->Table->Bake(Curve);
+        }
+#if WITH_EDITOR
+        Entry->KeysHash = HashCurveKeys(Curve);
+#endif
+    }
+}
+
+#if WITH_EDITOR
+uint32 FCharacter2DCurveCache::HashCurveKeys(const UCurveFloat* Curve)
+{
+    const TArray<FRichCurveKey>& Keys = Curve->FloatCurve.GetConstRefOfKeys();
+    return FCrc::MemCrc32(Keys.GetData(), Keys.Num() * sizeof(FRichCurveKey));
+}
+
+void FCharacter2DCurveCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event)
+{
+    if (const UCurveFloat* Curve = Cast<UCurveFloat>(Object))
+    {
+        Invalidate(Curve);
+    }
+}
+#endif
@@ -0,0 +1,383 @@
+#include "Animation/Character2DRuntimeSnapshot.h"
+#include "Subsystems/Character2DAnimationSubsystem.h"
+#include "Rendering/Character2DPrimitiveData.h"
+#include "Character2DActor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+/* ====================================================================== */
+/*                              Quantization                              */
+/* ====================================================================== */
+
+namespace
+{
+    FIntVector QuantizeLocation(const FVector& Location)
+    {
+        const double Scale = 1.0 / FCharacter2DRuntimeSnapshot::LocationStep;
+        return FIntVector(
+            static_cast<int32>(FMath::RoundToDouble(Location.X * Scale)),
+            static_cast<int32>(FMath::RoundToDouble(Location.Y * Scale)),
+            static_cast<int32>(FMath::RoundToDouble(Location.Z * Scale)));
+    }
+
+    FVector DequantizeLocation(const FIntVector& Location)
+    {
+        return FVector(Location) * FCharacter2DRuntimeSnapshot::LocationStep;
+    }
+
+    void QuantizeScale(const FVector& Scale, int16 (&OutScale)[3])
+    {
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            OutScale[Axis] = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Scale[Axis] / FCharacter2DRuntimeSnapshot::ScaleStep), MIN_int16, MAX_int16));
+        }
+    }
+
+    FVector DequantizeScale(const int16 (&Scale)[3])
+    {
+        return FVector(Scale[0], Scale[1], Scale[2]) * FCharacter2DRuntimeSnapshot::ScaleStep;
+    }
+
+    uint8 QuantizeUnit(float Value)
+    {
+        return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Value * 255.0f), 0, 255));
+    }
+
+    FCharacter2DSnapshotTween QuantizeTween(const FCharacter2DTween& Tween)
+    {
+        FCharacter2DSnapshotTween Out;
+        Out.DurationCs = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Tween.Duration * 100.0f), 0, MAX_uint16));
+        Out.Phase = Tween.Duration > 0.0f
+            ? static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Tween.Time / Tween.Duration * MAX_uint16), 0, MAX_uint16))
+            : 0;
+        Out.Easing = Tween.Easing;
+        return Out;
+    }
+
+    FCharacter2DTween DequantizeTween(const FCharacter2DSnapshotTween& In, const UCurveFloat* Curve, bool bLoop, bool bReverse)
+    {
+        FCharacter2DTween Tween;
+        Tween.Start(In.DurationCs / 100.0f, In.Easing, Curve, bLoop, bReverse);
+        Tween.Time = In.Phase / static_cast<float>(MAX_uint16) * Tween.Duration;
+        // Сюда передаются только кривые ассета
+        Tween.bAssetCurve = Curve != nullptr;
+        return Tween;
+    }
+
+    void SerializeTween(FArchive& Ar, FCharacter2DSnapshotTween& Tween)
+    {
+        uint8 Easing = static_cast<uint8>(Tween.Easing);
+        Ar << Tween.DurationCs << Tween.Phase << Easing;
+        Tween.Easing = static_cast<ECharacter2DEasing>(Easing);
+    }
+
+    void SerializeScale(FArchive& Ar, int16 (&Scale)[3])
+    {
+        for (int16& Axis : Scale)
+        {
+            Ar << Axis;
+        }
+    }
+}
+
+/* ====================================================================== */
+/*                                Snapshot                                */
+/* ====================================================================== */
+
+void FCharacter2DRuntimeSnapshot::Capture(const ACharacter2DActor& Actor)
+{
+    Reset();
+
+    auto SetFlag = [this](EFlags Flag, bool bSet)
+    {
+        Flags = static_cast<uint16>(bSet ? (Flags | Flag) : (Flags & ~Flag));
+    };
+
+    SetFlag(Flag_Valid, true);
+    SetFlag(Flag_Hidden, Actor.IsHidden());
+    SetFlag(Flag_SpritesVisible, Actor.bSpritesVisible);
+    SetFlag(Flag_SkeletalVisible, Actor.bSkeletalVisible);
+    SetFlag(Flag_Blinking, Actor.bBlinkingActive);
+    SetFlag(Flag_Talking, Actor.bTalkingActive);
+
+    Expression = static_cast<int16>(Actor.ExpressionIndex);
+    Opacity = QuantizeUnit(Actor.GetSpritesOpacity());
+    Location = QuantizeLocation(Actor.GetActorLocation());
+    QuantizeScale(Actor.GetActorScale3D(), Scale);
+    BlinkRandomSeed = Actor.BlinkRandom.GetCurrentSeed();
+
+    const UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(&Actor);
+    if (!Animation)
+    {
+        return;
+    }
+
+    FCharacter2DAnimationSlotState State;
+    Animation->CaptureSlotState(&Actor, State);
+
+    if (State.bMoving)
+    {
+        SetFlag(Flag_Moving, true);
+        SetFlag(Flag_MoveAssetCurve, State.Move.bAssetCurve);
+        MoveFrom = QuantizeLocation(State.MoveFrom);
+        MoveTo = QuantizeLocation(State.MoveTo);
+        MoveTween = QuantizeTween(State.Move);
+    }
+    if (State.bFading)
+    {
+        SetFlag(Flag_Fading, true);
+        SetFlag(Flag_FadeIn, State.bFadeIn);
+        FadeTween = QuantizeTween(State.Fade);
+    }
+    if (State.bEmotion)
+    {
+        SetFlag(Flag_Emotion, true);
+        SetFlag(Flag_EmotionAssetCurve, State.Emotion.bAssetCurve);
+        SetFlag(Flag_EmotionLoop, State.Emotion.bLoop);
+        SetFlag(Flag_EmotionOnGpu, State.bEmotionOnGpu);
+        EmotionTween = QuantizeTween(State.Emotion);
+        EmotionType = State.EmotionType;
+        EmotionIntensity = QuantizeUnit(State.EmotionIntensity);
+        EmotionColor = State.EmotionColor.ToFColor(false);
+        EmotionBaseLocation = QuantizeLocation(State.EmotionBaseLocation);
+        QuantizeScale(State.EmotionBaseScale, EmotionBaseScale);
+
+        // Частота тряски есть только в Custom Primitive Data: слот её не хранит
+        if (State.bEmotionOnGpu)
+        {
+            if (const UPrimitiveComponent* Primitive = Actor.GetFirstRenderPrimitive())
+            {
+                const TArray<float>& Data = Primitive->GetCustomPrimitiveData().Data;
+                if (Data.IsValidIndex(Character2DPrimitiveData::EmotionFrequency))
+                {
+                    EmotionFrequency = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Data[Character2DPrimitiveData::EmotionFrequency]), 0, 255));
+                }
+            }
+        }
+    }
+    if (State.bBlink)
+    {
+        // Закрытие век посреди кадра сохраняется как ожидание: при восстановлении моргание начнётся заново
+        SetFlag(Flag_BlinkScheduled, true);
+        BlinkRemainingMs = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(State.BlinkRemaining * 1000.0f), 0, MAX_uint16));
+    }
+}
+
+void FCharacter2DRuntimeSnapshot::Restore(ACharacter2DActor& Actor) const
+{
+    if (!IsValid())
+    {
+        return;
+    }
+
+    UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(&Actor);
+    const FCharacter2DVisualNovelSettings* Settings = Actor.CharacterAsset ? &Actor.CharacterAsset->VisualNovelSettings : nullptr;
+
+    // Текущая эмоция снимается молча: откат — не завершение, OnEmotionFinished не нужен
+    if (Actor.bEmotionOnGpu)
+    {
+        for (UPrimitiveComponent* Primitive : Actor.GetRenderPrimitives())
+        {
+            Character2DPrimitiveData::ClearEmotion(Primitive);
+        }
+        Actor.bEmotionOnGpu = false;
+    }
+    Actor.bIsMoving = false;
+    Actor.bIsPlayingEmotion = false;
+    Actor.CurrentEmotionType = ECharacter2DEmotionEffect::None;
+    Actor.ReleaseImpostor();
+    Actor.RestoreOriginalValues();
+
+    Actor.SetActorLocation(DequantizeLocation(Location));
+    Actor.SetActorScale3D(DequantizeScale(Scale));
+    Actor.SetActorHiddenInGame((Flags & Flag_Hidden) != 0);
+    Actor.SetBothVisible((Flags & Flag_SpritesVisible) != 0, (Flags & Flag_SkeletalVisible) != 0);
+    Actor.SetExpressionByIndex(Expression);
+
+    // Flipbook'и моргания и разговора перезапускаются; таймер моргания ставится из снимка ниже
+    if (Actor.bIsBlinking)
+    {
+        Actor.StopBlinking();
+    }
+    Actor.EnableBlinking((Flags & Flag_Blinking) != 0);
+    Actor.EnableTalking((Flags & Flag_Talking) != 0);
+    Actor.BlinkRandom.Initialize(BlinkRandomSeed);
+
+    const float RestoredOpacity = Opacity / 255.0f;
+    Actor.SetAllSpritesOpacity(RestoredOpacity);
+    Actor.SetAllSkeletalOpacity(RestoredOpacity);
+
+    FCharacter2DAnimationSlotState State;
+    if (Animation)
+    {
+        // В снимке только кривые ассета; их же держит подсистема после RestoreSlotState
+        State.MoveCurve = (Flags & Flag_MoveAssetCurve) && Settings ? Settings->DefaultMovementSettings.AnimationCurve.Get() : nullptr;
+        State.FadeCurve = Settings ? Settings->DefaultFadeCurve.Get() : nullptr;
+        State.EmotionCurve = (Flags & Flag_EmotionAssetCurve) && Settings ? Settings->DefaultEmotionSettings.AnimationCurve.Get() : nullptr;
+
+        State.bMoving = (Flags & Flag_Moving) != 0;
+        State.Move = DequantizeTween(MoveTween, State.MoveCurve.Get(), false, false);
+        State.MoveFrom = DequantizeLocation(MoveFrom);
+        State.MoveTo = DequantizeLocation(MoveTo);
+
+        State.bFading = (Flags & Flag_Fading) != 0;
+        State.bFadeIn = (Flags & Flag_FadeIn) != 0;
+        State.Fade = DequantizeTween(FadeTween, State.FadeCurve.Get(), false, !State.bFadeIn);
+
+        State.bEmotion = (Flags & Flag_Emotion) != 0;
+        State.Emotion = DequantizeTween(EmotionTween, State.EmotionCurve.Get(), (Flags & Flag_EmotionLoop) != 0, false);
+        State.EmotionType = EmotionType;
+        State.EmotionIntensity = EmotionIntensity / 255.0f;
+        State.EmotionColor = EmotionColor.ReinterpretAsLinear();
+        State.EmotionBaseLocation = DequantizeLocation(EmotionBaseLocation);
+        State.EmotionBaseScale = DequantizeScale(EmotionBaseScale);
+        State.bEmotionOnGpu = (Flags & Flag_EmotionOnGpu) != 0;
+
+        State.bBlink = (Flags & Flag_BlinkScheduled) != 0 && Actor.bIsBlinking;
+        State.BlinkRemaining = BlinkRemainingMs / 1000.0f;
+
+        if (!Animation->RestoreSlotState(&Actor, State))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Character2D: tween pool is full, %s restored without some animations"), *Actor.GetName());
+            Animation->CaptureSlotState(&Actor, State);
+        }
+    }
+
+    Actor.bIsMoving = State.bMoving;
+    Actor.MovementTargetLocation = State.MoveTo;
+    Actor.bIsFading = State.bFading;
+    Actor.bIsPlayingEmotion = State.bEmotion;
+    if (State.bEmotion)
+    {
+        Actor.CurrentEmotionType = State.EmotionType;
+        Actor.OriginalActorLocation = State.EmotionBaseLocation;
+        Actor.OriginalActorScale = State.EmotionBaseScale;
+
+        if (State.bEmotionOnGpu)
+        {
+            FCharacter2DEmotionSettings EmotionSettings;
+            EmotionSettings.Duration = State.Emotion.Duration;
+            EmotionSettings.Intensity = State.EmotionIntensity;
+            EmotionSettings.ShakeFrequency = EmotionFrequency;
+            EmotionSettings.TargetColor = State.EmotionColor;
+            EmotionSettings.bLoop = State.Emotion.bLoop;
+            EmotionSettings.Easing = State.Emotion.Easing;
+
+            // Материал считает от StartTime: сдвигаем его на пройденную фазу
+            const float StartTime = Actor.GetWorld()->GetTimeSeconds() - State.Emotion.Time;
+            for (UPrimitiveComponent* Primitive : Actor.GetRenderPrimitives())
+            {
+                Character2DPrimitiveData::WriteEmotion(Primitive, State.EmotionType, EmotionSettings, StartTime);
+            }
+            Actor.bEmotionOnGpu = true;
+        }
+    }
+
+    Actor.RequestImpostor();
+}
+
+bool FCharacter2DRuntimeSnapshot::Serialize(FArchive& Ar)
+{
+    uint8 SavedVersion = Version;
+    Ar << SavedVersion;
+    if (Ar.IsLoading() && (SavedVersion == 0 || SavedVersion > Version))
+    {
+        Ar.SetError();
+        return false;
+    }
+
+    // Секции неактивных каналов не пишутся
+    Ar << Flags << Expression << Opacity << Location;
+    SerializeScale(Ar, Scale);
+
+    if (Flags & Flag_Blinking)
+    {
+        Ar << BlinkRandomSeed;
+    }
+    if (Flags & Flag_BlinkScheduled)
+    {
+        Ar << BlinkRemainingMs;
+    }
+    if (Flags & Flag_Moving)
+    {
+        Ar << MoveFrom << MoveTo;
+        SerializeTween(Ar, MoveTween);
+    }
+    if (Flags & Flag_Fading)
+    {
+        SerializeTween(Ar, FadeTween);
+    }
+    if (Flags & Flag_Emotion)
+    {
+        uint8 Type = static_cast<uint8>(EmotionType);
+        SerializeTween(Ar, EmotionTween);
+        Ar << Type << EmotionIntensity << EmotionFrequency << EmotionColor << EmotionBaseLocation;
+        SerializeScale(Ar, EmotionBaseScale);
+        EmotionType = static_cast<ECharacter2DEmotionEffect>(Type);
+    }
+
+    return !Ar.IsError();
+}
+
+/* ====================================================================== */
+/*                                History                                 */
+/* ====================================================================== */
+
+FCharacter2DSnapshotHistory::FCharacter2DSnapshotHistory(int32 InMaxLines, int32 InMaxCharacters)
+    : MaxLines(FMath::Max(InMaxLines, 1))
+    , MaxCharacters(FMath::Max(InMaxCharacters, 1))
+{
+    Snapshots.SetNum(MaxLines * MaxCharacters);
+    LineCounts.SetNumZeroed(MaxLines);
+}
+
+void FCharacter2DSnapshotHistory::PushLine(TConstArrayView<ACharacter2DActor*> Actors)
+{
+    const int32 Count = FMath::Min(Actors.Num(), MaxCharacters);
+    FCharacter2DRuntimeSnapshot* Line = Snapshots.GetData() + Head * MaxCharacters;
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        if (Actors[Index])
+        {
+            Line[Index].Capture(*Actors[Index]);
+        }
+        else
+        {
+            Line[Index].Reset();
+        }
+    }
+
+    LineCounts[Head] = Count;
+    Head = (Head + 1) % MaxLines;
+    NumLines = FMath::Min(NumLines + 1, MaxLines);
+}
+
+bool FCharacter2DSnapshotHistory::Rollback(int32 Steps, TConstArrayView<ACharacter2DActor*> Actors)
+{
+    if (Steps < 1 || Steps > NumLines)
+    {
+        return false;
+    }
+
+    const int32 Line = (Head - Steps + MaxLines) % MaxLines;
+    const int32 Count = FMath::Min(LineCounts[Line], Actors.Num());
+    const FCharacter2DRuntimeSnapshot* Snapshot = Snapshots.GetData() + Line * MaxCharacters;
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        if (Actors[Index])
+        {
+            Snapshot[Index].Restore(*Actors[Index]);
+        }
+    }
+
+    // Строка снова станет текущей: её перезапишет следующий PushLine
+    Head = Line;
+    NumLines -= Steps;
+    return true;
+}
+
+void FCharacter2DSnapshotHistory::Reset()
+{
+    Head = 0;
+    NumLines = 0;
+}
@@ -0,0 +1,117 @@
+#include "Animation/Character2DTimingWheel.h"
+
+/* ====================================================================== */
+/*                              Timing Wheel                              */
+/* ====================================================================== */
+
+uint64 FCharacter2DTimingWheel::Schedule(int32 Id, uint32 Cookie, float DelaySeconds)
+{
+    // Первый тик, время которого не раньше "сейчас + Delay"; "сейчас" — с учётом накопленной доли тика
+    const double Ticks = FMath::CeilToDouble((static_cast<double>(Accumulator) + FMath::Max(DelaySeconds, 0.0f)) / TickSeconds);
+    const uint64 DelayTicks = FMath::Clamp<uint64>(static_cast<uint64>(Ticks), 1, MaxDelayTicks - 1);
+
+    FEntry Entry;
+    Entry.FireTick = CurrentTick + DelayTicks;
+    Entry.Id = Id;
+    Entry.Cookie = Cookie;
+    Insert(Entry);
+    ++NumEntries;
+    return Entry.FireTick;
+}
+
+float FCharacter2DTimingWheel::GetSecondsUntil(uint64 FireTick) const
+{
+    return FireTick > CurrentTick
+        ? FMath::Max(static_cast<float>(FireTick - CurrentTick) * TickSeconds - Accumulator, 0.0f)
+        : 0.0f;
+}
+
+void FCharacter2DTimingWheel::Reset()
+{
+    for (TArray<FEntry>& Bucket : Level0) Bucket.Reset();
+    for (TArray<FEntry>& Bucket : Level1) Bucket.Reset();
+    for (TArray<FEntry>& Bucket : Level2) Bucket.Reset();
+    NumEntries = 0;
+    Accumulator = 0.0f;
+}
+
+void FCharacter2DTimingWheel::Insert(const FEntry& Entry)
+{
+    const uint64 Delta = Entry.FireTick > CurrentTick ? Entry.FireTick - CurrentTick : 0;
+    if (Delta < Level0Size)
+    {
+        Level0[Entry.FireTick & (Level0Size - 1)].Add(Entry);
+    }
+    else if (Delta < (uint64(1) << (Level0Bits + LevelBits)))
+    {
+        Level1[(Entry.FireTick >> Level0Bits) & (LevelSize - 1)].Add(Entry);
+    }
+    else
+    {
+        Level2[(Entry.FireTick >> (Level0Bits + LevelBits)) & (LevelSize - 1)].Add(Entry);
+    }
+}
+
+void FCharacter2DTimingWheel::Cascade(TArray<FEntry>& Bucket)
+{
+    // Insert в ту же корзину не попадёт: интервал корзины уже начался
+    for (const FEntry& Entry : Bucket)
+    {
+        Insert(Entry);
+    }
+    Bucket.Reset();
+}
+
+void FCharacter2DTimingWheel::ProcessTick(TArray<FEntry>& OutExpired)
+{
+    const uint64 Index0 = CurrentTick & (Level0Size - 1);
+    if (Index0 == 0)
+    {
+        const uint64 Index1 = (CurrentTick >> Level0Bits) & (LevelSize - 1);
+        if (Index1 == 0)
+        {
+            Cascade(Level2[(CurrentTick >> (Level0Bits + LevelBits)) & (LevelSize - 1)]);
+        }
+        Cascade(Level1[Index1]);
+    }
+
+    TArray<FEntry>& Bucket = Level0[Index0];
+    if (Bucket.IsEmpty())
+    {
+        return;
+    }
+
+    // В корзине уровня 0 только записи этого тика; Reset сохраняет память под следующий оборот
+    NumEntries -= Bucket.Num();
+    OutExpired.Append(Bucket);
+    Bucket.Reset();
+}
+
+void FCharacter2DTimingWheel::Advance(float DeltaTime, TArray<FEntry>& OutExpired)
+{
+    Accumulator += FMath::Max(DeltaTime, 0.0f);
+    const uint64 NumTicks = static_cast<uint64>(Accumulator / TickSeconds);
+    if (NumTicks == 0)
+    {
+        return;
+    }
+    Accumulator = FMath::Max(Accumulator - NumTicks * TickSeconds, 0.0f);
+
+    // Пустое колесо (или длинная пауза без таймеров) — просто сдвигаем время
+    if (NumEntries == 0)
+    {
+        CurrentTick += NumTicks;
+        return;
+    }
+
+    for (uint64 Tick = 0; Tick < NumTicks; ++Tick)
+    {
+        ++CurrentTick;
+        ProcessTick(OutExpired);
+        if (NumEntries == 0)
+        {
+            CurrentTick += NumTicks - Tick - 1;
+            break;
+        }
+    }
+}
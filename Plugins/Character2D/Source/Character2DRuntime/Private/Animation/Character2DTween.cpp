@@ -0,0 +1,108 @@
+#include "Animation/Character2DTween.h"
+#include "Animation/Character2DCurveCache.h"
+#include "Curves/CurveFloat.h"
+
+/* ====================================================================== */
+/*                                 Easing                                 */
+/* ====================================================================== */
+
+float Character2DEasing::Apply(ECharacter2DEasing Easing, float Alpha)
+{
+    const float A = FMath::Clamp(Alpha, 0.0f, 1.0f);
+    switch (Easing)
+    {
+    case ECharacter2DEasing::EaseIn:
+        return A * A;
+    case ECharacter2DEasing::EaseOut:
+        return 1.0f - (1.0f - A) * (1.0f - A);
+    case ECharacter2DEasing::EaseInOut:
+        return A < 0.5f ? 2.0f * A * A : 1.0f - 2.0f * (1.0f - A) * (1.0f - A);
+    case ECharacter2DEasing::SmoothStep:
+        return A * A * (3.0f - 2.0f * A);
+    case ECharacter2DEasing::PingPong:
+        return 1.0f - FMath::Abs(A * 2.0f - 1.0f);
+    case ECharacter2DEasing::Linear:
+    default:
+        return A;
+    }
+}
+
+/* ====================================================================== */
+/*                               Curve LUT                                */
+/* ====================================================================== */
+
+void FCharacter2DCurveLUT::Bake(const UCurveFloat* Curve)
+{
+    float MinTime = 0.0f;
+    float MaxTime = 1.0f;
+    if (Curve)
+    {
+        Curve->GetTimeRange(MinTime, MaxTime);
+    }
+
+    for (int32 Index = 0; Index < NumSamples; ++Index)
+    {
+        const float Alpha = static_cast<float>(Index) / (NumSamples - 1);
+        Samples[Index] = Curve ? Curve->GetFloatValue(FMath::Lerp(MinTime, MaxTime, Alpha)) : Alpha;
+    }
+}
+
+/* ====================================================================== */
+/*                                 Tween                                  */
+/* ====================================================================== */
+
+void FCharacter2DTween::Start(float InDuration, ECharacter2DEasing InEasing, const UCurveFloat* InCurve, bool bInLoop, bool bInReverse)
+{
+    Time = 0.0f;
+    Duration = InDuration;
+    Easing = InEasing;
+    bLoop = bInLoop;
+    bReverse = bInReverse;
+    bAssetCurve = false;
+    Curve = FCharacter2DCurveCache::Get().FindOrBake(InCurve);
+}
+
+bool FCharacter2DTween::Advance(float DeltaTime)
+{
+    Time += DeltaTime;
+    if (Time < Duration)
+    {
+        return false;
+    }
+
+    if (bLoop && Duration > 0.0f)
+    {
+        Time = FMath::Fmod(Time, Duration);
+        return false;
+    }
+
+    Time = Duration;
+    return true;
+}
+
+/* ====================================================================== */
+/*                                  Pool                                  */
+/* ====================================================================== */
+
+FCharacter2DTweenPool::FCharacter2DTweenPool(int32 InCapacity)
+{
+    Tweens.SetNum(InCapacity);
+    FreeHandles.Reserve(InCapacity);
+    for (int32 Handle = InCapacity - 1; Handle >= 0; --Handle)
+    {
+        FreeHandles.Add(Handle);
+    }
+}
+
+int32 FCharacter2DTweenPool::Acquire()
+{
+    return FreeHandles.Num() > 0 ? FreeHandles.Pop(EAllowShrinking::No) : INDEX_NONE;
+}
+
+void FCharacter2DTweenPool::Release(int32 Handle)
+{
+    if (Tweens.IsValidIndex(Handle))
+    {
+        FreeHandles.Add(Handle);
+    }
+}
@@ -1,11 +1,65 @@
 #include "Character2DActor.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "Components/TimelineComponent.h"
 #include "Engine/World.h"
 #include "Curves/CurveFloat.h"
+#include "Subsystems/Character2DAnimationSubsystem.h"
+#include "Subsystems/Character2DSignificanceSubsystem.h"
+#include "Subsystems/Character2DImpostorSubsystem.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Rendering/Character2DPrimitiveData.h"
+#include "Character2DStats.h"
+#include "Animation/Character2DRuntimeSnapshot.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
 #include "Materials/MaterialParameterCollection.h"
 #include "Materials/MaterialParameterCollectionInstance.h"
 
+DEFINE_STAT(STAT_Character2D_OnConstruction);
+DEFINE_STAT(STAT_Character2D_ApplyAssetState);
+DEFINE_STAT(STAT_Character2D_SetSpritesOpacity);
+DEFINE_STAT(STAT_Character2D_SetSpritesColor);
+DEFINE_STAT(STAT_Character2D_SetSkeletalOpacity);
+DEFINE_STAT(STAT_Character2D_HandleBlink);
+DEFINE_STAT(STAT_Character2D_ActiveCharacters);
+DEFINE_STAT(STAT_Character2D_ComponentsUpdated);
+
+/** Компонент, созданный во время игры (не default subobject): не сохраняется, регистрируется сразу */
+template<typename ComponentType>
+static ComponentType* CreateCharacterComponent(AActor* Owner, const TCHAR* BaseName, USceneComponent* Parent)
+{
+    ComponentType* Component = NewObject<ComponentType>(Owner,
+        MakeUniqueObjectName(Owner, ComponentType::StaticClass(), BaseName), RF_Transient);
+    Component->SetupAttachment(Parent);
+    if (Owner->GetWorld())
+    {
+        Component->RegisterComponent();
+    }
+    return Component;
+}
+
+/** Default subobject, который регистрирует не RegisterAllComponents, а режим отрисовки; true — зарегистрирован только что */
+static bool RegisterDeferredComponent(UActorComponent* Component)
+{
+    if (!Component || Component->IsRegistered() || !Component->GetOwner()->GetWorld())
+    {
+        return false;
+    }
+
+    Component->RegisterComponent();
+    Component->Activate();
+    return true;
+}
+
+/** Обратное RegisterDeferredComponent: компонент остаётся подобъектом актёра, но не рисуется и не тикает */
+static void UnregisterDeferredComponent(UActorComponent* Component)
+{
+    if (Component && Component->IsRegistered())
+    {
+        Component->Deactivate();
+        Component->UnregisterComponent();
+    }
+}
+
 ACharacter2DActor::ACharacter2DActor()
 {
     PrimaryActorTick.bCanEverTick = true;
@@ -17,209 +71,583 @@ ACharacter2DActor::ACharacter2DActor()
 void ACharacter2DActor::SetupComponents()
 {
     /* ---------- Skeletal Components ---------- */
-    BodyComponent = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("BodyComponent"));
-    ArmsComponent = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ArmsComponent"));
-    HeadComponent = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("HeadComponent"));
-    
-    BodyComponent->SetupAttachment(RootComponent);
-    ArmsComponent->SetupAttachment(RootComponent);
-    HeadComponent->SetupAttachment(RootComponent);
+    // Подобъекты остаются (Blueprint-переопределения, ссылки из графов), регистрация — GetOrRegisterSkeletalComponent
+    BodyComponent = CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("BodyComponent"));
+    ArmsComponent = CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("ArmsComponent"));
+    HeadComponent = CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("HeadComponent"));
 
     /* ---------- Sprite Components ----------- */
-    SpriteBody = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteBody"));
-    SpriteArms = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteArms"));
-    SpriteHead = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteHead"));
-    SpriteEyebrow = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteEyebrow"));
-    SpriteEyes = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteEyes"));
-    SpriteEyelids = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteEyelids"));
-    SpriteMouth = CreateDefaultSubobject<UPaperSpriteComponent>(TEXT("SpriteMouth"));
-
-    // Default hierarchy: head is parent for facial sprites and animations
-    SpriteBody->SetupAttachment(RootComponent);
-    SpriteArms->SetupAttachment(RootComponent);
-    SpriteHead->SetupAttachment(RootComponent);
-
-    SpriteEyebrow->SetupAttachment(SpriteHead);
-    SpriteEyes->SetupAttachment(SpriteHead);
-    SpriteEyelids->SetupAttachment(SpriteHead);
-    SpriteMouth->SetupAttachment(SpriteHead);
-
-    // Common sprite component settings
-    TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
-    for (UPaperSpriteComponent* Component : SpriteComponents)
+    // Компоненты слоёв создаются по ассету в SyncSpriteLayerComponents
+
+    /* ---------- Flipbook Components --------- */
+    // Регистрируются при первом моргании/разговоре без LayeredSprite: GetOrRegisterFlipbookComponent
+    EyelidComponent = CreateOptionalDefaultSubobject<UPaperFlipbookComponent>(TEXT("EyelidFlipbook"));
+    MouthComponent = CreateOptionalDefaultSubobject<UPaperFlipbookComponent>(TEXT("MouthFlipbook"));
+
+    for (USceneComponent* Component : { static_cast<USceneComponent*>(BodyComponent), static_cast<USceneComponent*>(ArmsComponent),
+        static_cast<USceneComponent*>(HeadComponent), static_cast<USceneComponent*>(EyelidComponent), static_cast<USceneComponent*>(MouthComponent) })
     {
-        Component->SetCastShadow(false);
-        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        if (Component)
+        {
+            Component->SetupAttachment(RootComponent);
+            Component->bAutoRegister = false;
+            Component->bAutoActivate = false;
+        }
     }
 
-    /* ---------- Flipbook Components --------- */
-    EyelidComponent = CreateDefaultSubobject<UPaperFlipbookComponent>(TEXT("EyelidFlipbook"));
-    MouthComponent = CreateDefaultSubobject<UPaperFlipbookComponent>(TEXT("MouthFlipbook"));
+    /* ---------- Layered Sprite Component ----- */
+    LayeredSprite = CreateDefaultSubobject<UCharacter2DLayeredSpriteComponent>(TEXT("LayeredSprite"));
+    LayeredSprite->SetupAttachment(RootComponent);
+}
 
-    // Flipbook animations should follow the head hierarchy as well
-    EyelidComponent->SetupAttachment(SpriteHead);
-    MouthComponent->SetupAttachment(SpriteHead);
+void ACharacter2DActor::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
 
-    /* ---------- Timeline Components --------- */
-    MovementTimeline = CreateDefaultSubobject<UTimelineComponent>(TEXT("MovementTimeline"));
-    EmotionTimeline = CreateDefaultSubobject<UTimelineComponent>(TEXT("EmotionTimeline"));
-    FadeTimeline = CreateDefaultSubobject<UTimelineComponent>(TEXT("FadeTimeline"));
+    // Актёр уровня в PIE и cooked-сборке: OnConstruction не вызывается, а слои и AppliedState не сохраняются
+    if (!AppliedState.bValid)
+    {
+        ApplyAssetState(ECharacter2DLayerMask::All);
+    }
 }
 
 void ACharacter2DActor::BeginPlay()
 {
     Super::BeginPlay();
-    
+
+    // Prewarm до начала игры: актёр уже спрятан в пуле
+    if (!bInPool)
+    {
+        StartCharacterRuntime();
+    }
+}
+
+void ACharacter2DActor::StartCharacterRuntime()
+{
+    INC_DWORD_STAT(STAT_Character2D_ActiveCharacters);
     StoreOriginalValues();
+    SetBlinkSeed(BlinkSeed);
     
     if (CharacterAsset)
     {
         EnableBlinking(CharacterAsset->bAutoBlink);
         EnableTalking(CharacterAsset->bAutoTalk);
     }
+
+    if (bUseSignificance)
+    {
+        if (UCharacter2DSignificanceSubsystem* Significance = UCharacter2DSignificanceSubsystem::Get(this))
+        {
+            Significance->Register(this);
+        }
+    }
+
+    // Смена слоёв внутри LayeredSprite сбрасывает импостор
+    LayeredSprite->OnStaticLayersChanged.AddUObject(this, &ACharacter2DActor::HandleStaticLayersChanged);
+    RequestImpostor();
 }
 
 void ACharacter2DActor::OnConstruction(const FTransform& Transform)
 {
+    CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_OnConstruction);
     Super::OnConstruction(Transform);
-    if (!CharacterAsset) return;
-
-    // Setup skeletal parts
-    SetupSkeletalComponent(BodyComponent, CharacterAsset->Body);
-    SetupSkeletalComponent(ArmsComponent, CharacterAsset->Arms);
-    SetupSkeletalComponent(HeadComponent, CharacterAsset->Head);
-
-    // Setup sprite parts using new structure directly
-    SetupSpriteComponentFromStruct(SpriteBody, CharacterAsset->SpriteStructure.Body);
-    SetupSpriteComponentFromStruct(SpriteArms, CharacterAsset->SpriteStructure.Arms);
-    SetupSpriteComponent(SpriteHead, CharacterAsset->GetHeadSprite());
-    SetupSpriteComponent(SpriteEyebrow, CharacterAsset->GetEyebrowSprite());
-    SetupSpriteComponent(SpriteEyes, CharacterAsset->GetEyesSprite());
-    SetupSpriteComponent(SpriteEyelids, CharacterAsset->GetEyelidsSprite());
-    SetupSpriteComponent(SpriteMouth, CharacterAsset->GetMouthSprite());
-
-    // Attach sprites to sockets if specified
-    AttachSpriteToSocketFromStruct(SpriteBody, CharacterAsset->SpriteStructure.Body);
-    AttachSpriteToSocketFromStruct(SpriteArms, CharacterAsset->SpriteStructure.Arms);
-    AttachSpriteToSocket(SpriteHead, CharacterAsset->GetHeadSprite());
-    AttachSpriteToSocket(SpriteEyebrow, CharacterAsset->GetEyebrowSprite());
-    AttachSpriteToSocket(SpriteEyes, CharacterAsset->GetEyesSprite());
-    AttachSpriteToSocket(SpriteEyelids, CharacterAsset->GetEyelidsSprite());
-    AttachSpriteToSocket(SpriteMouth, CharacterAsset->GetMouthSprite());
-
-    // Setup flipbook components
-    const auto& BlinkSettings = CharacterAsset->GetBlinkSettings();
-    EyelidComponent->SetFlipbook(BlinkSettings.BlinkFlipbook);
-    EyelidComponent->SetVisibility(false);
-    AttachFlipbookToSocket(EyelidComponent,
-        BlinkSettings.AttachmentTarget,
-        BlinkSettings.SocketName,
-        BlinkSettings.bUseSocketTransform,
-        BlinkSettings.Offset,
-        BlinkSettings.Scale);
-
-    const auto& TalkSettings = CharacterAsset->GetTalkSettings();
-    MouthComponent->SetFlipbook(TalkSettings.TalkFlipbook);
-    MouthComponent->SetVisibility(false);
-    AttachFlipbookToSocket(MouthComponent,
-        TalkSettings.AttachmentTarget,
-        TalkSettings.SocketName,
-        TalkSettings.bUseSocketTransform,
-        TalkSettings.Offset,
-        TalkSettings.Scale);
-
-    // Set initial visibility based on dual rendering setting
-    SetSpritesVisible(CharacterAsset->bEnableDualRendering || !HasValidSkeletalMeshes());
-    SetSkeletalVisible(CharacterAsset->bEnableDualRendering || !HasValidSprites());
+
+    // Construction script мог сбросить компоненты — настраиваем всё, включая неизменившиеся слои
+    AppliedState.SpriteLayers.Reset();
+    ApplyAssetState(ECharacter2DLayerMask::All);
 }
 
 void ACharacter2DActor::RefreshFromAsset()
 {
-    OnConstruction(GetActorTransform());
+    const ECharacter2DLayerMask Dirty = DiffAppliedState();
+    if (Dirty == ECharacter2DLayerMask::None)
+    {
+        return;
+    }
+
+    ApplyAssetState(Dirty);
+    InvalidateImpostor();
 }
 
-void ACharacter2DActor::SetupSpriteComponentFromStruct(UPaperSpriteComponent* Component, const FCharacter2DSpriteBodyStructure& BodyStruct)
+void ACharacter2DActor::RefreshLayers(ECharacter2DLayerMask Mask)
 {
-    if (!Component || !CharacterAsset) return;
+    // Частично применять не к чему: компоненты ещё ни разу не настраивались
+    if (!AppliedState.bValid)
+    {
+        Mask = ECharacter2DLayerMask::All;
+    }
+    // Без сравнения со старыми: применяются все слои
+    if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::Sprites))
+    {
+        AppliedState.SpriteLayers.Reset();
+    }
 
-    const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
-    const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
-    
-    Component->SetSprite(BodyStruct.Sprite);
-    Component->SetRelativeLocation(BodyStruct.Offset + GlobalOffset);
-    Component->SetRelativeScale3D(FVector(BodyStruct.Scale * GlobalScale));
-    Component->SetVisibility(BodyStruct.bVisible && bSpritesVisible);
+    ApplyAssetState(Mask);
+    InvalidateImpostor();
 }
 
+template<typename StructType>
+static bool IsSameAppliedStruct(const StructType& Applied, const StructType& Current)
+{
+    return StructType::StaticStruct()->CompareScriptStruct(&Applied, &Current, PPF_None);
+}
 
-void ACharacter2DActor::SetupSpriteComponentFromStruct(UPaperSpriteComponent* Component, const FCharacter2DSpriteArmsStructure& ArmsStruct)
+template<typename StructType>
+static bool IsSameAppliedArray(const TArray<StructType>& Applied, const TArray<StructType>& Current)
 {
-    if (!Component || !CharacterAsset) return;
+    if (Applied.Num() != Current.Num())
+    {
+        return false;
+    }
+    for (int32 Index = 0; Index < Current.Num(); ++Index)
+    {
+        if (!IsSameAppliedStruct(Applied[Index], Current[Index]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
-    const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
-    const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
-    
-    Component->SetSprite(ArmsStruct.Sprite);
-    Component->SetRelativeLocation(ArmsStruct.Offset + GlobalOffset);
-    Component->SetRelativeScale3D(FVector(ArmsStruct.Scale * GlobalScale));
-    Component->SetVisibility(ArmsStruct.bVisible && bSpritesVisible);
+ECharacter2DLayerMask ACharacter2DActor::DiffAppliedState() const
+{
+    if (!CharacterAsset)
+    {
+        return ECharacter2DLayerMask::None;
+    }
+    if (!AppliedState.bValid)
+    {
+        return ECharacter2DLayerMask::All;
+    }
+
+    const FCharacter2DAppliedState& Applied = AppliedState;
+    ECharacter2DLayerMask Dirty = ECharacter2DLayerMask::None;
+
+    // Другой режим отрисовки спрайтов — перенастраиваются все слои
+    const bool bLayered = bUseLayeredSprites && UCharacter2DLayeredSpriteComponent::CanBatchAsset(CharacterAsset);
+    if (bLayered != Applied.bLayeredSprites || !IsSameAppliedStruct(Applied.SpriteTransform, CharacterAsset->SpriteTransform))
+    {
+        Dirty |= ECharacter2DLayerMask::Sprites | ECharacter2DLayerMask::Flipbooks;
+    }
+
+    // Какие именно слои изменились, ApplyAssetState выясняет сам
+    if (!IsSameAppliedArray(Applied.SpriteLayers, CharacterAsset->SpriteLayers))
+    {
+        // Flipbook без своего сокета следует за родителем слоя
+        Dirty |= ECharacter2DLayerMask::Sprites | ECharacter2DLayerMask::Flipbooks;
+    }
+
+    if (Applied.BlinkLayerId != CharacterAsset->BlinkLayerId || !IsSameAppliedStruct(Applied.Blink, CharacterAsset->BlinkSettings))
+    {
+        Dirty |= ECharacter2DLayerMask::BlinkFlipbook;
+    }
+    if (Applied.TalkLayerId != CharacterAsset->TalkLayerId || !IsSameAppliedStruct(Applied.Talk, CharacterAsset->TalkSettings))
+    {
+        Dirty |= ECharacter2DLayerMask::TalkFlipbook;
+    }
+
+    if (!Applied.SkeletalGlobalOffset.Equals(CharacterAsset->SkeletalGlobalOffset, 0.0) || Applied.SkeletalGlobalScale != CharacterAsset->GlobalScale)
+    {
+        Dirty |= ECharacter2DLayerMask::Skeletal;
+    }
+    if (!IsSameAppliedStruct(Applied.SkeletalBody, CharacterAsset->Body)) Dirty |= ECharacter2DLayerMask::SkeletalBody;
+    if (!IsSameAppliedStruct(Applied.SkeletalArms, CharacterAsset->Arms)) Dirty |= ECharacter2DLayerMask::SkeletalArms;
+    if (!IsSameAppliedStruct(Applied.SkeletalHead, CharacterAsset->Head)) Dirty |= ECharacter2DLayerMask::SkeletalHead;
+
+    // Индексы таблицы выражений могли съехать — лицо накладывается заново
+    if (!IsSameAppliedArray(Applied.ExpressionSets, CharacterAsset->ExpressionSets))
+    {
+        Dirty |= ECharacter2DLayerMask::Sprites;
+    }
+
+    // Видимость по составу ассета (только спрайты / только скелет / оба)
+    if (Applied.bSpritesVisible != (CharacterAsset->bEnableDualRendering || !HasValidSkeletalMeshes()) ||
+        Applied.bSkeletalVisible != (CharacterAsset->bEnableDualRendering || !HasValidSprites()))
+    {
+        Dirty |= ECharacter2DLayerMask::Visibility;
+    }
+
+    return Dirty;
 }
 
-void ACharacter2DActor::AttachSpriteToSocketFromStruct(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteBodyStructure& BodyStruct)
+void ACharacter2DActor::ApplyAssetState(ECharacter2DLayerMask Mask)
 {
-    if (!SpriteComp || !CharacterAsset) return;
+    if (!CharacterAsset || Mask == ECharacter2DLayerMask::None) return;
+    CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_ApplyAssetState);
 
-    ECharacter2DAttachmentTarget Target = BodyStruct.AttachmentTarget;
-    FName Socket = BodyStruct.SocketName;
-    bool bUseSocketTransform = BodyStruct.bUseSocketTransform;
-    FVector LocalOffset = BodyStruct.Offset;
-    float LocalScale = BodyStruct.Scale;
+    FCharacter2DAppliedState& Applied = AppliedState;
+    const TArray<FCharacter2DSpriteLayer>& Layers = CharacterAsset->SpriteLayers;
 
-    if (Target == ECharacter2DAttachmentTarget::None) return;
+    // Не загруженные заранее (PreloadAsync) части грузятся здесь синхронно
+    // Setup skeletal parts; незарегистрированные компоненты настроятся при регистрации
+    if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::SkeletalBody))
+    {
+        SetupSkeletalComponent(BodyComponent, CharacterAsset->Body);
+        Applied.SkeletalBody = CharacterAsset->Body;
+    }
+    if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::SkeletalArms))
+    {
+        SetupSkeletalComponent(ArmsComponent, CharacterAsset->Arms);
+        Applied.SkeletalArms = CharacterAsset->Arms;
+    }
+    if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::SkeletalHead))
+    {
+        SetupSkeletalComponent(HeadComponent, CharacterAsset->Head);
+        Applied.SkeletalHead = CharacterAsset->Head;
+    }
+    if (EnumHasAllFlags(Mask, ECharacter2DLayerMask::Skeletal))
+    {
+        Applied.SkeletalGlobalOffset = CharacterAsset->SkeletalGlobalOffset;
+        Applied.SkeletalGlobalScale = CharacterAsset->GlobalScale;
+    }
 
-    USkeletalMeshComponent* TargetComponent = GetSkeletalComponentByTarget(Target);
-    if (!TargetComponent || Socket == NAME_None) return;
-   
-    // Detach from current parent and attach to socket
-    SpriteComp->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
-    SpriteComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepRelativeTransform, Socket);
-   
-    // Apply socket-specific offset if needed
-    if (!bUseSocketTransform)
+    // Один примитив на все слои, если ни один слой не висит на сокете
+    const bool bLayered = bUseLayeredSprites && UCharacter2DLayeredSpriteComponent::CanBatchAsset(CharacterAsset);
+    const bool bModeChanged = !Applied.bValid || bLayered != Applied.bLayeredSprites;
+    if (bModeChanged)
     {
-        const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
-        const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
-        SpriteComp->SetRelativeLocation(LocalOffset + GlobalOffset);
-        SpriteComp->SetRelativeScale3D(FVector(LocalScale * GlobalScale));
+        Mask |= ECharacter2DLayerMask::Sprites | ECharacter2DLayerMask::Flipbooks;
+    }
+    bLayeredSpritesActive = bLayered;
+
+    const bool bApplySprites = EnumHasAnyFlags(Mask, ECharacter2DLayerMask::Sprites);
+    // Сменились состав, порядок или общий трансформ — применяются все слои, иначе только отличающиеся
+    bool bAllLayers = bModeChanged || Applied.SpriteLayers.Num() != Layers.Num()
+        || !IsSameAppliedStruct(Applied.SpriteTransform, CharacterAsset->SpriteTransform);
+    for (int32 Index = 0; !bAllLayers && Index < Layers.Num(); ++Index)
+    {
+        bAllLayers = Applied.SpriteLayers[Index].Id != Layers[Index].Id;
+    }
+
+    // Слои, выражение которых сверяется с компонентами заново
+    if (AppliedExpressionSprites.Num() != Layers.Num())
+    {
+        AppliedExpressionSprites.Init(UnknownExpressionSprite, Layers.Num());
+    }
+    const bool bResetAllExpressions = bApplySprites && (bAllLayers || bLayeredSpritesActive
+        || !IsSameAppliedArray(Applied.ExpressionSets, CharacterAsset->ExpressionSets));
+
+    if (bLayeredSpritesActive)
+    {
+        if (bModeChanged || LayeredSprite->GetCharacterAsset() != CharacterAsset)
+        {
+            SetupLayeredSprites();
+        }
+        else if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::Sprites | ECharacter2DLayerMask::Flipbooks))
+        {
+            LayeredSprite->RefreshLayersFromAsset();
+        }
+    }
+    else
+    {
+        if (bModeChanged)
+        {
+            LayeredSprite->SetCharacterAsset(nullptr);
+        }
+
+        if (bApplySprites)
+        {
+            SyncSpriteLayerComponents();
+            for (int32 Index = 0; Index < Layers.Num(); ++Index)
+            {
+                if (!bAllLayers && IsSameAppliedStruct(Applied.SpriteLayers[Index], Layers[Index]))
+                {
+                    continue;
+                }
+
+                // Сначала к родителю слоя, затем к сокету, если он задан
+                UPaperSpriteComponent* Component = SpriteLayerComponents[Index];
+                Component->AttachToComponent(GetLayerAttachParent(Index), FAttachmentTransformRules::KeepRelativeTransform);
+                SetupSpriteComponent(Component, Layers[Index]);
+                AttachSpriteToSocket(Component, Layers[Index]);
+                AppliedExpressionSprites[Index] = UnknownExpressionSprite;
+            }
+        }
+
+        if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::BlinkFlipbook))
+        {
+            SetupFlipbookComponent(ECharacter2DLayerMask::BlinkFlipbook);
+        }
+        if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::TalkFlipbook))
+        {
+            SetupFlipbookComponent(ECharacter2DLayerMask::TalkFlipbook);
+        }
+    }
+
+    if (bApplySprites)
+    {
+        Applied.SpriteLayers = Layers;
+        Applied.ExpressionSets = CharacterAsset->ExpressionSets;
+    }
+    if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::BlinkFlipbook))
+    {
+        Applied.Blink = CharacterAsset->BlinkSettings;
+        Applied.BlinkLayerId = CharacterAsset->BlinkLayerId;
+    }
+    if (EnumHasAnyFlags(Mask, ECharacter2DLayerMask::TalkFlipbook))
+    {
+        Applied.Talk = CharacterAsset->TalkSettings;
+        Applied.TalkLayerId = CharacterAsset->TalkLayerId;
+    }
+    if (EnumHasAllFlags(Mask, ECharacter2DLayerMask::Sprites | ECharacter2DLayerMask::Flipbooks))
+    {
+        Applied.SpriteTransform = CharacterAsset->SpriteTransform;
+    }
+    Applied.bLayeredSprites = bLayered;
+
+    // Set initial visibility based on dual rendering setting; ручную видимость из игры не трогаем, пока состав ассета тот же
+    const bool bWantSprites = CharacterAsset->bEnableDualRendering || !HasValidSkeletalMeshes();
+    const bool bWantSkeletal = CharacterAsset->bEnableDualRendering || !HasValidSprites();
+    const bool bApplyVisibility = bModeChanged || EnumHasAnyFlags(Mask, ECharacter2DLayerMask::Visibility);
+    if (bApplyVisibility || bWantSprites != Applied.bSpritesVisible)
+    {
+        SetSpritesVisible(bWantSprites);
+    }
+    if (bApplyVisibility || bWantSkeletal != Applied.bSkeletalVisible)
+    {
+        SetSkeletalVisible(bWantSkeletal);
+    }
+    Applied.bSpritesVisible = bWantSprites;
+    Applied.bSkeletalVisible = bWantSkeletal;
+    Applied.bValid = true;
+
+    // В ассете появилась часть с мешем, а скелет уже показан
+    if (bSkeletalVisible && EnumHasAnyFlags(Mask, ECharacter2DLayerMask::Skeletal))
+    {
+        EnsureSkeletalComponents();
+    }
+
+    if (bResetAllExpressions)
+    {
+        AppliedExpressionSprites.Init(UnknownExpressionSprite, Layers.Num());
+    }
+    if (ExpressionIndex >= CharacterAsset->GetNumExpressions())
+    {
+        ExpressionIndex = INDEX_NONE;
+    }
+    ApplyExpressionSprites();
+
+    // Новый Flipbook рта (или спрайт под ним) — разговор перезапускается с ним
+    if (bIsTalking && EnumHasAnyFlags(Mask, ECharacter2DLayerMask::TalkFlipbook | ECharacter2DLayerMask::Sprites))
+    {
+        StartTalking();
+    }
+
+    // CPD по умолчанию нули — без записи материал получил бы чёрный прозрачный персонаж
+    if (UsesPrimitiveDataTint())
+    {
+        WritePrimitiveTint(true, true);
     }
 }
 
-void ACharacter2DActor::AttachSpriteToSocketFromStruct(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteArmsStructure& ArmsStruct)
+void ACharacter2DActor::PreloadAsync(FOnCharacter2DAssetLoaded OnLoaded)
 {
-    if (!SpriteComp || !CharacterAsset) return;
+    if (!CharacterAsset)
+    {
+        OnLoaded.ExecuteIfBound();
+        return;
+    }
 
-    ECharacter2DAttachmentTarget Target = ArmsStruct.AttachmentTarget;
-    FName Socket = ArmsStruct.SocketName;
-    bool bUseSocketTransform = ArmsStruct.bUseSocketTransform;
-    FVector LocalOffset = ArmsStruct.Offset;
-    float LocalScale = ArmsStruct.Scale;
+    const FName Bundles[] = { GetSpriteBundle(), UCharacter2DAsset::SkeletalBundle };
+    CharacterAsset->RequestLoad(Bundles, FStreamableDelegate::CreateWeakLambda(this, [this, OnLoaded]()
+    {
+        RefreshFromAsset();
+        OnLoaded.ExecuteIfBound();
+    }));
+}
 
-    if (Target == ECharacter2DAttachmentTarget::None) return;
+FName ACharacter2DActor::GetSpriteBundle() const
+{
+    // Слои из атласа рисуются без своих спрайтов — их исходные текстуры не грузятся
+    const bool bSpriteAtlas = bUseLayeredSprites
+        && UCharacter2DLayeredSpriteComponent::CanBatchAsset(CharacterAsset)
+        && CharacterAsset->SpriteAtlas.IsValid();
+    return bSpriteAtlas ? UCharacter2DAsset::SpriteAtlasBundle : UCharacter2DAsset::SpriteBundle;
+}
 
-    USkeletalMeshComponent* TargetComponent = GetSkeletalComponentByTarget(Target);
-    if (!TargetComponent || Socket == NAME_None) return;
-   
-    // Detach from current parent and attach to socket
-    SpriteComp->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
-    SpriteComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepRelativeTransform, Socket);
-   
-    // Apply socket-specific offset if needed
-    if (!bUseSocketTransform)
+UPaperFlipbook* ACharacter2DActor::GetLoadedFlipbook(const TSoftObjectPtr<UPaperFlipbook>& Flipbook)
+{
+    UPaperFlipbook* Loaded = Flipbook.Get();
+    if (Loaded || Flipbook.IsNull() || !CharacterAsset || bSpriteBundleLoadPending)
     {
-        const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
-        const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
-        SpriteComp->SetRelativeLocation(LocalOffset + GlobalOffset);
-        SpriteComp->SetRelativeScale3D(FVector(LocalScale * GlobalScale));
+        return Loaded;
+    }
+
+    // Бандл не предзагружен (PreloadAsync): грузим его в фоне, а это моргание/разговор пропускаем
+    bSpriteBundleLoadPending = true;
+    const FName Bundles[] = { GetSpriteBundle() };
+    CharacterAsset->RequestLoad(Bundles, FStreamableDelegate::CreateWeakLambda(this, [this]()
+    {
+        bSpriteBundleLoadPending = false;
+
+        // Разговор включён, но не начался из-за незагруженного Flipbook; моргание само ждёт следующего раза
+        if (CharacterAsset && CharacterAsset->GetTalkSettings().TalkFlipbook.Get()
+            && bTalkingActive && bSpritesVisible && !bIsTalking)
+        {
+            StartTalking();
+        }
+    }));
+    return nullptr;
+}
+
+void ACharacter2DActor::SetupLayeredSprites()
+{
+    ClearSpriteComponents();
+    LayeredSprite->SetCharacterAsset(CharacterAsset);
+    LayeredSprite->SetVisibility(bSpritesVisible);
+}
+
+void ACharacter2DActor::SyncSpriteLayerComponents()
+{
+    const int32 NumLayers = CharacterAsset ? CharacterAsset->SpriteLayers.Num() : 0;
+
+    // Слои убраны из ассета — их компоненты больше не нужны
+    while (SpriteLayerComponents.Num() > NumLayers)
+    {
+        OriginalSpriteColors.Pop();
+        if (UPaperSpriteComponent* Component = SpriteLayerComponents.Pop())
+        {
+            Component->DestroyComponent();
+        }
+    }
+
+    SpriteLayerComponents.Reserve(NumLayers);
+    while (SpriteLayerComponents.Num() < NumLayers)
+    {
+        UPaperSpriteComponent* Component = CreateCharacterComponent<UPaperSpriteComponent>(this, TEXT("SpriteLayer"), RootComponent);
+        Component->SetCastShadow(false);
+        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        SpriteLayerComponents.Add(Component);
+        OriginalSpriteColors.Add(FLinearColor::White);
+    }
+}
+
+void ACharacter2DActor::ClearSpriteComponents()
+{
+    // Пока слои рисует LayeredSprite, отдельных компонентов слоёв нет вовсе
+    for (UPaperSpriteComponent* Component : SpriteLayerComponents)
+    {
+        if (Component)
+        {
+            Component->DestroyComponent();
+        }
+    }
+    SpriteLayerComponents.Reset();
+    OriginalSpriteColors.Reset();
+
+    // Моргание и разговор LayeredSprite проигрывает сам; Flipbook отпускается вместе с регистрацией
+    for (UPaperFlipbookComponent* Flipbook : { EyelidComponent.Get(), MouthComponent.Get() })
+    {
+        if (Flipbook && Flipbook->IsRegistered())
+        {
+            Flipbook->Stop();
+            Flipbook->SetFlipbook(nullptr);
+            Flipbook->SetVisibility(false);
+            UnregisterDeferredComponent(Flipbook);
+        }
+    }
+}
+
+/* ====================================================================== */
+/*                            Lazy Components                             */
+/* ====================================================================== */
+
+USkeletalMeshComponent* ACharacter2DActor::GetOrRegisterSkeletalComponent(ECharacter2DAttachmentTarget Target)
+{
+    USkeletalMeshComponent* Component = nullptr;
+    const FCharacter2DSkeletalPart* Part = nullptr;
+    switch (Target)
+    {
+    case ECharacter2DAttachmentTarget::Body: Component = BodyComponent; Part = CharacterAsset ? &CharacterAsset->Body : nullptr; break;
+    case ECharacter2DAttachmentTarget::Arms: Component = ArmsComponent; Part = CharacterAsset ? &CharacterAsset->Arms : nullptr; break;
+    case ECharacter2DAttachmentTarget::Head: Component = HeadComponent; Part = CharacterAsset ? &CharacterAsset->Head : nullptr; break;
+    default:                                 return nullptr;
+    }
+
+    if (RegisterDeferredComponent(Component))
+    {
+        if (Part)
+        {
+            SetupSkeletalComponent(Component, *Part);
+        }
+
+        // Значимость и tint могли выставить до регистрации компонента
+        UpdateSkeletalTick(Component);
+        if (UsesPrimitiveDataTint())
+        {
+            Character2DPrimitiveData::WriteTint(Component, FLinearColor(1.0f, 1.0f, 1.0f, PrimitiveSkeletalOpacity));
+        }
+    }
+    return Component;
+}
+
+void ACharacter2DActor::EnsureSkeletalComponents()
+{
+    if (!CharacterAsset)
+    {
+        return;
+    }
+
+    // Части без меша ничего не рисуют — регистрировать их незачем
+    if (!CharacterAsset->Body.Mesh.IsNull()) GetOrRegisterSkeletalComponent(ECharacter2DAttachmentTarget::Body);
+    if (!CharacterAsset->Arms.Mesh.IsNull()) GetOrRegisterSkeletalComponent(ECharacter2DAttachmentTarget::Arms);
+    if (!CharacterAsset->Head.Mesh.IsNull()) GetOrRegisterSkeletalComponent(ECharacter2DAttachmentTarget::Head);
+}
+
+void ACharacter2DActor::UpdateSkeletalTick(USkeletalMeshComponent* Component) const
+{
+    // Скрытый меш нужен только как опора для слоёв на его сокетах
+    const bool bNeeded = bSkeletalVisible || Component->GetNumChildrenComponents() > 0;
+    Component->SetComponentTickEnabled(bNeeded && SignificanceTier == ECharacter2DSignificanceTier::Full);
+}
+
+UPaperFlipbookComponent* ACharacter2DActor::GetOrRegisterFlipbookComponent(ECharacter2DLayerMask Flipbook)
+{
+    UPaperFlipbookComponent* Component = Flipbook == ECharacter2DLayerMask::TalkFlipbook ? MouthComponent : EyelidComponent;
+    if (RegisterDeferredComponent(Component))
+    {
+        SetupFlipbookComponent(Flipbook);
+
+        // Значимость и tint могли выставить до регистрации компонента
+        Component->SetComponentTickInterval(SignificanceTier == ECharacter2DSignificanceTier::Reduced
+            ? UCharacter2DSignificanceSubsystem::GetReducedFlipbookTickInterval() : 0.0f);
+        Component->SetComponentTickEnabled(SignificanceTier != ECharacter2DSignificanceTier::Dormant);
+        if (UsesPrimitiveDataTint())
+        {
+            Character2DPrimitiveData::WriteTint(Component, PrimitiveSpriteTint);
+        }
+    }
+    return Component;
+}
+
+void ACharacter2DActor::SetupFlipbookComponent(ECharacter2DLayerMask Flipbook)
+{
+    const bool bTalk = Flipbook == ECharacter2DLayerMask::TalkFlipbook;
+    UPaperFlipbookComponent* Component = bTalk ? MouthComponent : EyelidComponent;
+    if (!Component || !Component->IsRegistered() || !CharacterAsset)
+    {
+        return;
+    }
+
+    const FCharacter2DBlinkSettings& BlinkSettings = CharacterAsset->GetBlinkSettings();
+    const FCharacter2DTalkSettings& TalkSettings = CharacterAsset->GetTalkSettings();
+    // Не загруженный ещё Flipbook подставят HandleBlink/StartTalking при показе
+    Component->SetFlipbook(bTalk ? TalkSettings.TalkFlipbook.Get() : BlinkSettings.BlinkFlipbook.Get());
+    Component->SetVisibility(false);
+
+    // Без своего сокета Flipbook стоит там же, где родитель подменяемого слоя
+    const int32 LayerIndex = CharacterAsset->FindSpriteLayerIndex(bTalk ? CharacterAsset->TalkLayerId : CharacterAsset->BlinkLayerId);
+    Component->AttachToComponent(GetLayerAttachParent(LayerIndex), FAttachmentTransformRules::KeepRelativeTransform);
+    Component->SetRelativeTransform(FTransform::Identity);
+    if (bTalk)
+    {
+        AttachFlipbookToSocket(Component, TalkSettings.AttachmentTarget, TalkSettings.SocketName,
+            TalkSettings.bUseSocketTransform, TalkSettings.Offset, TalkSettings.Scale);
+    }
+    else
+    {
+        AttachFlipbookToSocket(Component, BlinkSettings.AttachmentTarget, BlinkSettings.SocketName,
+            BlinkSettings.bUseSocketTransform, BlinkSettings.Offset, BlinkSettings.Scale);
     }
 }
 
@@ -238,57 +666,33 @@ void ACharacter2DActor::MoveToLocation(const FVector& TargetLocation, float Dura
 
 void ACharacter2DActor::MoveToLocationWithSettings(const FVector& TargetLocation, const FCharacter2DMovementSettings& Settings)
 {
-    if (Settings.bTeleport || Settings.Duration <= 0.0f)
+    CHARACTER2D_TRACE_COMMAND("MoveTo", this);
+    UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this);
+    if (Settings.bTeleport || Settings.Duration <= 0.0f || !Animation)
     {
+        if (bIsMoving && Animation)
+        {
+            Animation->StopMovement(this);
+        }
+        bIsMoving = false;
         SetActorLocation(TargetLocation);
         return;
     }
 
-    if (bIsMoving)
+    if (!Animation->StartMovement(this, GetActorLocation(), TargetLocation, Settings))
     {
-        MovementTimeline->Stop();
+        bIsMoving = false;
+        SetActorLocation(TargetLocation);
+        return;
     }
 
     bIsMoving = true;
-    MovementStartLocation = GetActorLocation();
     MovementTargetLocation = TargetLocation;
-    CurrentMovementSettings = Settings;
-
-    // Setup timeline
-    MovementTimeline->Stop();
-    MovementTimeline->SetPlaybackPosition(0.0f, false);
-
-    // Create curve if none provided
-    UCurveFloat* CurveToUse = Settings.AnimationCurve;
-    if (!CurveToUse)
-    {
-        CurveToUse = NewObject<UCurveFloat>(this);
-        CurveToUse->FloatCurve.AddKey(0.0f, 0.0f);
-        CurveToUse->FloatCurve.AddKey(1.0f, 1.0f);
-    }
-
-    FOnTimelineFloat TimelineProgress;
-    TimelineProgress.BindUFunction(this, FName("OnMovementTimelineUpdate"));
-    MovementTimeline->AddInterpFloat(CurveToUse, TimelineProgress);
-
-    FOnTimelineEvent TimelineFinish;
-    TimelineFinish.BindUFunction(this, FName("OnMovementTimelineFinished"));
-    MovementTimeline->SetTimelineFinishedFunc(TimelineFinish);
-
-    MovementTimeline->SetTimelineLength(Settings.Duration);
-    MovementTimeline->Play();
 }
 
-void ACharacter2DActor::OnMovementTimelineUpdate(float Value)
-{
-    FVector NewLocation = FMath::Lerp(MovementStartLocation, MovementTargetLocation, Value);
-    SetActorLocation(NewLocation);
-}
-
-void ACharacter2DActor::OnMovementTimelineFinished()
+void ACharacter2DActor::OnMovementFinished()
 {
     bIsMoving = false;
-    SetActorLocation(MovementTargetLocation);
 }
 
 /* ====================================================================== */
@@ -297,101 +701,62 @@ void ACharacter2DActor::OnMovementTimelineFinished()
 
 void ACharacter2DActor::PlayFadeIn(float Duration)
 {
-    if (bIsFading)
-    {
-        FadeTimeline->Stop();
-    }
-
+    CHARACTER2D_TRACE_COMMAND("FadeIn", this);
     bIsFading = true;
+    ReleaseImpostor();
     
     // Start invisible
     SetAllSpritesOpacity(0.0f);
     SetAllSkeletalOpacity(0.0f);
     SetActorHiddenInGame(false);
 
-    // Setup timeline
-    FadeTimeline->Stop();
-    FadeTimeline->SetPlaybackPosition(0.0f, false);
-
-    UCurveFloat* FadeCurve = nullptr;
-    if (CharacterAsset)
-    {
-        FadeCurve = CharacterAsset->VisualNovelSettings.DefaultFadeCurve;
-    }
-    
-    if (!FadeCurve)
+    if (!StartFade(true, Duration))
     {
-        FadeCurve = NewObject<UCurveFloat>(this);
-        FadeCurve->FloatCurve.AddKey(0.0f, 0.0f);
-        FadeCurve->FloatCurve.AddKey(1.0f, 1.0f);
+        SetAllSpritesOpacity(1.0f);
+        SetAllSkeletalOpacity(1.0f);
+        OnFadeFinished(true);
     }
-
-    FOnTimelineFloat TimelineProgress;
-    TimelineProgress.BindUFunction(this, FName("OnFadeTimelineUpdate"));
-    FadeTimeline->AddInterpFloat(FadeCurve, TimelineProgress);
-
-    FOnTimelineEvent TimelineFinish;
-    TimelineFinish.BindUFunction(this, FName("OnFadeTimelineFinished"));
-    FadeTimeline->SetTimelineFinishedFunc(TimelineFinish);
-
-    FadeTimeline->SetTimelineLength(Duration);
-    FadeTimeline->Play();
 }
 
 void ACharacter2DActor::PlayFadeOut(float Duration)
 {
-    if (bIsFading)
-    {
-        FadeTimeline->Stop();
-    }
-
+    CHARACTER2D_TRACE_COMMAND("FadeOut", this);
     bIsFading = true;
-    
-    // Setup timeline
-    FadeTimeline->Stop();
-    FadeTimeline->SetPlaybackPosition(0.0f, false);
+    // Скелетные меши гаснут отдельно от спрайтов — импостор на время fade не годится
+    ReleaseImpostor();
 
-    UCurveFloat* FadeCurve = nullptr;
-    if (CharacterAsset)
-    {
-        FadeCurve = CharacterAsset->VisualNovelSettings.DefaultFadeCurve;
-    }
-    
-    if (!FadeCurve)
+    // Кривая fade-in проигрывается в обратную сторону
+    if (!StartFade(false, Duration))
     {
-        FadeCurve = NewObject<UCurveFloat>(this);
-        FadeCurve->FloatCurve.AddKey(0.0f, 1.0f);
-        FadeCurve->FloatCurve.AddKey(1.0f, 0.0f);
+        SetAllSpritesOpacity(0.0f);
+        SetAllSkeletalOpacity(0.0f);
+        OnFadeFinished(false);
     }
-
-    FOnTimelineFloat TimelineProgress;
-    TimelineProgress.BindUFunction(this, FName("OnFadeTimelineUpdate"));
-    FadeTimeline->AddInterpFloat(FadeCurve, TimelineProgress);
-
-    FOnTimelineEvent TimelineFinish;
-    TimelineFinish.BindUFunction(this, FName("OnFadeTimelineFinished"));
-    FadeTimeline->SetTimelineFinishedFunc(TimelineFinish);
-
-    FadeTimeline->SetTimelineLength(Duration);
-    FadeTimeline->Reverse();
-    FadeTimeline->Play();
 }
 
-void ACharacter2DActor::OnFadeTimelineUpdate(float Value)
+bool ACharacter2DActor::StartFade(bool bFadeIn, float Duration)
 {
-    SetAllSpritesOpacity(Value);
-    SetAllSkeletalOpacity(Value);
+    UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this);
+    if (!Animation || Duration <= 0.0f)
+    {
+        return false;
+    }
+
+    const ECharacter2DEasing Easing = CharacterAsset ? CharacterAsset->VisualNovelSettings.DefaultFadeEasing : ECharacter2DEasing::Linear;
+    const UCurveFloat* FadeCurve = CharacterAsset ? CharacterAsset->VisualNovelSettings.DefaultFadeCurve.Get() : nullptr;
+    return Animation->StartFade(this, bFadeIn, Duration, Easing, FadeCurve);
 }
 
-void ACharacter2DActor::OnFadeTimelineFinished()
+void ACharacter2DActor::OnFadeFinished(bool bFadeIn)
 {
     bIsFading = false;
     
     // Check if we faded out completely
-    if (FadeTimeline->GetPlaybackPosition() <= 0.01f)
+    if (!bFadeIn)
     {
         SetActorHiddenInGame(true);
     }
+    RequestImpostor();
 }
 
 /* ====================================================================== */
@@ -400,6 +765,7 @@ void ACharacter2DActor::OnFadeTimelineFinished()
 
 void ACharacter2DActor::PlayEmotion(ECharacter2DEmotionEffect EmotionType, const FCharacter2DEmotionSettings& Settings)
 {
+    CHARACTER2D_TRACE_COMMAND("PlayEmotion", this);
     if (bIsPlayingEmotion)
     {
         StopCurrentEmotion();
@@ -410,62 +776,35 @@ void ACharacter2DActor::PlayEmotion(ECharacter2DEmotionEffect EmotionType, const
         return;
     }
 
-    bIsPlayingEmotion = true;
-    CurrentEmotionType = EmotionType;
-
-    // Stop and reset timeline
-    EmotionTimeline->Stop();
-    EmotionTimeline->SetPlaybackPosition(0.0f, false);
-
-    // Create a default curve if none provided
-    UCurveFloat* CurveToUse = Settings.AnimationCurve;
-    if (!CurveToUse)
-    {
-        CurveToUse = NewObject<UCurveFloat>(this);
-        CurveToUse->FloatCurve.AddKey(0.0f, 0.0f);
-        CurveToUse->FloatCurve.AddKey(0.5f, 1.0f);
-        CurveToUse->FloatCurve.AddKey(1.0f, 0.0f);
-    }
-
-    // Setup timeline
-    FOnTimelineFloat EmotionProgress;
-    EmotionProgress.BindUFunction(this, FName("OnEmotionTimelineUpdate"));
-    EmotionTimeline->AddInterpFloat(CurveToUse, EmotionProgress);
-
-    FOnTimelineEvent EmotionFinish;
-    EmotionFinish.BindUFunction(this, FName("OnEmotionTimelineFinished"));
-    EmotionTimeline->SetTimelineFinishedFunc(EmotionFinish);
-
-    EmotionTimeline->SetTimelineLength(Settings.Duration);
-    EmotionTimeline->SetLooping(Settings.bLoop);
-
-    // Store emotion settings
-    CurrentEmotionSettings = Settings;
-
-    // Execute specific emotion setup
-    switch (EmotionType)
-    {
-    case ECharacter2DEmotionEffect::Shake:
-        ExecuteShakeEmotion(Settings);
-        break;
-    case ECharacter2DEmotionEffect::Pulse:
-        ExecutePulseEmotion(Settings);
-        break;
-    case ECharacter2DEmotionEffect::ColorShift:
-        ExecuteColorShiftEmotion(Settings);
-        break;
-    case ECharacter2DEmotionEffect::Bounce:
-        ExecuteBounceEmotion(Settings);
-        break;
-    case ECharacter2DEmotionEffect::Flash:
-        ExecuteFlashEmotion(Settings);
-        break;
-    default:
-        bIsPlayingEmotion = false;
+    UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this);
+    if (!Animation)
+    {
         return;
     }
 
-    EmotionTimeline->Play();
+    // Эмоция отсчитывается от текущего положения, а не от точки BeginPlay
+    OriginalActorLocation = GetActorLocation();
+    OriginalActorScale = GetActorScale3D();
+
+    // GPU-режим: параметры уходят в материал один раз, game thread больше не трогает актёр
+    const bool bOnGpu = EmotionRenderMode == ECharacter2DEmotionRenderMode::GPU
+        && Character2DPrimitiveData::CanRunEmotionOnGpu(Settings);
+
+    if (Animation->StartEmotion(this, EmotionType, Settings, OriginalActorLocation, OriginalActorScale, bOnGpu))
+    {
+        bIsPlayingEmotion = true;
+        bEmotionOnGpu = bOnGpu;
+        CurrentEmotionType = EmotionType;
+
+        if (bOnGpu)
+        {
+            const float StartTime = GetWorld()->GetTimeSeconds();
+            for (UPrimitiveComponent* Primitive : GetRenderPrimitives())
+            {
+                Character2DPrimitiveData::WriteEmotion(Primitive, EmotionType, Settings, StartTime);
+            }
+        }
+    }
 }
 
 void ACharacter2DActor::PlayEmotionWithDefaults(ECharacter2DEmotionEffect EmotionType)
@@ -484,73 +823,30 @@ void ACharacter2DActor::PlayEmotionWithDefaults(ECharacter2DEmotionEffect Emotio
 
 void ACharacter2DActor::StopCurrentEmotion()
 {
+    CHARACTER2D_TRACE_COMMAND("StopEmotion", this);
     if (!bIsPlayingEmotion) return;
 
-    if (EmotionTimeline)
+    if (UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this))
+    {
+        Animation->StopEmotion(this);
+    }
+    if (bEmotionOnGpu)
     {
-        EmotionTimeline->Stop();
+        for (UPrimitiveComponent* Primitive : GetRenderPrimitives())
+        {
+            Character2DPrimitiveData::ClearEmotion(Primitive);
+        }
+        bEmotionOnGpu = false;
     }
     RestoreOriginalValues();
     bIsPlayingEmotion = false;
     ECharacter2DEmotionEffect PreviousEmotion = CurrentEmotionType;
     CurrentEmotionType = ECharacter2DEmotionEffect::None;
 
-    OnEmotionFinished.Broadcast(PreviousEmotion);
-}
-
-void ACharacter2DActor::OnEmotionTimelineUpdate(float Value)
-{
-    if (!bIsPlayingEmotion) return;
-
-    const float IntensityMultiplier = CurrentEmotionSettings.Intensity;
-    
-    switch (CurrentEmotionType)
-    {
-    case ECharacter2DEmotionEffect::Shake:
-        {
-            float ShakeAmount = Value * IntensityMultiplier * 10.0f;
-            FVector ShakeOffset = FVector(
-                FMath::FRandRange(-ShakeAmount, ShakeAmount),
-                FMath::FRandRange(-ShakeAmount, ShakeAmount),
-                FMath::FRandRange(-ShakeAmount, ShakeAmount)
-            );
-            SetActorLocation(OriginalActorLocation + ShakeOffset);
-        }
-        break;
-    case ECharacter2DEmotionEffect::Pulse:
-        {
-            float ScaleFactor = 1.0f + (Value * IntensityMultiplier * 0.2f);
-            SetActorScale3D(OriginalActorScale * ScaleFactor);
-        }
-        break;
-    case ECharacter2DEmotionEffect::ColorShift:
-        {
-            FLinearColor CurrentColor = FMath::Lerp(FLinearColor::White, CurrentEmotionSettings.TargetColor, Value * IntensityMultiplier);
-            SetAllSpritesColor(CurrentColor);
-        }
-        break;
-    case ECharacter2DEmotionEffect::Bounce:
-        {
-            float BounceHeight = Value * IntensityMultiplier * 50.0f;
-            FVector BounceOffset = FVector(0, 0, BounceHeight);
-            SetActorLocation(OriginalActorLocation + BounceOffset);
-        }
-        break;
-    case ECharacter2DEmotionEffect::Flash:
-        {
-            float Opacity = Value > 0.5f ? 1.0f : (0.3f + 0.7f * IntensityMultiplier);
-            SetAllSpritesOpacity(Opacity);
-        }
-        break;
-    }
-}
+    // Цвет восстановлен — если запекание откладывалось, можно снимать
+    RequestImpostor();
 
-void ACharacter2DActor::OnEmotionTimelineFinished()
-{
-    if (!EmotionTimeline->IsLooping())
-    {
-        StopCurrentEmotion();
-    }
+    OnEmotionFinished.Broadcast(PreviousEmotion);
 }
 
 /* ====================================================================== */
@@ -559,7 +855,15 @@ void ACharacter2DActor::OnEmotionTimelineFinished()
 
 void ACharacter2DActor::SetSpritesVisible(bool bVisible)
 {
+    CHARACTER2D_TRACE_COMMAND("SetSpritesVisible", this);
     bSpritesVisible = bVisible;
+
+    if (bLayeredSpritesActive)
+    {
+        LayeredSprite->SetVisibility(bVisible);
+        InvalidateImpostor();
+        return;
+    }
     
     TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
     for (UPaperSpriteComponent* Component : SpriteComponents)
@@ -582,16 +886,22 @@ void ACharacter2DActor::SetSpritesVisible(bool bVisible)
 
 void ACharacter2DActor::SetSkeletalVisible(bool bVisible)
 {
+    CHARACTER2D_TRACE_COMMAND("SetSkeletalVisible", this);
     bSkeletalVisible = bVisible;
+
+    // Первый показ скелета у персонажа, который до этого рисовался только спрайтами
+    if (bVisible)
+    {
+        EnsureSkeletalComponents();
+    }
     
     TArray<USkeletalMeshComponent*> SkeletalComponents = GetAllSkeletalComponents();
     for (USkeletalMeshComponent* Component : SkeletalComponents)
     {
-        if (Component)
-        {
-            Component->SetVisibility(bVisible);
-        }
+        Component->SetVisibility(bVisible);
+        UpdateSkeletalTick(Component);
     }
+    InvalidateImpostor();
 }
 
 void ACharacter2DActor::SetBothVisible(bool bSprites, bool bSkeletal)
@@ -608,15 +918,16 @@ void ACharacter2DActor::StoreOriginalValues()
 {
     OriginalActorLocation = GetActorLocation();
     OriginalActorScale = GetActorScale3D();
+    OriginalLayeredSpriteColor = LayeredSprite->GetSpriteColor();
+    OriginalPrimitiveSpriteTint = PrimitiveSpriteTint;
     
-TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
-   for (int32 i = 0; i < SpriteComponents.Num() && i < 7; i++)
-   {
-       if (SpriteComponents[i])
-       {
-           OriginalSpriteColors[i] = SpriteComponents[i]->GetSpriteColor();
-       }
-   }
+    for (int32 Index = 0; Index < SpriteLayerComponents.Num(); ++Index)
+    {
+        if (SpriteLayerComponents[Index])
+        {
+            OriginalSpriteColors[Index] = SpriteLayerComponents[Index]->GetSpriteColor();
+        }
+    }
 }
 
 void ACharacter2DActor::RestoreOriginalValues()
@@ -630,64 +941,105 @@ void ACharacter2DActor::RestoreOriginalValues()
    {
        SetActorScale3D(OriginalActorScale);
    }
+
+   if (UsesPrimitiveDataTint())
+   {
+       PrimitiveSpriteTint = OriginalPrimitiveSpriteTint;
+       WritePrimitiveTint(true, false);
+       return;
+   }
+
+   if (bLayeredSpritesActive)
+   {
+       LayeredSprite->SetSpriteColor(OriginalLayeredSpriteColor);
+       return;
+   }
    
-   TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
-   for (int32 i = 0; i < SpriteComponents.Num() && i < 7; i++)
+   for (int32 Index = 0; Index < SpriteLayerComponents.Num(); ++Index)
    {
-       if (SpriteComponents[i])
+       if (SpriteLayerComponents[Index])
        {
-           SpriteComponents[i]->SetSpriteColor(OriginalSpriteColors[i]);
+           SpriteLayerComponents[Index]->SetSpriteColor(OriginalSpriteColors[Index]);
        }
    }
 }
 
 TArray<UPaperSpriteComponent*> ACharacter2DActor::GetAllSpriteComponents() const
 {
-   return {
-       SpriteBody, SpriteArms, SpriteHead, 
-       SpriteEyebrow, SpriteEyes, SpriteEyelids, SpriteMouth
-   };
+   return TArray<UPaperSpriteComponent*>(SpriteLayerComponents);
 }
 
 TArray<USkeletalMeshComponent*> ACharacter2DActor::GetAllSkeletalComponents() const
 {
-   return { BodyComponent, ArmsComponent, HeadComponent };
+   // Только зарегистрированные части
+   TArray<USkeletalMeshComponent*> Components;
+   for (USkeletalMeshComponent* Component : { BodyComponent.Get(), ArmsComponent.Get(), HeadComponent.Get() })
+   {
+       if (Component && Component->IsRegistered())
+       {
+           Components.Add(Component);
+       }
+   }
+   return Components;
+}
+
+ACharacter2DActor::FRenderPrimitiveArray ACharacter2DActor::GetRenderPrimitives() const
+{
+   // Без GetAllSpriteComponents/GetAllSkeletalComponents: их TArray выделяют память
+   FRenderPrimitiveArray Primitives;
+   if (bLayeredSpritesActive)
+   {
+       Primitives.Add(LayeredSprite);
+   }
+   else
+   {
+       for (UPaperSpriteComponent* Component : SpriteLayerComponents)
+       {
+           Primitives.Add(Component);
+       }
+       if (EyelidComponent && EyelidComponent->IsRegistered())
+       {
+           Primitives.Add(EyelidComponent);
+       }
+       if (MouthComponent && MouthComponent->IsRegistered())
+       {
+           Primitives.Add(MouthComponent);
+       }
+   }
+   for (USkeletalMeshComponent* Component : { BodyComponent.Get(), ArmsComponent.Get(), HeadComponent.Get() })
+   {
+       if (Component && Component->IsRegistered())
+       {
+           Primitives.Add(Component);
+       }
+   }
+   return Primitives;
 }
 
-USkeletalMeshComponent* ACharacter2DActor::GetSkeletalComponentByTarget(ECharacter2DAttachmentTarget Target) const
+UPrimitiveComponent* ACharacter2DActor::GetFirstRenderPrimitive() const
 {
-   switch (Target)
+   if (bLayeredSpritesActive)
+   {
+       return LayeredSprite;
+   }
+   if (SpriteLayerComponents.Num() > 0)
    {
-   case ECharacter2DAttachmentTarget::Body:
-       return BodyComponent;
-   case ECharacter2DAttachmentTarget::Arms:
-       return ArmsComponent;
-   case ECharacter2DAttachmentTarget::Head:
-       return HeadComponent;
-   default:
-       return nullptr;
+       return SpriteLayerComponents[0];
    }
+   const FRenderPrimitiveArray Primitives = GetRenderPrimitives();
+   return Primitives.Num() > 0 ? Primitives[0] : nullptr;
 }
 
 bool ACharacter2DActor::HasValidSprites() const
 {
-    if (!CharacterAsset) return false;
-    
-    const auto& SpriteStruct = CharacterAsset->SpriteStructure;
-    return (SpriteStruct.Body.Sprite != nullptr ||
-            SpriteStruct.Arms.Sprite != nullptr ||
-            SpriteStruct.Head.Head.Sprite != nullptr ||
-            SpriteStruct.Head.Eyes.Sprite != nullptr ||
-            SpriteStruct.Head.Eyebrow.Sprite != nullptr ||
-            SpriteStruct.Head.Eyelids.Sprite != nullptr ||
-            SpriteStruct.Head.Mouth.Sprite != nullptr);
+    return CharacterAsset && CharacterAsset->HasValidSpriteConfiguration();
 }
 
 bool ACharacter2DActor::HasValidSkeletalMeshes() const
 {
    if (!CharacterAsset) return false;
    
-   return CharacterAsset->Body.Mesh || CharacterAsset->Arms.Mesh || CharacterAsset->Head.Mesh;
+   return !CharacterAsset->Body.Mesh.IsNull() || !CharacterAsset->Arms.Mesh.IsNull() || !CharacterAsset->Head.Mesh.IsNull();
 }
 
 void ACharacter2DActor::SetupSpriteComponent(UPaperSpriteComponent* Component, const FCharacter2DSpriteLayer& Layer)
@@ -697,231 +1049,660 @@ void ACharacter2DActor::SetupSpriteComponent(UPaperSpriteComponent* Component, c
     const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
     const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
     
-    Component->SetSprite(Layer.Sprite);
+    Component->SetSprite(Layer.Sprite.LoadSynchronous());
     Component->SetRelativeLocation(Layer.Offset + GlobalOffset);
     Component->SetRelativeScale3D(FVector(Layer.Scale * GlobalScale));
     Component->SetVisibility(Layer.bVisible && bSpritesVisible);
 }
 
-void ACharacter2DActor::SetupSkeletalComponent(USkeletalMeshComponent* Component, const FCharacter2DSkeletalPart& Part)
+void ACharacter2DActor::SetupSkeletalComponent(USkeletalMeshComponent* Component, const FCharacter2DSkeletalPart& Part)
+{
+   // Незарегистрированная часть настроится при регистрации — меш до этого не грузится
+   if (!Component || !Component->IsRegistered() || !CharacterAsset) return;
+
+   Component->SetSkeletalMesh(Part.Mesh.LoadSynchronous());
+   Component->SetAnimInstanceClass(Part.AnimInstance.LoadSynchronous());
+   
+   for (const auto& Material : Part.Materials)
+   {
+       Component->SetMaterial(Material.SlotIndex, Material.Material.LoadSynchronous());
+   }
+   
+   const FVector GlobalOffset = CharacterAsset->SkeletalGlobalOffset;
+   const float GlobalScale = CharacterAsset->GlobalScale;
+   
+   Component->SetRelativeLocation(Part.Offset + GlobalOffset);
+   Component->SetRelativeScale3D(FVector(Part.Scale * GlobalScale));
+   Component->SetVisibility(!Part.Mesh.IsNull() && bSkeletalVisible);
+}
+
+void ACharacter2DActor::AttachSpriteToSocket(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteLayer& Layer)
+{
+    if (!SpriteComp || !CharacterAsset) return;
+
+    // Слой без своего сокета уже прикреплён к родителю и следует за его сокетом
+    const ECharacter2DAttachmentTarget Target = Layer.AttachmentTarget;
+    const FName Socket = Layer.SocketName;
+    const bool bUseSocketTransform = Layer.bUseSocketTransform;
+    const FVector LocalOffset = Layer.Offset;
+    const float LocalScale = Layer.Scale;
+
+    if (Target == ECharacter2DAttachmentTarget::None) return;
+
+    // Сокету нужен меш части, даже если скелет скрыт
+    USkeletalMeshComponent* TargetComponent = Socket != NAME_None ? GetOrRegisterSkeletalComponent(Target) : nullptr;
+    if (!TargetComponent) return;
+   
+    // Detach from current parent and attach to socket
+    SpriteComp->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+    SpriteComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepRelativeTransform, Socket);
+    UpdateSkeletalTick(TargetComponent);
+   
+    // Apply socket-specific offset if needed
+    if (!bUseSocketTransform)
+    {
+        const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
+        const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
+        SpriteComp->SetRelativeLocation(LocalOffset + GlobalOffset);
+        SpriteComp->SetRelativeScale3D(FVector(LocalScale * GlobalScale));
+    }
+}
+
+void ACharacter2DActor::AttachFlipbookToSocket(UPaperFlipbookComponent* FlipbookComp,
+    ECharacter2DAttachmentTarget Target, FName Socket, bool bUseSocketTransform,
+    const FVector& LocalOffset, float LocalScale)
+{
+    if (!FlipbookComp || !CharacterAsset)
+        return;
+
+    // Без своего сокета Flipbook остаётся у родителя слоя (ApplyAssetState)
+    if (Target == ECharacter2DAttachmentTarget::None)
+        return;
+
+    USkeletalMeshComponent* TargetComponent = Socket != NAME_None ? GetOrRegisterSkeletalComponent(Target) : nullptr;
+    if (!TargetComponent)
+        return;
+
+    FlipbookComp->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+    FlipbookComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepRelativeTransform, Socket);
+    UpdateSkeletalTick(TargetComponent);
+
+    if (!bUseSocketTransform)
+    {
+        const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
+        const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
+        FlipbookComp->SetRelativeLocation(LocalOffset + GlobalOffset);
+        FlipbookComp->SetRelativeScale3D(FVector(LocalScale * GlobalScale));
+    }
+}
+
+
+void ACharacter2DActor::SetAllSpritesOpacity(float Opacity)
+{
+   CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_SetSpritesOpacity);
+
+   if (UsesPrimitiveDataTint())
+   {
+       PrimitiveSpriteTint.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
+       WritePrimitiveTint(true, false);
+       return;
+   }
+
+   if (bLayeredSpritesActive)
+   {
+       FLinearColor LayeredColor = LayeredSprite->GetSpriteColor();
+       LayeredColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
+       LayeredSprite->SetSpriteColor(LayeredColor);
+       INC_DWORD_STAT(STAT_Character2D_ComponentsUpdated);
+       return;
+   }
+
+   TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
+   INC_DWORD_STAT_BY(STAT_Character2D_ComponentsUpdated, SpriteComponents.Num());
+   for (UPaperSpriteComponent* Component : SpriteComponents)
+   {
+       if (Component)
+       {
+           FLinearColor CurrentColor = Component->GetSpriteColor();
+           CurrentColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
+           Component->SetSpriteColor(CurrentColor);
+       }
+   }
+   
+   if (EyelidComponent && bIsBlinking)
+   {
+       FLinearColor EyelidColor = EyelidComponent->GetSpriteColor();
+       EyelidColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
+       EyelidComponent->SetSpriteColor(EyelidColor);
+   }
+   
+   if (MouthComponent && bIsTalking)
+   {
+       FLinearColor MouthColor = MouthComponent->GetSpriteColor();
+       MouthColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
+       MouthComponent->SetSpriteColor(MouthColor);
+   }
+}
+
+void ACharacter2DActor::SetAllSpritesColor(const FLinearColor& Color)
+{
+   CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_SetSpritesColor);
+
+   if (UsesPrimitiveDataTint())
+   {
+       const float Alpha = PrimitiveSpriteTint.A; // Preserve opacity
+       PrimitiveSpriteTint = Color;
+       PrimitiveSpriteTint.A = Alpha;
+       WritePrimitiveTint(true, false);
+       return;
+   }
+
+   if (bLayeredSpritesActive)
+   {
+       FLinearColor LayeredColor = Color;
+       LayeredColor.A = LayeredSprite->GetSpriteColor().A; // Preserve opacity
+       LayeredSprite->SetSpriteColor(LayeredColor);
+       INC_DWORD_STAT(STAT_Character2D_ComponentsUpdated);
+       return;
+   }
+
+   TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
+   INC_DWORD_STAT_BY(STAT_Character2D_ComponentsUpdated, SpriteComponents.Num());
+   for (UPaperSpriteComponent* Component : SpriteComponents)
+   {
+       if (Component)
+       {
+           FLinearColor NewColor = Color;
+           NewColor.A = Component->GetSpriteColor().A; // Preserve opacity
+           Component->SetSpriteColor(NewColor);
+       }
+   }
+   
+   if (EyelidComponent && bIsBlinking)
+   {
+       FLinearColor NewColor = Color;
+       NewColor.A = EyelidComponent->GetSpriteColor().A;
+       EyelidComponent->SetSpriteColor(NewColor);
+   }
+   
+   if (MouthComponent && bIsTalking)
+   {
+       FLinearColor NewColor = Color;
+       NewColor.A = MouthComponent->GetSpriteColor().A;
+       MouthComponent->SetSpriteColor(NewColor);
+   }
+}
+
+void ACharacter2DActor::SetAllSkeletalOpacity(float Opacity)
+{
+   CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_SetSkeletalOpacity);
+
+   if (UsesPrimitiveDataTint())
+   {
+       // Настоящий fade в материале; скрываем только полностью прозрачные меши
+       PrimitiveSkeletalOpacity = FMath::Clamp(Opacity, 0.0f, 1.0f);
+       WritePrimitiveTint(false, true);
+       for (USkeletalMeshComponent* Component : GetAllSkeletalComponents())
+       {
+           if (Component)
+           {
+               Component->SetVisibility(bSkeletalVisible && PrimitiveSkeletalOpacity > 0.0f);
+           }
+       }
+       return;
+   }
+
+   // Без CPD у скелетных мешей нет прозрачности — только видимость
+   TArray<USkeletalMeshComponent*> SkeletalComponents = GetAllSkeletalComponents();
+   INC_DWORD_STAT_BY(STAT_Character2D_ComponentsUpdated, SkeletalComponents.Num());
+   for (USkeletalMeshComponent* Component : SkeletalComponents)
+   {
+       if (Component)
+       {
+           bool bShouldBeVisible = (Opacity > 0.1f) && bSkeletalVisible;
+           Component->SetVisibility(bShouldBeVisible);
+       }
+   }
+}
+
+float ACharacter2DActor::GetSpritesOpacity() const
+{
+   if (UsesPrimitiveDataTint())
+   {
+       return PrimitiveSpriteTint.A;
+   }
+
+   if (bLayeredSpritesActive)
+   {
+       return LayeredSprite->GetSpriteColor().A;
+   }
+
+   for (UPaperSpriteComponent* Component : GetAllSpriteComponents())
+   {
+       if (Component)
+       {
+           return Component->GetSpriteColor().A;
+       }
+   }
+   return 1.0f;
+}
+
+void ACharacter2DActor::WritePrimitiveTint(bool bSprites, bool bSkeletal)
+{
+   if (bSprites)
+   {
+       if (bLayeredSpritesActive)
+       {
+           Character2DPrimitiveData::WriteTint(LayeredSprite, PrimitiveSpriteTint);
+           INC_DWORD_STAT(STAT_Character2D_ComponentsUpdated);
+       }
+       else
+       {
+           const TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
+           INC_DWORD_STAT_BY(STAT_Character2D_ComponentsUpdated, SpriteComponents.Num());
+           for (UPaperSpriteComponent* Component : SpriteComponents)
+           {
+               Character2DPrimitiveData::WriteTint(Component, PrimitiveSpriteTint);
+           }
+           Character2DPrimitiveData::WriteTint(EyelidComponent, PrimitiveSpriteTint);
+           Character2DPrimitiveData::WriteTint(MouthComponent, PrimitiveSpriteTint);
+       }
+   }
+
+   if (bSkeletal)
+   {
+       const FLinearColor SkeletalTint(1.0f, 1.0f, 1.0f, PrimitiveSkeletalOpacity);
+       const TArray<USkeletalMeshComponent*> SkeletalComponents = GetAllSkeletalComponents();
+       INC_DWORD_STAT_BY(STAT_Character2D_ComponentsUpdated, SkeletalComponents.Num());
+       for (USkeletalMeshComponent* Component : SkeletalComponents)
+       {
+           Character2DPrimitiveData::WriteTint(Component, SkeletalTint);
+       }
+   }
+}
+
+void ACharacter2DActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-   if (!Component || !CharacterAsset) return;
+   Super::EndPlay(EndPlayReason);
+   StopCharacterRuntime();
+}
 
-   Component->SetSkeletalMesh(Part.Mesh);
-   Component->SetAnimInstanceClass(Part.AnimInstance);
-   
-   for (const auto& Material : Part.Materials)
+void ACharacter2DActor::StopCharacterRuntime()
+{
+   // EndPlay актёра, уже возвращённого в пул, — рантайм остановлен при возврате
+   if (!bInPool)
    {
-       Component->SetMaterial(Material.SlotIndex, Material.Material);
+       DEC_DWORD_STAT(STAT_Character2D_ActiveCharacters);
    }
-   
-   const FVector GlobalOffset = CharacterAsset->SkeletalGlobalOffset;
-   const float GlobalScale = CharacterAsset->GlobalScale;
-   
-   Component->SetRelativeLocation(Part.Offset + GlobalOffset);
-   Component->SetRelativeScale3D(FVector(Part.Scale * GlobalScale));
-   Component->SetVisibility(Part.Mesh != nullptr && bSkeletalVisible);
-}
 
-void ACharacter2DActor::AttachSpriteToSocket(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteLayer& Layer)
-{
-    if (!SpriteComp || !CharacterAsset) return;
+   // Освобождаем слот анимаций (перемещение, fade, эмоции, моргание)
+   if (UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this))
+   {
+       Animation->Unregister(this);
+   }
+   if (UCharacter2DSignificanceSubsystem* Significance = UCharacter2DSignificanceSubsystem::Get(this))
+   {
+       Significance->Unregister(this);
+   }
 
-    ECharacter2DAttachmentTarget Target = Layer.AttachmentTarget;
-    FName Socket = Layer.SocketName;
-    bool bUseSocketTransform = Layer.bUseSocketTransform;
-    FVector LocalOffset = Layer.Offset;
-    float LocalScale = Layer.Scale;
+   LayeredSprite->OnStaticLayersChanged.RemoveAll(this);
+   ReleaseImpostor();
+   if (UCharacter2DImpostorSubsystem* Impostors = UCharacter2DImpostorSubsystem::Get(this))
+   {
+       Impostors->CancelBake(this);
+   }
+}
 
-    const auto& SpriteStruct = CharacterAsset->SpriteStructure;
+/* ====================================================================== */
+/*                               Expressions                              */
+/* ====================================================================== */
 
-    // If no target specified for facial sprites, inherit head settings
-    const bool bIsFaceSprite = (SpriteComp == SpriteEyebrow || SpriteComp == SpriteEyes || SpriteComp == SpriteEyelids || SpriteComp == SpriteMouth);
-    if (Target == ECharacter2DAttachmentTarget::None && bIsFaceSprite)
+bool ACharacter2DActor::SetExpression(FName Name)
+{
+    if (Name.IsNone())
     {
-        Target = SpriteStruct.Head.Head.AttachmentTarget;
-        Socket = SpriteStruct.Head.Head.SocketName;
-        bUseSocketTransform = SpriteStruct.Head.Head.bUseSocketTransform;
+        return SetExpressionByIndex(INDEX_NONE);
     }
 
-    if (Target == ECharacter2DAttachmentTarget::None) return;
+    const int32 Index = CharacterAsset ? CharacterAsset->FindExpressionIndex(Name) : INDEX_NONE;
+    return Index != INDEX_NONE && SetExpressionByIndex(Index);
+}
 
-    USkeletalMeshComponent* TargetComponent = GetSkeletalComponentByTarget(Target);
-    if (!TargetComponent || Socket == NAME_None) return;
-   
-    // Detach from current parent and attach to socket
-    SpriteComp->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
-    SpriteComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepRelativeTransform, Socket);
-   
-    // Apply socket-specific offset if needed
-    if (!bUseSocketTransform)
+bool ACharacter2DActor::SetExpressionByIndex(int32 Index)
+{
+    CHARACTER2D_TRACE_COMMAND("SetExpression", this);
+    if (Index < INDEX_NONE || (Index != INDEX_NONE && (!CharacterAsset || Index >= CharacterAsset->GetNumExpressions())))
     {
-        const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
-        const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
-        SpriteComp->SetRelativeLocation(LocalOffset + GlobalOffset);
-        SpriteComp->SetRelativeScale3D(FVector(LocalScale * GlobalScale));
+        return false;
     }
+
+    ExpressionIndex = Index;
+    ApplyExpressionSprites();
+    return true;
 }
 
-void ACharacter2DActor::AttachFlipbookToSocket(UPaperFlipbookComponent* FlipbookComp,
-    ECharacter2DAttachmentTarget Target, FName Socket, bool bUseSocketTransform,
-    const FVector& LocalOffset, float LocalScale)
+void ACharacter2DActor::ApplyExpressionSprites()
 {
-    if (!FlipbookComp || !CharacterAsset)
+    if (!CharacterAsset)
+    {
         return;
+    }
 
-    const auto& SpriteStruct = CharacterAsset->SpriteStructure;
-
-    // Fallback to head settings if no explicit target
-    if (Target == ECharacter2DAttachmentTarget::None)
+    // Сравниваются индексы таблицы ассета: без поиска по имени; буферы на стеке для обычного числа слоёв
+    const int32 NumLayers = AppliedExpressionSprites.Num();
+    TArray<int32, TInlineAllocator<16>> SpriteIndices;
+    SpriteIndices.Init(INDEX_NONE, NumLayers);
+    TBitArray<> Changed(false, NumLayers);
+    bool bAnyChanged = false;
+    for (int32 Layer = 0; Layer < NumLayers; ++Layer)
     {
-        Target = SpriteStruct.Head.Head.AttachmentTarget;
-        Socket = SpriteStruct.Head.Head.SocketName;
-        bUseSocketTransform = SpriteStruct.Head.Head.bUseSocketTransform;
+        const int32 SpriteIndex = CharacterAsset->GetExpressionSpriteIndex(ExpressionIndex, Layer);
+        if (SpriteIndex == AppliedExpressionSprites[Layer])
+        {
+            continue;
+        }
+
+        AppliedExpressionSprites[Layer] = static_cast<int16>(SpriteIndex);
+        SpriteIndices[Layer] = SpriteIndex;
+        Changed[Layer] = true;
+        bAnyChanged = true;
     }
 
-    if (Target == ECharacter2DAttachmentTarget::None)
+    if (!bAnyChanged)
+    {
         return;
+    }
 
-    USkeletalMeshComponent* TargetComponent = GetSkeletalComponentByTarget(Target);
-    if (!TargetComponent || Socket == NAME_None)
+    if (bLayeredSpritesActive)
+    {
+        // Один пересчёт вершин на все слои; импостор сбросится через OnStaticLayersChanged.
+        // Передаются пути: спрайты из атласа не загружаются
+        TArray<FSoftObjectPath, TInlineAllocator<16>> SpritePaths;
+        SpritePaths.SetNum(NumLayers);
+        for (TConstSetBitIterator<> It(Changed); It; ++It)
+        {
+            SpritePaths[It.GetIndex()] = CharacterAsset->GetExpressionSpritePath(SpriteIndices[It.GetIndex()]);
+        }
+        LayeredSprite->SetExpressionSprites(Changed, SpritePaths);
         return;
+    }
 
-    FlipbookComp->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
-    FlipbookComp->AttachToComponent(TargetComponent, FAttachmentTransformRules::KeepRelativeTransform, Socket);
+    for (TConstSetBitIterator<> It(Changed); It; ++It)
+    {
+        const int32 Layer = It.GetIndex();
+        if (UPaperSpriteComponent* Component = GetSpriteComponent(Layer))
+        {
+            UPaperSprite* Sprite = CharacterAsset->GetExpressionSprite(SpriteIndices[Layer]);
+            Component->SetSprite(Sprite ? Sprite : CharacterAsset->GetLayerSprite(Layer).LoadSynchronous());
+        }
+    }
+}
 
-    if (!bUseSocketTransform)
+UPaperSprite* ACharacter2DActor::GetLayerDisplaySprite(int32 LayerIndex) const
+{
+    if (!CharacterAsset || !CharacterAsset->SpriteLayers.IsValidIndex(LayerIndex))
     {
-        const FVector GlobalOffset = CharacterAsset->GetGlobalSpriteOffset();
-        const float GlobalScale = CharacterAsset->GetGlobalSpriteScale();
-        FlipbookComp->SetRelativeLocation(LocalOffset + GlobalOffset);
-        FlipbookComp->SetRelativeScale3D(FVector(LocalScale * GlobalScale));
+        return nullptr;
     }
+
+    UPaperSprite* ExpressionSprite = CharacterAsset->GetExpressionSprite(CharacterAsset->GetExpressionSpriteIndex(ExpressionIndex, LayerIndex));
+    return ExpressionSprite ? ExpressionSprite : CharacterAsset->GetLayerSprite(LayerIndex).LoadSynchronous();
 }
 
+UPaperSpriteComponent* ACharacter2DActor::GetSpriteComponent(int32 LayerIndex) const
+{
+    return SpriteLayerComponents.IsValidIndex(LayerIndex) ? SpriteLayerComponents[LayerIndex].Get() : nullptr;
+}
+
+USceneComponent* ACharacter2DActor::GetLayerAttachParent(int32 LayerIndex) const
+{
+    if (CharacterAsset && CharacterAsset->SpriteLayers.IsValidIndex(LayerIndex))
+    {
+        if (UPaperSpriteComponent* Parent = GetSpriteComponent(CharacterAsset->GetSpriteLayerParentIndex(LayerIndex)))
+        {
+            return Parent;
+        }
+    }
+    return RootComponent;
+}
 
 /* ====================================================================== */
-/*                          Emotion Implementations                       */
+/*                                  Pool                                  */
 /* ====================================================================== */
 
-void ACharacter2DActor::ExecuteShakeEmotion(const FCharacter2DEmotionSettings& Settings)
+void ACharacter2DActor::ParkInPool()
+{
+   // Слушатели прошлой сцены получают завершение эмоции и отвязываются
+   StopCurrentEmotion();
+   OnEmotionFinished.Clear();
+
+   EnableBlinking(false);
+   EnableTalking(false);
+   bIsActiveSpeaker = false;
+   SetSignificanceTier(ECharacter2DSignificanceTier::Full);
+
+   // Слот подсистемы анимаций уходит целиком: перемещение, fade, таймер моргания
+   StopCharacterRuntime();
+   bIsMoving = false;
+   bIsFading = false;
+
+   // После fade-out персонаж мог остаться прозрачным
+   SetAllSpritesOpacity(1.0f);
+   SetAllSkeletalOpacity(1.0f);
+
+   // Следующая сцена начинает с лица из ассета
+   SetExpressionByIndex(INDEX_NONE);
+
+   SetActorHiddenInGame(true);
+   SetActorEnableCollision(false);
+   bInPool = true;
+}
+
+void ACharacter2DActor::UnparkFromPool(UCharacter2DAsset* Asset, const FTransform& Transform)
 {
-   // Shake setup is minimal - actual shaking happens in timeline update
+   bInPool = false;
+   SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+   // Перенастраивается только то, чем ассеты различаются
+   if (CharacterAsset != Asset)
+   {
+       CharacterAsset = Asset;
+       ApplyAssetState(DiffAppliedState());
+   }
+
+   SetActorEnableCollision(true);
+   SetActorHiddenInGame(false);
+   StartCharacterRuntime();
 }
 
-void ACharacter2DActor::ExecutePulseEmotion(const FCharacter2DEmotionSettings& Settings)
+/* ====================================================================== */
+/*                             Runtime State                              */
+/* ====================================================================== */
+
+void ACharacter2DActor::SaveRuntimeState(TArray<uint8>& OutData) const
 {
-   // Pulse setup is minimal - actual pulsing happens in timeline update
+   FCharacter2DRuntimeSnapshot Snapshot;
+   Snapshot.Capture(*this);
+
+   OutData.Reset();
+   FMemoryWriter Writer(OutData);
+   Snapshot.Serialize(Writer);
 }
 
-void ACharacter2DActor::ExecuteColorShiftEmotion(const FCharacter2DEmotionSettings& Settings)
+bool ACharacter2DActor::LoadRuntimeState(const TArray<uint8>& Data)
 {
-   // Store target color - actual shifting happens in timeline update
+   CHARACTER2D_TRACE_COMMAND("LoadRuntimeState", this);
+   FCharacter2DRuntimeSnapshot Snapshot;
+   FMemoryReader Reader(Data);
+   if (!Snapshot.Serialize(Reader) || !Snapshot.IsValid())
+   {
+       UE_LOG(LogTemp, Warning, TEXT("Character2D: runtime state for %s is corrupt or from a newer version"), *GetName());
+       return false;
+   }
+
+   Snapshot.Restore(*this);
+   return true;
 }
 
-void ACharacter2DActor::ExecuteBounceEmotion(const FCharacter2DEmotionSettings& Settings)
+/* ====================================================================== */
+/*                                Impostor                                */
+/* ====================================================================== */
+
+void ACharacter2DActor::InvalidateImpostor()
 {
-   // Bounce setup is minimal - actual bouncing happens in timeline update
+   ReleaseImpostor();
+   RequestImpostor();
 }
 
-void ACharacter2DActor::ExecuteFlashEmotion(const FCharacter2DEmotionSettings& Settings)
+void ACharacter2DActor::HandleStaticLayersChanged()
 {
-   // Flash setup is minimal - actual flashing happens in timeline update
+   // LayeredSprite уже рисует слои — осталось вернуть цель и скелетные меши
+   InvalidateImpostor();
 }
 
-void ACharacter2DActor::SetAllSpritesOpacity(float Opacity)
+bool ACharacter2DActor::IsSkeletalAnimated() const
 {
-   TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
-   for (UPaperSpriteComponent* Component : SpriteComponents)
+   for (const USkeletalMeshComponent* Component : GetAllSkeletalComponents())
    {
-       if (Component)
+       if (Component && Component->IsVisible() && Component->GetSkeletalMeshAsset() &&
+           (Component->GetAnimInstance() || Component->IsPlaying()))
        {
-           FLinearColor CurrentColor = Component->GetSpriteColor();
-           CurrentColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
-           Component->SetSpriteColor(CurrentColor);
+           return true;
        }
    }
-   
-   if (EyelidComponent && bIsBlinking)
+   return false;
+}
+
+bool ACharacter2DActor::CanUseImpostor() const
+{
+   // Мигание и разговор в момент снимка попали бы в статичную композицию
+   return bUseImpostor
+       && ImpostorMaterial
+       && UCharacter2DImpostorSubsystem::IsEnabled()
+       && bLayeredSpritesActive
+       && bSpritesVisible
+       && !IsHidden()
+       && !bIsFading
+       && LayeredSprite->GetSpriteColor() == FLinearColor::White
+       && !LayeredSprite->IsAnyLayerFlipbookPlaying()
+       && !IsSkeletalAnimated();
+}
+
+void ACharacter2DActor::GatherImpostorComposition(FBox& OutLocalBox, TArray<UPrimitiveComponent*>& OutComponents) const
+{
+   OutComponents.Add(LayeredSprite);
+   OutLocalBox = LayeredSprite->CalcBounds(FTransform::Identity).GetBox();
+
+   const FTransform WorldToSprite = LayeredSprite->GetComponentTransform().Inverse();
+   for (USkeletalMeshComponent* Component : GetAllSkeletalComponents())
    {
-       FLinearColor EyelidColor = EyelidComponent->GetSpriteColor();
-       EyelidColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
-       EyelidComponent->SetSpriteColor(EyelidColor);
+       if (Component && Component->IsVisible() && Component->GetSkeletalMeshAsset())
+       {
+           OutComponents.Add(Component);
+           OutLocalBox += Component->Bounds.GetBox().TransformBy(WorldToSprite);
+       }
    }
-   
-   if (MouthComponent && bIsTalking)
+}
+
+void ACharacter2DActor::ShowImpostor(UTextureRenderTarget2D* Target, const FBox& LocalBox)
+{
+   ImpostorTarget = Target;
+   LayeredSprite->SetImpostor(Target, ImpostorMaterial, LocalBox);
+
+   // Скелетные части уже в снимке
+   for (USkeletalMeshComponent* Component : GetAllSkeletalComponents())
    {
-       FLinearColor MouthColor = MouthComponent->GetSpriteColor();
-       MouthColor.A = FMath::Clamp(Opacity, 0.0f, 1.0f);
-       MouthComponent->SetSpriteColor(MouthColor);
+       if (Component)
+       {
+           Component->SetVisibility(false);
+       }
    }
 }
 
-void ACharacter2DActor::SetAllSpritesColor(const FLinearColor& Color)
+void ACharacter2DActor::ReleaseImpostor()
 {
-   TArray<UPaperSpriteComponent*> SpriteComponents = GetAllSpriteComponents();
-   for (UPaperSpriteComponent* Component : SpriteComponents)
+   if (!ImpostorTarget)
+   {
+       return;
+   }
+
+   LayeredSprite->ClearImpostor();
+   for (USkeletalMeshComponent* Component : GetAllSkeletalComponents())
    {
        if (Component)
        {
-           FLinearColor NewColor = Color;
-           NewColor.A = Component->GetSpriteColor().A; // Preserve opacity
-           Component->SetSpriteColor(NewColor);
+           Component->SetVisibility(bSkeletalVisible);
        }
    }
-   
-   if (EyelidComponent && bIsBlinking)
+
+   if (UCharacter2DImpostorSubsystem* Impostors = UCharacter2DImpostorSubsystem::Get(this))
    {
-       FLinearColor NewColor = Color;
-       NewColor.A = EyelidComponent->GetSpriteColor().A;
-       EyelidComponent->SetSpriteColor(NewColor);
+       Impostors->ReleaseTarget(ImpostorTarget);
    }
-   
-   if (MouthComponent && bIsTalking)
+   ImpostorTarget = nullptr;
+}
+
+void ACharacter2DActor::RequestImpostor()
+{
+   if (ImpostorTarget || !CanUseImpostor())
    {
-       FLinearColor NewColor = Color;
-       NewColor.A = MouthComponent->GetSpriteColor().A;
-       MouthComponent->SetSpriteColor(NewColor);
+       return;
+   }
+
+   if (UCharacter2DImpostorSubsystem* Impostors = UCharacter2DImpostorSubsystem::Get(this))
+   {
+       Impostors->RequestBake(this);
    }
 }
 
-void ACharacter2DActor::SetAllSkeletalOpacity(float Opacity)
+/* ====================================================================== */
+/*                              Significance                              */
+/* ====================================================================== */
+
+void ACharacter2DActor::SetActiveSpeaker(bool bSpeaker)
 {
-   // For skeletal mesh opacity, we would need to create dynamic material instances
-   // This is a simplified version that uses visibility
-   TArray<USkeletalMeshComponent*> SkeletalComponents = GetAllSkeletalComponents();
-   for (USkeletalMeshComponent* Component : SkeletalComponents)
+   if (bIsActiveSpeaker == bSpeaker) return;
+
+   bIsActiveSpeaker = bSpeaker;
+   if (UCharacter2DSignificanceSubsystem* Significance = UCharacter2DSignificanceSubsystem::Get(this))
    {
-       if (Component)
-       {
-           bool bShouldBeVisible = (Opacity > 0.1f) && bSkeletalVisible;
-           Component->SetVisibility(bShouldBeVisible);
-       }
+       Significance->RequestUpdate();
    }
 }
 
-void ACharacter2DActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+void ACharacter2DActor::SetSignificanceTier(ECharacter2DSignificanceTier Tier)
 {
-   Super::EndPlay(EndPlayReason);
-   
-   // Clear all timers
-   GetWorldTimerManager().ClearTimer(BlinkTimerHandle);
-   GetWorldTimerManager().ClearTimer(BlinkRestoreHandle);
-   
-   // Stop timelines
-   if (MovementTimeline)
+   if (SignificanceTier == Tier) return;
+   SignificanceTier = Tier;
+
+   const bool bDormant = Tier == ECharacter2DSignificanceTier::Dormant;
+   const float FlipbookTickInterval = Tier == ECharacter2DSignificanceTier::Reduced
+       ? UCharacter2DSignificanceSubsystem::GetReducedFlipbookTickInterval() : 0.0f;
+
+   SetActorTickEnabled(!bDormant);
+
+   // Скелетная анимация только на Full
+   for (USkeletalMeshComponent* Component : GetAllSkeletalComponents())
    {
-       MovementTimeline->Stop();
+       UpdateSkeletalTick(Component);
    }
-   
-   if (EmotionTimeline)
+
+   // Flipbook: реже на Reduced, стоп на Dormant; время воспроизведения не сбрасывается
+   for (UActorComponent* Component : { static_cast<UActorComponent*>(EyelidComponent), static_cast<UActorComponent*>(MouthComponent) })
    {
-       EmotionTimeline->Stop();
+       if (Component)
+       {
+           Component->SetComponentTickInterval(FlipbookTickInterval);
+           Component->SetComponentTickEnabled(!bDormant);
+       }
    }
-   
-   if (FadeTimeline)
+   LayeredSprite->SetComponentTickInterval(FlipbookTickInterval);
+   LayeredSprite->SetFlipbooksPaused(bDormant);
+
+   // Таймер моргания замирает с оставшимся временем и продолжает с той же фазы
+   if (UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this))
    {
-       FadeTimeline->Stop();
+       Animation->SetBlinkPaused(this, bDormant);
    }
 }
 
@@ -931,6 +1712,7 @@ void ACharacter2DActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 void ACharacter2DActor::EnableBlinking(bool bEnable)
 {
+   CHARACTER2D_TRACE_COMMAND("EnableBlinking", this);
    bBlinkingActive = bEnable;
    if (bSpritesVisible)
    {
@@ -947,6 +1729,7 @@ void ACharacter2DActor::EnableBlinking(bool bEnable)
 
 void ACharacter2DActor::EnableTalking(bool bEnable)
 {
+   CHARACTER2D_TRACE_COMMAND("EnableTalking", this);
    bTalkingActive = bEnable;
    if (bSpritesVisible)
    {
@@ -959,31 +1742,58 @@ void ACharacter2DActor::EnableTalking(bool bEnable)
            StopTalking();
        }
    }
+
+   // Говорящий поднимается в Full без ожидания планового пересчёта
+   if (UCharacter2DSignificanceSubsystem* Significance = UCharacter2DSignificanceSubsystem::Get(this))
+   {
+       Significance->RequestUpdate();
+   }
+}
+
+void ACharacter2DActor::SetBlinkSeed(int32 Seed)
+{
+   BlinkSeed = Seed;
+   BlinkRandom.Initialize(Seed != 0 ? Seed : static_cast<int32>(GetTypeHash(GetFName())));
 }
 
 void ACharacter2DActor::StartBlinking()
 {
-    if (!IsValid(this) || !IsValid(EyelidComponent) || !CharacterAsset) return;
+    if (!IsValid(this) || !CharacterAsset) return;
 
     bIsBlinking = true;
     const auto& Settings = CharacterAsset->GetBlinkSettings();
-    const float Delay = FMath::FRandRange(Settings.BlinkIntervalMin, Settings.BlinkIntervalMax);
+    float Delay = BlinkRandom.FRandRange(Settings.BlinkIntervalMin, Settings.BlinkIntervalMax);
+    if (SignificanceTier != ECharacter2DSignificanceTier::Full)
+    {
+        Delay *= UCharacter2DSignificanceSubsystem::GetReducedBlinkIntervalScale();
+    }
 
-    GetWorldTimerManager().SetTimer(
-        BlinkTimerHandle, this, &ACharacter2DActor::HandleBlink, Delay, false);
+    if (UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this))
+    {
+        Animation->ScheduleBlink(this, Delay);
+    }
 }
 
 void ACharacter2DActor::StopBlinking()
 {
     bIsBlinking = false;
-    GetWorldTimerManager().ClearTimer(BlinkTimerHandle);
-    GetWorldTimerManager().ClearTimer(BlinkRestoreHandle);
+    if (UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this))
+    {
+        Animation->CancelBlink(this);
+    }
+
+    const int32 BlinkLayer = CharacterAsset ? CharacterAsset->FindSpriteLayerIndex(CharacterAsset->BlinkLayerId) : INDEX_NONE;
+    if (bLayeredSpritesActive)
+    {
+        LayeredSprite->StopLayerFlipbook(BlinkLayer);
+        RequestImpostor();
+        return;
+    }
 
-    if (IsValid(SpriteEyelids))
+    if (UPaperSpriteComponent* Eyelids = GetSpriteComponent(BlinkLayer))
     {
-        const auto& Layer = CharacterAsset->GetEyelidsSprite();
-        SpriteEyelids->SetSprite(Layer.Sprite);
-        SpriteEyelids->SetVisibility(Layer.bVisible && bSpritesVisible);
+        Eyelids->SetSprite(GetLayerDisplaySprite(BlinkLayer));
+        Eyelids->SetVisibility(CharacterAsset->SpriteLayers[BlinkLayer].bVisible && bSpritesVisible);
     }
     if (IsValid(EyelidComponent))
     {
@@ -994,92 +1804,153 @@ void ACharacter2DActor::StopBlinking()
 
 void ACharacter2DActor::HandleBlink()
 {
-    if (!bIsBlinking || !CharacterAsset || !IsValid(EyelidComponent) || !IsValid(SpriteEyelids))
+    CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_HandleBlink);
+
+    // Моргание подменяет слой BlinkLayerId; без такого слоя моргать нечем
+    const int32 BlinkLayer = CharacterAsset ? CharacterAsset->FindSpriteLayerIndex(CharacterAsset->BlinkLayerId) : INDEX_NONE;
+    UPaperSpriteComponent* Eyelids = GetSpriteComponent(BlinkLayer);
+    if (!bIsBlinking || BlinkLayer == INDEX_NONE || (!bLayeredSpritesActive && !Eyelids))
     {
         StopBlinking();
         return;
     }
 
     const auto& Settings = CharacterAsset->GetBlinkSettings();
-    if (!Settings.BlinkFlipbook)
+    if (Settings.BlinkFlipbook.IsNull())
     {
         StopBlinking();
         return;
     }
 
-    // Скрываем статичный спрайт век
-    SpriteEyelids->SetVisibility(false);
-    
-    // Показываем и запускаем анимацию моргания
-    EyelidComponent->SetFlipbook(Settings.BlinkFlipbook);
-    const float Rate = FMath::FRandRange(Settings.BlinkPlayRateMin, Settings.BlinkPlayRateMax);
-    EyelidComponent->SetPlayRate(Rate);
-    EyelidComponent->SetVisibility(bSpritesVisible);
-    EyelidComponent->PlayFromStart();
+    // Ещё грузится — это моргание пропускается, следующее планируется как обычно
+    UPaperFlipbook* BlinkFlipbook = GetLoadedFlipbook(Settings.BlinkFlipbook);
+    if (!BlinkFlipbook)
+    {
+        StartBlinking();
+        return;
+    }
 
-    const float Duration = Settings.BlinkFlipbook->GetTotalDuration() / Rate;
+    const float Rate = BlinkRandom.FRandRange(Settings.BlinkPlayRateMin, Settings.BlinkPlayRateMax);
 
-    // Restore static eyelids after animation
-    FTimerDelegate RestoreDelegate = FTimerDelegate::CreateLambda([this]()
+    if (bLayeredSpritesActive)
     {
-        if (!IsValid(this) || !IsValid(EyelidComponent) || !IsValid(SpriteEyelids) || !CharacterAsset)
-            return;
-
-        // Останавливаем и скрываем анимацию моргания
-        EyelidComponent->Stop();
-        EyelidComponent->SetVisibility(false);
+        // Кадры моргания подменяют слой век внутри LayeredSprite
+        LayeredSprite->PlayLayerFlipbook(BlinkLayer, BlinkFlipbook, Rate, false);
+    }
+    else
+    {
+        // Скрываем статичный спрайт век
+        Eyelids->SetVisibility(false);
         
-        // Восстанавливаем статичный спрайт век
-        const auto& Layer = CharacterAsset->GetEyelidsSprite();
-        SpriteEyelids->SetSprite(Layer.Sprite);
-        SpriteEyelids->SetVisibility(Layer.bVisible && bSpritesVisible);
-
-        // Chance for double blink
-        if (bIsBlinking && FMath::FRand() < 0.25f)
+        // Показываем и запускаем анимацию моргания; цвет (fade, эмоции) как у век
+        if (UPaperFlipbookComponent* Flipbook = GetOrRegisterFlipbookComponent(ECharacter2DLayerMask::BlinkFlipbook))
         {
-            HandleBlink();
-            return;
+            Flipbook->SetSpriteColor(Eyelids->GetSpriteColor());
+            Flipbook->SetFlipbook(BlinkFlipbook);
+            Flipbook->SetPlayRate(Rate);
+            Flipbook->SetVisibility(bSpritesVisible);
+            Flipbook->PlayFromStart();
         }
+    }
+
+    const float Duration = BlinkFlipbook->GetTotalDuration() / Rate;
+
+    // Restore static eyelids after animation
+    if (UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this))
+    {
+        Animation->ScheduleBlinkRestore(this, Duration);
+    }
+}
 
-        // Schedule next blink
-        if (bIsBlinking)
+void ACharacter2DActor::FinishBlink()
+{
+    const int32 BlinkLayer = CharacterAsset ? CharacterAsset->FindSpriteLayerIndex(CharacterAsset->BlinkLayerId) : INDEX_NONE;
+    UPaperSpriteComponent* Eyelids = GetSpriteComponent(BlinkLayer);
+    if (BlinkLayer == INDEX_NONE || (!bLayeredSpritesActive && !Eyelids))
+        return;
+
+    if (bLayeredSpritesActive)
+    {
+        LayeredSprite->StopLayerFlipbook(BlinkLayer);
+        // Между морганиями композиция статична
+        RequestImpostor();
+    }
+    else
+    {
+        // Останавливаем и скрываем анимацию моргания
+        if (IsValid(EyelidComponent))
         {
-            const auto& S = CharacterAsset->GetBlinkSettings();
-            const float NextDelay = FMath::FRandRange(S.BlinkIntervalMin, S.BlinkIntervalMax);
-            GetWorldTimerManager().SetTimer(
-                BlinkTimerHandle, this, &ACharacter2DActor::HandleBlink, NextDelay, false);
+            EyelidComponent->Stop();
+            EyelidComponent->SetVisibility(false);
         }
-    });
+        
+        // Восстанавливаем статичный спрайт век
+        Eyelids->SetSprite(GetLayerDisplaySprite(BlinkLayer));
+        Eyelids->SetVisibility(CharacterAsset->SpriteLayers[BlinkLayer].bVisible && bSpritesVisible);
+    }
+
+    // Chance for double blink
+    if (bIsBlinking && BlinkRandom.FRand() < 0.25f)
+    {
+        HandleBlink();
+        return;
+    }
 
-    GetWorldTimerManager().SetTimer(BlinkRestoreHandle, RestoreDelegate, Duration, false);
+    // Schedule next blink
+    if (bIsBlinking)
+    {
+        StartBlinking();
+    }
 }
 
 void ACharacter2DActor::StartTalking()
 {
-    if (!IsValid(MouthComponent) || !IsValid(SpriteMouth) || !CharacterAsset) return;
+    // Разговор подменяет слой TalkLayerId
+    const int32 TalkLayer = CharacterAsset ? CharacterAsset->FindSpriteLayerIndex(CharacterAsset->TalkLayerId) : INDEX_NONE;
+    UPaperSpriteComponent* Mouth = GetSpriteComponent(TalkLayer);
+    if (TalkLayer == INDEX_NONE || (!bLayeredSpritesActive && !Mouth)) return;
 
-    bIsTalking = true;
+    // Не загруженный Flipbook грузится в фоне, разговор начнётся по окончании загрузки
     const auto& Settings = CharacterAsset->GetTalkSettings();
-    if (!Settings.TalkFlipbook)
+    UPaperFlipbook* TalkFlipbook = GetLoadedFlipbook(Settings.TalkFlipbook);
+    if (!TalkFlipbook)
+    {
+        return;
+    }
+    bIsTalking = true;
+
+    if (bLayeredSpritesActive)
     {
-        bIsTalking = false;
+        LayeredSprite->PlayLayerFlipbook(TalkLayer, TalkFlipbook, Settings.TalkPlayRate, true);
         return;
     }
 
     // Скрываем статичный спрайт рта
-    SpriteMouth->SetVisibility(false);
+    Mouth->SetVisibility(false);
     
-    // Показываем и запускаем анимацию рта
-    MouthComponent->SetFlipbook(Settings.TalkFlipbook);
-    MouthComponent->SetPlayRate(Settings.TalkPlayRate);
-    MouthComponent->SetLooping(true);
-    MouthComponent->SetVisibility(bSpritesVisible);
-    MouthComponent->Play();
+    // Показываем и запускаем анимацию рта; цвет (fade, эмоции) как у рта
+    if (UPaperFlipbookComponent* Flipbook = GetOrRegisterFlipbookComponent(ECharacter2DLayerMask::TalkFlipbook))
+    {
+        Flipbook->SetSpriteColor(Mouth->GetSpriteColor());
+        Flipbook->SetFlipbook(TalkFlipbook);
+        Flipbook->SetPlayRate(Settings.TalkPlayRate);
+        Flipbook->SetLooping(true);
+        Flipbook->SetVisibility(bSpritesVisible);
+        Flipbook->Play();
+    }
 }
 
 void ACharacter2DActor::StopTalking()
 {
     bIsTalking = false;
+
+    const int32 TalkLayer = CharacterAsset ? CharacterAsset->FindSpriteLayerIndex(CharacterAsset->TalkLayerId) : INDEX_NONE;
+    if (bLayeredSpritesActive)
+    {
+        LayeredSprite->StopLayerFlipbook(TalkLayer);
+        RequestImpostor();
+        return;
+    }
     
     // Останавливаем и скрываем анимацию рта
     if (IsValid(MouthComponent))
@@ -1089,10 +1960,9 @@ void ACharacter2DActor::StopTalking()
     }
     
     // Восстанавливаем статичный спрайт рта
-    if (IsValid(SpriteMouth) && CharacterAsset)
+    if (UPaperSpriteComponent* Mouth = GetSpriteComponent(TalkLayer))
     {
-        const auto& Layer = CharacterAsset->GetMouthSprite();
-        SpriteMouth->SetSprite(Layer.Sprite);
-        SpriteMouth->SetVisibility(Layer.bVisible && bSpritesVisible);
+        Mouth->SetSprite(GetLayerDisplaySprite(TalkLayer));
+        Mouth->SetVisibility(CharacterAsset->SpriteLayers[TalkLayer].bVisible && bSpritesVisible);
     }
 }
\ No newline at end of file
@@ -1,66 +1,486 @@
 #include "Character2DAsset.h"
+#include "Character2DCustomVersion.h"
 #include "Engine/World.h"
+#include "Engine/Texture2D.h"
+#include "Engine/AssetManager.h"
+#include "Animation/AnimInstance.h"
 #if WITH_EDITOR
 #include "UObject/AssetRegistryTagsContext.h"
 #endif
 
+void UCharacter2DAsset::Serialize(FArchive& Ar)
+{
+    Ar.UsingCustomVersion(FCharacter2DCustomVersion::GUID);
+    Super::Serialize(Ar);
+}
+
 void UCharacter2DAsset::PostLoad()
 {
     Super::PostLoad();
     
-    // Migration support for legacy assets
-    MigrateLegacyData();
+#if WITH_EDITORONLY_DATA
+    // Миграция только для ассетов старой версии; после пересохранения (Character2DResave) не выполняется
+    const int32 Version = GetLinkerCustomVersion(FCharacter2DCustomVersion::GUID);
+    if (Version < FCharacter2DCustomVersion::LatestVersion)
+    {
+        MigrateLegacyData(Version);
+    }
+#endif
+    EnsureSpriteLayerIds();
+    BuildExpressionTable();
 }
 
-void UCharacter2DAsset::MigrateLegacyData()
+#if WITH_EDITORONLY_DATA
+void UCharacter2DAsset::MigrateLegacyData(int32 Version)
 {
-    // Initialize Visual Novel Settings if they're empty (for legacy assets)
-    if (VisualNovelSettings.DefaultFadeDuration == 0.0f)
+    if (Version < FCharacter2DCustomVersion::LegacySpriteFieldsRemoved)
     {
-        // Set up default values for visual novel settings
-        VisualNovelSettings.DefaultFadeDuration = 1.0f;
-        VisualNovelSettings.DefaultEmotionSettings.Duration = 2.0f;
-        VisualNovelSettings.DefaultEmotionSettings.Intensity = 0.5f;
-        VisualNovelSettings.DefaultMovementSettings.Duration = 1.0f;
+        // Initialize Visual Novel Settings if they're empty (for legacy assets)
+        if (VisualNovelSettings.DefaultFadeDuration == 0.0f)
+        {
+            // Set up default values for visual novel settings
+            VisualNovelSettings.DefaultFadeDuration = 1.0f;
+            VisualNovelSettings.DefaultEmotionSettings.Duration = 2.0f;
+            VisualNovelSettings.DefaultEmotionSettings.Intensity = 0.5f;
+            VisualNovelSettings.DefaultMovementSettings.Duration = 1.0f;
+        }
+
+        // Migrate sprite structure to new format
+        SpriteStructure_DEPRECATED.MigrateFromLegacyStructure();
     }
-    
-    // Migrate sprite structure to new format
-    SpriteStructure.MigrateFromLegacyStructure();
-    
-    // Ensure backwards compatibility for existing sprite configurations
-    bool bHasSprites = HasValidSpriteConfiguration();
-    bool bHasSkeletalMeshes = HasValidSkeletalConfiguration();
-    
-    if (bHasSprites && !bHasSkeletalMeshes)
+
+    if (Version < FCharacter2DCustomVersion::GenericSpriteLayers)
     {
-        bEnableDualRendering = false; // Show only sprites
+        MigrateSpriteLayers();
     }
-    else if (!bHasSprites && bHasSkeletalMeshes)
+
+    if (Version < FCharacter2DCustomVersion::LegacySpriteFieldsRemoved)
     {
-        bEnableDualRendering = false; // Show only skeletal meshes
+        // Ensure backwards compatibility for existing sprite configurations
+        bool bHasSprites = HasValidSpriteConfiguration();
+        bool bHasSkeletalMeshes = HasValidSkeletalConfiguration();
+
+        if (bHasSprites && !bHasSkeletalMeshes)
+        {
+            bEnableDualRendering = false; // Show only sprites
+        }
+        else if (!bHasSprites && bHasSkeletalMeshes)
+        {
+            bEnableDualRendering = false; // Show only skeletal meshes
+        }
+        // If both are configured, leave dual rendering as-is (user preference)
     }
-    // If both are configured, leave dual rendering as-is (user preference)
+}
+
+void UCharacter2DAsset::MigrateSpriteLayers()
+{
+    const FCharacter2DSpriteStructure& Old = SpriteStructure_DEPRECATED;
+    const FCharacter2DSpriteLayer* OldLayers[] =
+    {
+        &Old.Body, &Old.Arms, &Old.Head.Head, &Old.Head.Eyebrow, &Old.Head.Eyes, &Old.Head.Eyelids, &Old.Head.Mouth
+    };
+    constexpr int32 NumOldLayers = static_cast<int32>(ECharacter2DSpriteLayer::Count);
+    static_assert(UE_ARRAY_COUNT(OldLayers) == NumOldLayers, "Old layer table out of sync");
+
+    constexpr int32 HeadId = static_cast<int32>(ECharacter2DSpriteLayer::Head);
+    constexpr int32 FirstFaceId = static_cast<int32>(ECharacter2DSpriteLayer::Eyebrow);
+
+    SpriteTransform = Old.Transform;
+    BlinkSettings = Old.Head.EyelidsBlinkSettings;
+    BlinkLayerId = static_cast<int32>(ECharacter2DSpriteLayer::Eyelids);
+    TalkSettings = Old.Head.MouthTalkSettings;
+    TalkLayerId = static_cast<int32>(ECharacter2DSpriteLayer::Mouth);
+
+    // Id слоя = значение перечисления, ссылки выражений переводятся без таблицы
+    for (FCharacter2DExpressionSet& Set : ExpressionSets)
+    {
+        for (FCharacter2DExpressionLayer& Entry : Set.Layers)
+        {
+            Entry.LayerId = static_cast<int32>(Entry.Layer_DEPRECATED);
+        }
+    }
+
+    // Пустой слой переносится, только если на него что-то ссылается; лицо держит голову (трансформ, сокет)
+    bool bKeep[NumOldLayers] = {};
+    for (int32 Id = NumOldLayers - 1; Id >= 0; --Id)
+    {
+        bKeep[Id] = !OldLayers[Id]->Sprite.IsNull()
+            || (Id == BlinkLayerId && !BlinkSettings.BlinkFlipbook.IsNull())
+            || (Id == TalkLayerId && !TalkSettings.TalkFlipbook.IsNull())
+            || ExpressionSets.ContainsByPredicate([Id](const FCharacter2DExpressionSet& Set)
+               {
+                   return Set.Layers.ContainsByPredicate([Id](const FCharacter2DExpressionLayer& Entry) { return Entry.LayerId == Id; });
+               });
+        for (int32 FaceId = FirstFaceId; Id == HeadId && FaceId < NumOldLayers; ++FaceId)
+        {
+            bKeep[Id] |= bKeep[FaceId];
+        }
+    }
+
+    const UEnum* LayerEnum = StaticEnum<ECharacter2DSpriteLayer>();
+    SpriteLayers.Reset();
+    for (int32 Id = 0; Id < NumOldLayers; ++Id)
+    {
+        if (!bKeep[Id])
+        {
+            continue;
+        }
+
+        FCharacter2DSpriteLayer& Layer = SpriteLayers.Add_GetRef(*OldLayers[Id]);
+        Layer.Id = Id;
+        Layer.ParentId = Id >= FirstFaceId ? HeadId : INDEX_NONE;
+        if (Layer.Name.IsNone())
+        {
+            Layer.Name = FName(LayerEnum->GetNameStringByValue(Id));
+        }
+    }
+    NextSpriteLayerId = NumOldLayers;
+
+    if (!bKeep[BlinkLayerId]) BlinkLayerId = INDEX_NONE;
+    if (!bKeep[TalkLayerId]) TalkLayerId = INDEX_NONE;
+
+    SpriteStructure_DEPRECATED = FCharacter2DSpriteStructure();
+}
+#endif
+
+/* ====================================================================== */
+/*                              Sprite Layers                             */
+/* ====================================================================== */
+
+int32 UCharacter2DAsset::FindSpriteLayerId(FName Name) const
+{
+    const FCharacter2DSpriteLayer* Layer = SpriteLayers.FindByPredicate([Name](const FCharacter2DSpriteLayer& Candidate) { return Candidate.Name == Name; });
+    return Layer ? Layer->Id : INDEX_NONE;
+}
+
+bool UCharacter2DAsset::GetSpriteLayer(int32 LayerId, FCharacter2DSpriteLayer& OutLayer) const
+{
+    const int32 LayerIndex = FindSpriteLayerIndex(LayerId);
+    if (LayerIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    OutLayer = SpriteLayers[LayerIndex];
+    return true;
+}
+
+int32 UCharacter2DAsset::GetSpriteLayerParentIndex(int32 LayerIndex) const
+{
+    const int32 ParentIndex = FindSpriteLayerIndex(SpriteLayers[LayerIndex].ParentId);
+
+    // Цепочка длиннее числа слоёв или вернувшаяся к слою — цикл, слой считается корневым
+    int32 Steps = 0;
+    for (int32 Index = ParentIndex; Index != INDEX_NONE; Index = FindSpriteLayerIndex(SpriteLayers[Index].ParentId))
+    {
+        if (Index == LayerIndex || ++Steps > SpriteLayers.Num())
+        {
+            return INDEX_NONE;
+        }
+    }
+    return ParentIndex;
+}
+
+FTransform UCharacter2DAsset::GetSpriteLayerTransform(int32 LayerIndex) const
+{
+    const FVector GlobalOffset = SpriteTransform.GlobalOffset;
+    const float GlobalScale = SpriteTransform.GlobalScale;
+    auto MakeTransform = [&GlobalOffset, GlobalScale](const FCharacter2DSpriteLayer& Layer)
+    {
+        return FTransform(FQuat::Identity, Layer.Offset + GlobalOffset, FVector(Layer.Scale * GlobalScale));
+    };
+
+    FTransform Transform = MakeTransform(SpriteLayers[LayerIndex]);
+    for (int32 Parent = GetSpriteLayerParentIndex(LayerIndex); Parent != INDEX_NONE; Parent = GetSpriteLayerParentIndex(Parent))
+    {
+        Transform = Transform * MakeTransform(SpriteLayers[Parent]);
+    }
+    return Transform;
+}
+
+int32 UCharacter2DAsset::AddSpriteLayer(FName Name, const TSoftObjectPtr<UPaperSprite>& Sprite, int32 ParentId)
+{
+    EnsureSpriteLayerIds();
+
+    FCharacter2DSpriteLayer& Layer = SpriteLayers.AddDefaulted_GetRef();
+    Layer.Id = NextSpriteLayerId++;
+    Layer.Name = Name;
+    Layer.Sprite = Sprite;
+    Layer.ParentId = ParentId;
+
+    BuildExpressionTable();
+    return Layer.Id;
+}
+
+void UCharacter2DAsset::EnsureSpriteLayerIds()
+{
+    for (const FCharacter2DSpriteLayer& Layer : SpriteLayers)
+    {
+        NextSpriteLayerId = FMath::Max(NextSpriteLayerId, Layer.Id + 1);
+    }
+
+    // Первый слой с Id сохраняет его, остальные копии получают новый
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<32>> UsedIds;
+    for (FCharacter2DSpriteLayer& Layer : SpriteLayers)
+    {
+        bool bAlreadyUsed = false;
+        if (Layer.Id != INDEX_NONE)
+        {
+            UsedIds.Add(Layer.Id, &bAlreadyUsed);
+        }
+        if (Layer.Id == INDEX_NONE || bAlreadyUsed)
+        {
+            Layer.Id = NextSpriteLayerId++;
+            UsedIds.Add(Layer.Id);
+        }
+    }
+}
+
+/* ====================================================================== */
+/*                               Expressions                              */
+/* ====================================================================== */
+
+void UCharacter2DAsset::BuildExpressionTable()
+{
+    ExpressionSprites.Reset();
+    ExpressionLookup.Reset();
+    ExpressionTableNum = ExpressionSets.Num();
+    ExpressionTableLayers = SpriteLayers.Num();
+    ExpressionTable.Init(INDEX_NONE, ExpressionTableNum * ExpressionTableLayers);
+
+    for (int32 Expression = 0; Expression < ExpressionTableNum; ++Expression)
+    {
+        const FCharacter2DExpressionSet& Set = ExpressionSets[Expression];
+        if (!Set.Name.IsNone() && !ExpressionLookup.Contains(Set.Name))
+        {
+            ExpressionLookup.Add(Set.Name, Expression);
+        }
+
+        // Одинаковые спрайты у разных выражений получают один индекс: смена между ними — не смена слоя
+        for (const FCharacter2DExpressionLayer& Entry : Set.Layers)
+        {
+            const int32 LayerIndex = FindSpriteLayerIndex(Entry.LayerId);
+            if (Entry.Sprite.IsNull() || LayerIndex == INDEX_NONE)
+            {
+                continue;
+            }
+            ExpressionTable[Expression * ExpressionTableLayers + LayerIndex] = static_cast<int16>(ExpressionSprites.AddUnique(Entry.Sprite));
+        }
+    }
+}
+
+int32 UCharacter2DAsset::FindExpressionIndex(FName Name) const
+{
+    const int32* Index = ExpressionLookup.Find(Name);
+    return Index ? *Index : INDEX_NONE;
+}
+
+/* ====================================================================== */
+/*                              Async Loading                             */
+/* ====================================================================== */
+
+const FPrimaryAssetType UCharacter2DAsset::PrimaryAssetType(TEXT("Character2D"));
+const FName UCharacter2DAsset::SpriteBundle(TEXT("Sprite"));
+const FName UCharacter2DAsset::SkeletalBundle(TEXT("Skeletal"));
+const FName UCharacter2DAsset::SpriteAtlasBundle(TEXT("SpriteAtlas"));
+
+FPrimaryAssetId UCharacter2DAsset::GetPrimaryAssetId() const
+{
+    return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
+
+void UCharacter2DAsset::GatherBundlePaths(TConstArrayView<FName> Bundles, TArray<FSoftObjectPath>& OutPaths) const
+{
+    // Пути собираются из полей напрямую: работает и без настройки Primary Asset Types в ассет-менеджере
+    auto AddPath = [&OutPaths](const FSoftObjectPath& Path)
+    {
+        if (!Path.IsNull())
+        {
+            OutPaths.AddUnique(Path);
+        }
+    };
+
+    if (Bundles.Contains(SpriteBundle))
+    {
+        for (const FCharacter2DSpriteLayer& Layer : SpriteLayers)
+        {
+            AddPath(Layer.Sprite.ToSoftObjectPath());
+        }
+        AddPath(BlinkSettings.BlinkFlipbook.ToSoftObjectPath());
+        AddPath(TalkSettings.TalkFlipbook.ToSoftObjectPath());
+
+        for (const FCharacter2DExpressionSet& Set : ExpressionSets)
+        {
+            for (const FCharacter2DExpressionLayer& Entry : Set.Layers)
+            {
+                AddPath(Entry.Sprite.ToSoftObjectPath());
+            }
+        }
+    }
+    else if (Bundles.Contains(SpriteAtlasBundle))
+    {
+        // Кадры атласа рисуются без своих спрайтов: исходные спрайты и их текстуры не грузятся.
+        // Flipbook держат кадры жёсткими ссылками и грузятся целиком
+        auto AddUnlessInAtlas = [this, &AddPath](const FSoftObjectPath& Path)
+        {
+            if (SpriteAtlas.FindFrameIndex(Path) == INDEX_NONE)
+            {
+                AddPath(Path);
+            }
+        };
+
+        for (const FCharacter2DSpriteLayer& Layer : SpriteLayers)
+        {
+            AddUnlessInAtlas(Layer.Sprite.ToSoftObjectPath());
+        }
+        AddPath(BlinkSettings.BlinkFlipbook.ToSoftObjectPath());
+        AddPath(TalkSettings.TalkFlipbook.ToSoftObjectPath());
+
+        for (const FCharacter2DExpressionSet& Set : ExpressionSets)
+        {
+            for (const FCharacter2DExpressionLayer& Entry : Set.Layers)
+            {
+                AddUnlessInAtlas(Entry.Sprite.ToSoftObjectPath());
+            }
+        }
+    }
+
+    if (Bundles.Contains(SkeletalBundle))
+    {
+        for (const FCharacter2DSkeletalPart* Part : { &Body, &Arms, &Head })
+        {
+            AddPath(Part->Mesh.ToSoftObjectPath());
+            AddPath(Part->AnimInstance.ToSoftObjectPath());
+            for (const FCharacter2DSkeletalMaterial& Material : Part->Materials)
+            {
+                AddPath(Material.Material.ToSoftObjectPath());
+            }
+        }
+    }
+}
+
+TSharedPtr<FStreamableHandle> UCharacter2DAsset::RequestLoad(TConstArrayView<FName> Bundles, FStreamableDelegate OnLoaded, TAsyncLoadPriority Priority)
+{
+    TArray<FSoftObjectPath> Paths;
+    GatherBundlePaths(Bundles, Paths);
+
+    if (Paths.IsEmpty())
+    {
+        OnLoaded.ExecuteIfBound();
+        return nullptr;
+    }
+
+    // Уже загруженные пути handle завершает сразу, но всё равно удерживает
+    TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+        MoveTemp(Paths), MoveTemp(OnLoaded), Priority, false, false, FString::Printf(TEXT("Character2D %s"), *GetName()));
+    if (Handle.IsValid())
+    {
+        BundleHandles.RemoveAll([](const TSharedPtr<FStreamableHandle>& Existing) { return !Existing.IsValid() || Existing->WasCanceled(); });
+        BundleHandles.Add(Handle);
+    }
+    return Handle;
+}
+
+void UCharacter2DAsset::PreloadBundles(const TArray<FName>& Bundles, FOnCharacter2DAssetLoaded OnLoaded)
+{
+    const FName AllBundles[] = { SpriteBundle, SkeletalBundle };
+    RequestLoad(Bundles.IsEmpty() ? MakeArrayView(AllBundles) : TConstArrayView<FName>(Bundles),
+        FStreamableDelegate::CreateLambda([OnLoaded]() { OnLoaded.ExecuteIfBound(); }));
+}
+
+bool UCharacter2DAsset::AreBundlesLoaded(const TArray<FName>& Bundles) const
+{
+    const FName AllBundles[] = { SpriteBundle, SkeletalBundle };
+    TArray<FSoftObjectPath> Paths;
+    GatherBundlePaths(Bundles.IsEmpty() ? MakeArrayView(AllBundles) : TConstArrayView<FName>(Bundles), Paths);
+    return !Paths.ContainsByPredicate([](const FSoftObjectPath& Path) { return Path.ResolveObject() == nullptr; });
+}
+
+void UCharacter2DAsset::ReleaseBundles()
+{
+    for (const TSharedPtr<FStreamableHandle>& Handle : BundleHandles)
+    {
+        if (Handle.IsValid())
+        {
+            Handle->ReleaseHandle();
+        }
+    }
+    BundleHandles.Reset();
+}
+
+int32 FCharacter2DSpriteAtlas::FindFrameIndex(const FSoftObjectPath& SpritePath) const
+{
+    if (SpritePath.IsNull() || !Texture)
+    {
+        return INDEX_NONE;
+    }
+
+    return Frames.IndexOfByPredicate([&SpritePath](const FCharacter2DAtlasFrame& Frame)
+    {
+        return Frame.Material != nullptr && Frame.SourceSprite == SpritePath;
+    });
+}
+
+void UCharacter2DAsset::GatherAtlasSprites(TArray<UPaperSprite*>& OutSprites) const
+{
+    for (const FCharacter2DSpriteLayer& Layer : SpriteLayers)
+    {
+        if (UPaperSprite* Sprite = Layer.Sprite.LoadSynchronous())
+        {
+            OutSprites.AddUnique(Sprite);
+        }
+    }
+
+    // Выражения в том же атласе: смена выражения — только UV слоя, без новой секции
+    for (const FCharacter2DExpressionSet& Set : ExpressionSets)
+    {
+        for (const FCharacter2DExpressionLayer& Entry : Set.Layers)
+        {
+            if (UPaperSprite* Sprite = Entry.Sprite.LoadSynchronous())
+            {
+                OutSprites.AddUnique(Sprite);
+            }
+        }
+    }
+
+    const UPaperFlipbook* Flipbooks[] = { BlinkSettings.BlinkFlipbook.LoadSynchronous(), TalkSettings.TalkFlipbook.LoadSynchronous() };
+    for (const UPaperFlipbook* Flipbook : Flipbooks)
+    {
+        if (!Flipbook)
+        {
+            continue;
+        }
+        for (int32 KeyFrame = 0; KeyFrame < Flipbook->GetNumKeyFrames(); ++KeyFrame)
+        {
+            if (UPaperSprite* Sprite = Flipbook->GetKeyFrameChecked(KeyFrame).Sprite)
+            {
+                OutSprites.AddUnique(Sprite);
+            }
+        }
+    }
+}
+
+bool UCharacter2DAsset::CanUseSpriteAtlas() const
+{
+#if WITH_EDITOR
+    // В редакторе спрайты могли измениться после последнего сохранения — тогда рисуем исходные
+    return IsSpriteAtlasUpToDate();
+#else
+    // Устаревший атлас пересобирается или снимается при куке (Character2DAtlasBuilder::HandlePreSavePackage)
+    return SpriteAtlas.IsValid();
+#endif
 }
 
 bool UCharacter2DAsset::HasValidSpriteConfiguration() const
 {
-    // Check new structure first
-    const auto& SpriteStruct = SpriteStructure;
-    
-    return (SpriteStruct.Body.Sprite != nullptr ||
-            SpriteStruct.Arms.Sprite != nullptr ||
-            SpriteStruct.Head.Head.Sprite != nullptr ||
-            SpriteStruct.Head.Eyes.Sprite != nullptr ||
-            SpriteStruct.Head.Eyebrow.Sprite != nullptr ||
-            SpriteStruct.Head.Eyelids.Sprite != nullptr ||
-            SpriteStruct.Head.Mouth.Sprite != nullptr);
+    return SpriteLayers.ContainsByPredicate([](const FCharacter2DSpriteLayer& Layer) { return !Layer.Sprite.IsNull(); });
 }
 
 bool UCharacter2DAsset::HasValidSkeletalConfiguration() const
 {
-    return (Body.Mesh != nullptr ||
-            Arms.Mesh != nullptr ||
-            Head.Mesh != nullptr);
+    return (!Body.Mesh.IsNull() ||
+            !Arms.Mesh.IsNull() ||
+            !Head.Mesh.IsNull());
 }
 
 bool UCharacter2DAsset::IsValidForRuntime() const
@@ -77,6 +497,17 @@ void UCharacter2DAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 {
     Super::PostEditChangeProperty(PropertyChangedEvent);
 
+    // Таблица выражений индексируется позицией слоя — перестановка слоёв её тоже сбивает
+    const FName MemberName = PropertyChangedEvent.GetMemberPropertyName();
+    if (MemberName == GET_MEMBER_NAME_CHECKED(UCharacter2DAsset, SpriteLayers))
+    {
+        EnsureSpriteLayerIds();
+    }
+    if (MemberName == GET_MEMBER_NAME_CHECKED(UCharacter2DAsset, ExpressionSets) || MemberName == GET_MEMBER_NAME_CHECKED(UCharacter2DAsset, SpriteLayers))
+    {
+        BuildExpressionTable();
+    }
+
     FProperty* Property = PropertyChangedEvent.Property;
     if (Property)
     {
@@ -94,6 +525,30 @@ void UCharacter2DAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
     }
 }
 
+uint32 UCharacter2DAsset::ComputeSpriteAtlasHash() const
+{
+    TArray<UPaperSprite*> Sprites;
+    GatherAtlasSprites(Sprites);
+
+    uint32 Hash = GetTypeHash(Sprites.Num());
+    for (const UPaperSprite* Sprite : Sprites)
+    {
+        Hash = HashCombine(Hash, GetTypeHash(FSoftObjectPath(Sprite)));
+        Hash = FCrc::MemCrc32(Sprite->BakedRenderData.GetData(), Sprite->BakedRenderData.Num() * sizeof(FVector4), Hash);
+        Hash = HashCombine(Hash, GetTypeHash(FSoftObjectPath(Sprite->GetDefaultMaterial())));
+        if (const UTexture2D* Texture = Sprite->GetBakedTexture())
+        {
+            Hash = HashCombine(Hash, GetTypeHash(Texture->Source.GetId()));
+        }
+    }
+    return Hash;
+}
+
+bool UCharacter2DAsset::IsSpriteAtlasUpToDate() const
+{
+    return SpriteAtlas.IsValid() && SpriteAtlas.SourceHash == ComputeSpriteAtlasHash();
+}
+
 void UCharacter2DAsset::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
 {
     Super::GetAssetRegistryTags(Context);
@@ -122,8 +577,9 @@ void UCharacter2DAsset::GetAssetRegistryTags(FAssetRegistryTagsContext Context)
 
     Context.AddTag(FAssetRegistryTag(TEXT("RenderingMode"), GetRenderingModeDescription(), FAssetRegistryTag::TT_Alphabetical));
     Context.AddTag(FAssetRegistryTag(TEXT("HasSprites"), HasValidSpriteConfiguration() ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Alphabetical));
+    Context.AddTag(FAssetRegistryTag(TEXT("SpriteLayers"), FString::FromInt(SpriteLayers.Num()), FAssetRegistryTag::TT_Numerical));
     Context.AddTag(FAssetRegistryTag(TEXT("HasSkeletalMeshes"), HasValidSkeletalConfiguration() ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Alphabetical));
-    Context.AddTag(FAssetRegistryTag(TEXT("SupportsBlinking"), (bAutoBlink && SpriteStructure.Head.EyelidsBlinkSettings.BlinkFlipbook) ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Alphabetical));
-    Context.AddTag(FAssetRegistryTag(TEXT("SupportsTalking"), (bAutoTalk && SpriteStructure.Head.MouthTalkSettings.TalkFlipbook) ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Alphabetical));
+    Context.AddTag(FAssetRegistryTag(TEXT("SupportsBlinking"), (bAutoBlink && !BlinkSettings.BlinkFlipbook.IsNull()) ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Alphabetical));
+    Context.AddTag(FAssetRegistryTag(TEXT("SupportsTalking"), (bAutoTalk && !TalkSettings.TalkFlipbook.IsNull()) ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Alphabetical));
 }
 #endif // WITH_EDITOR
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "Character2DCustomVersion.h"
+#include "Serialization/CustomVersion.h"
+
+const FGuid FCharacter2DCustomVersion::GUID(0xEE43A502, 0x6A7142F0, 0x80434DEC, 0xE95FCD25);
+
+// Регистрация в системе custom versions
+FCustomVersionRegistration GRegisterCharacter2DCustomVersion(FCharacter2DCustomVersion::GUID, FCharacter2DCustomVersion::LatestVersion, TEXT("Character2DVer"));
@@ -1,4 +1,18 @@
 #include "Character2DRuntimeModule.h"
 #include "Modules/ModuleManager.h"
+#include "Animation/Character2DCurveCache.h"
+#include "Character2DStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(Character2DChannel);
+
+void FCharacter2DRuntimeModule::StartupModule()
+{
+    FCharacter2DCurveCache::Get().Initialize();
+}
+
+void FCharacter2DRuntimeModule::ShutdownModule()
+{
+    FCharacter2DCurveCache::Get().Shutdown();
+}
 
 IMPLEMENT_MODULE(FCharacter2DRuntimeModule, Character2DRuntime)
\ No newline at end of file
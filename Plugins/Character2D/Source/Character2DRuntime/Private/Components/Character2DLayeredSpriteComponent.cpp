@@ -0,0 +1,1031 @@
+#include "Components/Character2DLayeredSpriteComponent.h"
+#include "Character2DAsset.h"
+#include "PaperSprite.h"
+#include "PaperFlipbook.h"
+#include "Paper2DModule.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "MaterialDomain.h"
+#include "LocalVertexFactory.h"
+#include "StaticMeshResources.h"
+#include "RHICommandList.h"
+
+const FName UCharacter2DLayeredSpriteComponent::SpriteTextureParameterName(TEXT("SpriteTexture"));
+
+/* ====================================================================== */
+/*                              Scene Proxy                               */
+/* ====================================================================== */
+
+/** Вершины, изменившиеся без смены раскладки: позиции и UV диапазонов подряд, цвет — один на все вершины */
+struct FCharacter2DLayeredSpriteVertexUpdate
+{
+    /** (первая вершина, число вершин) */
+    TArray<TPair<uint32, uint32>, TInlineAllocator<4>> Ranges;
+    TArray<FVector3f> Positions;
+    TArray<FVector2f> UVs;
+    TOptional<FColor> Color;
+};
+
+class FCharacter2DLayeredSpriteSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+    struct FProxySection
+    {
+        const FMaterialRenderProxy* MaterialProxy = nullptr;
+        uint32 FirstIndex = 0;
+        uint32 NumPrimitives = 0;
+        uint32 MinVertexIndex = 0;
+        uint32 MaxVertexIndex = 0;
+    };
+
+    FCharacter2DLayeredSpriteSceneProxy(const UCharacter2DLayeredSpriteComponent* InComponent, FCharacter2DLayeredSpriteRenderData& InData)
+        : FPrimitiveSceneProxy(InComponent)
+        , MaterialRelevance(InComponent->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+        , VertexFactory(GetScene().GetFeatureLevel(), "FCharacter2DLayeredSpriteSceneProxy")
+        , NumVertices(InData.Vertices.Num())
+    {
+        // Буферы живут вместе с proxy: кадры Flipbook, выражения и цвет дописываются в них на месте
+        VertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(true);
+        VertexBuffers.InitFromDynamicVertex(&VertexFactory, InData.Vertices);
+        IndexBuffer.Indices = InData.Indices;
+        BeginInitResource(&IndexBuffer);
+
+        Sections.Reserve(InData.Sections.Num());
+        for (const FCharacter2DLayeredSpriteSection& Section : InData.Sections)
+        {
+            UMaterialInterface* Material = Section.Material ? Section.Material.Get() : UMaterial::GetDefaultMaterial(MD_Surface);
+
+            FProxySection& ProxySection = Sections.AddDefaulted_GetRef();
+            ProxySection.MaterialProxy = Material->GetRenderProxy();
+            ProxySection.FirstIndex = Section.FirstIndex;
+            ProxySection.NumPrimitives = Section.NumTriangles;
+            ProxySection.MinVertexIndex = Section.MinVertexIndex;
+            ProxySection.MaxVertexIndex = Section.MaxVertexIndex;
+        }
+    }
+
+    virtual ~FCharacter2DLayeredSpriteSceneProxy() override
+    {
+        VertexBuffers.PositionVertexBuffer.ReleaseResource();
+        VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+        VertexBuffers.ColorVertexBuffer.ReleaseResource();
+        IndexBuffer.ReleaseResource();
+        VertexFactory.ReleaseResource();
+    }
+
+    virtual SIZE_T GetTypeHash() const override
+    {
+        static size_t UniquePointer;
+        return reinterpret_cast<size_t>(&UniquePointer);
+    }
+
+    /** Запись изменившихся вершин в буферы; индексы и секции те же, закэшированные draw-команды остаются валидными */
+    void UpdateVertices_RenderThread(FRHICommandListBase& RHICmdList, const FCharacter2DLayeredSpriteVertexUpdate& Update)
+    {
+        check(IsInRenderingThread());
+
+        int32 Offset = 0;
+        for (const TPair<uint32, uint32>& Range : Update.Ranges)
+        {
+            check(Range.Key + Range.Value <= NumVertices);
+            WriteBuffer(RHICmdList, VertexBuffers.PositionVertexBuffer.VertexBufferRHI, Range.Key * sizeof(FVector3f), &Update.Positions[Offset], Range.Value * sizeof(FVector3f));
+            WriteBuffer(RHICmdList, VertexBuffers.StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI, Range.Key * sizeof(FVector2f), &Update.UVs[Offset], Range.Value * sizeof(FVector2f));
+            Offset += Range.Value;
+        }
+
+        if (Update.Color.IsSet())
+        {
+            FRHIBuffer* ColorBuffer = VertexBuffers.ColorVertexBuffer.VertexBufferRHI;
+            FColor* Colors = static_cast<FColor*>(RHICmdList.LockBuffer(ColorBuffer, 0, NumVertices * sizeof(FColor), RLM_WriteOnly));
+            for (uint32 Index = 0; Index < NumVertices; ++Index)
+            {
+                Colors[Index] = Update.Color.GetValue();
+            }
+            RHICmdList.UnlockBuffer(ColorBuffer);
+        }
+    }
+
+    virtual void DrawStaticElements(FStaticPrimitiveDrawInterface* PDI) override
+    {
+        // Один vertex/index буфер на все слои, секции рисуются диапазонами индексов
+        for (const FProxySection& Section : Sections)
+        {
+            FMeshBatch Mesh;
+            Mesh.VertexFactory = &VertexFactory;
+            Mesh.MaterialRenderProxy = Section.MaterialProxy;
+            Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+            Mesh.bDisableBackfaceCulling = true;
+            Mesh.Type = PT_TriangleList;
+            Mesh.DepthPriorityGroup = SDPG_World;
+            Mesh.LODIndex = 0;
+            Mesh.CastShadow = CastsDynamicShadow();
+            Mesh.bCanApplyViewModeOverrides = false;
+
+            // Uniform buffer самого proxy: Custom Primitive Data (оттенок, эмоции) доходит до материала
+            FMeshBatchElement& BatchElement = Mesh.Elements[0];
+            BatchElement.IndexBuffer = &IndexBuffer;
+            BatchElement.PrimitiveUniformBuffer = GetUniformBuffer();
+            BatchElement.FirstIndex = Section.FirstIndex;
+            BatchElement.NumPrimitives = Section.NumPrimitives;
+            BatchElement.MinVertexIndex = Section.MinVertexIndex;
+            BatchElement.MaxVertexIndex = Section.MaxVertexIndex;
+
+            PDI->DrawMesh(Mesh, FLT_MAX);
+        }
+    }
+
+    virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+    {
+        FPrimitiveViewRelevance Result;
+        Result.bDrawRelevance = IsShown(View);
+        Result.bShadowRelevance = IsShadowCast(View);
+        Result.bRenderInMainPass = ShouldRenderInMainPass();
+        Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+        Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+        Result.bStaticRelevance = true;
+        MaterialRelevance.SetPrimitiveViewRelevance(Result);
+        Result.bVelocityRelevance = DrawsVelocity() && Result.bOpaque && Result.bRenderInMainPass;
+        return Result;
+    }
+
+    virtual bool CanBeOccluded() const override
+    {
+        return !MaterialRelevance.bDisableDepthTest;
+    }
+
+    virtual uint32 GetMemoryFootprint() const override
+    {
+        return sizeof(*this) + GetAllocatedSize();
+    }
+
+    uint32 GetAllocatedSize() const
+    {
+        return FPrimitiveSceneProxy::GetAllocatedSize()
+            + IndexBuffer.Indices.GetAllocatedSize()
+            + Sections.GetAllocatedSize();
+    }
+
+private:
+    static void WriteBuffer(FRHICommandListBase& RHICmdList, FRHIBuffer* Buffer, uint32 Offset, const void* Data, uint32 Size)
+    {
+        void* Target = RHICmdList.LockBuffer(Buffer, Offset, Size, RLM_WriteOnly);
+        FMemory::Memcpy(Target, Data, Size);
+        RHICmdList.UnlockBuffer(Buffer);
+    }
+
+    FMaterialRelevance MaterialRelevance;
+    FStaticMeshVertexBuffers VertexBuffers;
+    FDynamicMeshIndexBuffer32 IndexBuffer;
+    FLocalVertexFactory VertexFactory;
+    uint32 NumVertices = 0;
+    TArray<FProxySection> Sections;
+};
+
+/* ====================================================================== */
+/*                              Layer Helpers                             */
+/* ====================================================================== */
+
+const UPaperSprite* FCharacter2DLayeredSpriteLayer::GetDisplayedSprite(int32& OutAtlasFrame) const
+{
+    if (bPlaying && Flipbook)
+    {
+        OutAtlasFrame = FlipbookAtlasFrames.IsValidIndex(FrameIndex) ? FlipbookAtlasFrames[FrameIndex] : INDEX_NONE;
+        return OutAtlasFrame == INDEX_NONE && Flipbook->IsValidKeyFrameIndex(FrameIndex)
+            ? Flipbook->GetKeyFrameChecked(FrameIndex).Sprite.Get()
+            : nullptr;
+    }
+    if (!ExpressionSpritePath.IsNull())
+    {
+        OutAtlasFrame = ExpressionAtlasFrame;
+        return ExpressionSprite;
+    }
+    OutAtlasFrame = AtlasFrame;
+    return Sprite;
+}
+
+bool FCharacter2DLayeredSpriteRenderData::HasSameSectionLayout(const FCharacter2DLayeredSpriteRenderData& Other) const
+{
+    // Индексный буфер proxy не обновляется — он должен совпасть целиком
+    if (Sections.Num() != Other.Sections.Num() || Vertices.Num() != Other.Vertices.Num() || Indices != Other.Indices)
+    {
+        return false;
+    }
+
+    for (int32 Index = 0; Index < Sections.Num(); ++Index)
+    {
+        const FCharacter2DLayeredSpriteSection& A = Sections[Index];
+        const FCharacter2DLayeredSpriteSection& B = Other.Sections[Index];
+        if (A.Material != B.Material ||
+            A.FirstIndex != B.FirstIndex ||
+            A.NumTriangles != B.NumTriangles ||
+            A.MinVertexIndex != B.MinVertexIndex ||
+            A.MaxVertexIndex != B.MaxVertexIndex)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ====================================================================== */
+/*                               Component                                */
+/* ====================================================================== */
+
+UCharacter2DLayeredSpriteComponent::UCharacter2DLayeredSpriteComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
+
+    SetCastShadow(false);
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+bool UCharacter2DLayeredSpriteComponent::CanBatchAsset(const UCharacter2DAsset* Asset)
+{
+    if (!Asset)
+    {
+        return false;
+    }
+
+    // Слои, прикреплённые к сокетам скелетных мешей, должны следовать за костями
+    auto IsSocketAttached = [](ECharacter2DAttachmentTarget Target, FName Socket)
+    {
+        return Target != ECharacter2DAttachmentTarget::None && Socket != NAME_None;
+    };
+
+    for (const FCharacter2DSpriteLayer& Layer : Asset->SpriteLayers)
+    {
+        if (IsSocketAttached(Layer.AttachmentTarget, Layer.SocketName))
+        {
+            return false;
+        }
+    }
+    return !IsSocketAttached(Asset->BlinkSettings.AttachmentTarget, Asset->BlinkSettings.SocketName)
+        && !IsSocketAttached(Asset->TalkSettings.AttachmentTarget, Asset->TalkSettings.SocketName);
+}
+
+void UCharacter2DLayeredSpriteComponent::SetCharacterAsset(UCharacter2DAsset* InAsset)
+{
+    // Ровно столько слоёв, сколько в ассете
+    Layers.Reset();
+    Layers.SetNum(InAsset ? InAsset->SpriteLayers.Num() : 0);
+
+    SourceAsset = InAsset;
+    RebuildAtlasLookup();
+    ApplyAssetLayers();
+
+    NotifyStaticLayersChanged();
+    RebuildRenderData();
+    UpdateTickEnabled();
+}
+
+void UCharacter2DLayeredSpriteComponent::RefreshLayersFromAsset()
+{
+    if (!SourceAsset)
+    {
+        return;
+    }
+
+    // Слои добавлены или удалены — индексы Flipbook и выражений больше не годятся
+    if (Layers.Num() != SourceAsset->SpriteLayers.Num())
+    {
+        SetCharacterAsset(SourceAsset);
+        return;
+    }
+
+    // Спрайты слоёв сменились — кадры атласа могли устареть
+    RebuildAtlasLookup();
+    ApplyAssetLayers();
+
+    NotifyStaticLayersChanged();
+    RebuildRenderData();
+}
+
+void UCharacter2DLayeredSpriteComponent::ApplyAssetLayers()
+{
+    if (!SourceAsset)
+    {
+        return;
+    }
+
+    // Кадры моргания и разговора без сокета рисуются в трансформе родителя слоя, как Flipbook-компоненты актёра
+    const int32 BlinkLayer = SourceAsset->FindSpriteLayerIndex(SourceAsset->BlinkLayerId);
+    const int32 TalkLayer = SourceAsset->FindSpriteLayerIndex(SourceAsset->TalkLayerId);
+
+    // Состояние Flipbook слоя (моргание, разговор) и спрайт выражения не трогаются
+    const TArray<FCharacter2DSpriteLayer>& AssetLayers = SourceAsset->SpriteLayers;
+    for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+    {
+        FCharacter2DLayeredSpriteLayer& Layer = Layers[LayerIndex];
+
+        // Кадр атласа рисуется без спрайта: ни спрайт, ни его исходная текстура не загружаются
+        const TSoftObjectPtr<UPaperSprite>& AssetSprite = AssetLayers[LayerIndex].Sprite;
+        Layer.AtlasFrame = FindAtlasFrame(AssetSprite.ToSoftObjectPath());
+        Layer.Sprite = Layer.AtlasFrame == INDEX_NONE ? AssetSprite.LoadSynchronous() : nullptr;
+        ResolveExpressionSprite(Layer);
+        ResolveFlipbookFrames(Layer);
+
+        Layer.LayerTransform = SourceAsset->GetSpriteLayerTransform(LayerIndex);
+        Layer.bVisible = AssetLayers[LayerIndex].bVisible;
+
+        if (LayerIndex == BlinkLayer || LayerIndex == TalkLayer)
+        {
+            const int32 Parent = SourceAsset->GetSpriteLayerParentIndex(LayerIndex);
+            Layer.FrameTransform = Parent != INDEX_NONE ? SourceAsset->GetSpriteLayerTransform(Parent) : FTransform::Identity;
+        }
+        else
+        {
+            Layer.FrameTransform = Layer.LayerTransform;
+        }
+    }
+}
+
+void UCharacter2DLayeredSpriteComponent::SetLayerVisible(int32 LayerIndex, bool bVisible)
+{
+    if (!Layers.IsValidIndex(LayerIndex))
+    {
+        return;
+    }
+
+    FCharacter2DLayeredSpriteLayer& State = Layers[LayerIndex];
+    if (State.bVisible != bVisible)
+    {
+        State.bVisible = bVisible;
+        NotifyStaticLayersChanged();
+        RebuildRenderData();
+    }
+}
+
+bool UCharacter2DLayeredSpriteComponent::IsLayerVisible(int32 LayerIndex) const
+{
+    return Layers.IsValidIndex(LayerIndex) && Layers[LayerIndex].bVisible;
+}
+
+void UCharacter2DLayeredSpriteComponent::SetExpressionSprites(const TBitArray<>& Changed, TConstArrayView<FSoftObjectPath> Sprites)
+{
+    bool bChanged = false;
+    bool bRebuild = false;
+    for (int32 LayerIndex = 0; LayerIndex < Layers.Num() && LayerIndex < Sprites.Num() && LayerIndex < Changed.Num(); ++LayerIndex)
+    {
+        FCharacter2DLayeredSpriteLayer& State = Layers[LayerIndex];
+        if (Changed[LayerIndex] && State.ExpressionSpritePath != Sprites[LayerIndex])
+        {
+            State.ExpressionSpritePath = Sprites[LayerIndex];
+            ResolveExpressionSprite(State);
+            bChanged = true;
+        }
+    }
+
+    if (!bChanged)
+    {
+        return;
+    }
+
+    // Сброс импостора меняет раскладку секций — тогда пересборка всё равно полная
+    const bool bHadImpostor = ImpostorTexture != nullptr;
+    NotifyStaticLayersChanged();
+    if (bHadImpostor)
+    {
+        RebuildRenderData();
+        return;
+    }
+
+    // При атласе кадр выражения — тот же квад с другими UV: переписываются только вершины слоя
+    for (TConstSetBitIterator<> It(Changed); It && !bRebuild; ++It)
+    {
+        bRebuild = Layers.IsValidIndex(It.GetIndex()) && !TryUpdateLayerGeometry(It.GetIndex());
+    }
+    if (bRebuild)
+    {
+        RebuildRenderData();
+    }
+}
+
+void UCharacter2DLayeredSpriteComponent::PlayLayerFlipbook(int32 LayerIndex, UPaperFlipbook* Flipbook, float PlayRate, bool bLoop)
+{
+    if (!Layers.IsValidIndex(LayerIndex))
+    {
+        return;
+    }
+
+    if (!Flipbook)
+    {
+        StopLayerFlipbook(LayerIndex);
+        return;
+    }
+
+    FCharacter2DLayeredSpriteLayer& State = Layers[LayerIndex];
+    if (State.Flipbook != Flipbook)
+    {
+        State.Flipbook = Flipbook;
+        ResolveFlipbookFrames(State);
+    }
+    State.PlayRate = PlayRate;
+    State.PlaybackTime = 0.0f;
+    State.bLooping = bLoop;
+    State.bPlaying = true;
+    State.FrameIndex = Flipbook->GetKeyFrameIndexAtTime(0.0f, true);
+
+    UpdateLayerGeometry(LayerIndex);
+    UpdateTickEnabled();
+}
+
+void UCharacter2DLayeredSpriteComponent::StopLayerFlipbook(int32 LayerIndex)
+{
+    if (!Layers.IsValidIndex(LayerIndex))
+    {
+        return;
+    }
+
+    FCharacter2DLayeredSpriteLayer& State = Layers[LayerIndex];
+    if (!State.bPlaying)
+    {
+        return;
+    }
+
+    State.bPlaying = false;
+    State.Flipbook = nullptr;
+    State.FlipbookAtlasFrames.Reset();
+    State.FrameIndex = INDEX_NONE;
+
+    UpdateLayerGeometry(LayerIndex);
+    UpdateTickEnabled();
+}
+
+bool UCharacter2DLayeredSpriteComponent::IsLayerFlipbookPlaying(int32 LayerIndex) const
+{
+    return Layers.IsValidIndex(LayerIndex) && Layers[LayerIndex].bPlaying;
+}
+
+bool UCharacter2DLayeredSpriteComponent::IsAnyLayerFlipbookPlaying() const
+{
+    return Layers.ContainsByPredicate([](const FCharacter2DLayeredSpriteLayer& Layer) { return Layer.bPlaying; });
+}
+
+void UCharacter2DLayeredSpriteComponent::SetSpriteColor(const FLinearColor& NewColor)
+{
+    if (SpriteColor == NewColor)
+    {
+        return;
+    }
+
+    SpriteColor = NewColor;
+
+    // Цвет общий для всех вершин: в proxy уходит одно значение, геометрия не пересобирается
+    const FColor VertexColor = SpriteColor.ToFColor(false);
+    for (FDynamicMeshVertex& Vertex : RenderData.Vertices)
+    {
+        Vertex.Color = VertexColor;
+    }
+
+    if (SceneProxy)
+    {
+        bPendingColorUpload = true;
+        MarkRenderDynamicDataDirty();
+    }
+}
+
+void UCharacter2DLayeredSpriteComponent::SetMaterial(int32 ElementIndex, UMaterialInterface* Material)
+{
+    Super::SetMaterial(ElementIndex, Material);
+
+    // Базовый материал сменился — материалы с подставленными текстурами пересоздаются
+    TextureMaterials.Reset();
+    TextureMaterialKeys.Reset();
+    NotifyStaticLayersChanged();
+    RebuildRenderData();
+}
+
+void UCharacter2DLayeredSpriteComponent::SetImpostor(UTexture* Texture, UMaterialInterface* Material, const FBox& LocalBox)
+{
+    if (!Texture || !Material || !LocalBox.IsValid)
+    {
+        ClearImpostor();
+        return;
+    }
+
+    ImpostorTexture = Texture;
+    ImpostorMaterial = Material;
+    ImpostorBox = LocalBox;
+    RebuildRenderData();
+}
+
+void UCharacter2DLayeredSpriteComponent::ClearImpostor()
+{
+    if (ImpostorTexture)
+    {
+        ImpostorTexture = nullptr;
+        ImpostorMaterial = nullptr;
+        RebuildRenderData();
+    }
+}
+
+void UCharacter2DLayeredSpriteComponent::NotifyStaticLayersChanged()
+{
+    // Запечённая композиция устарела — сразу рисуем слои, владелец перезапечёт
+    ImpostorTexture = nullptr;
+    ImpostorMaterial = nullptr;
+    OnStaticLayersChanged.Broadcast();
+}
+
+/* ====================================================================== */
+/*                              Render Data                               */
+/* ====================================================================== */
+
+void UCharacter2DLayeredSpriteComponent::RebuildRenderData()
+{
+    FCharacter2DLayeredSpriteRenderData NewData;
+    NewData.LayerRanges.SetNum(Layers.Num());
+    if (ImpostorTexture)
+    {
+        AppendImpostorGeometry(NewData);
+    }
+    for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+    {
+        AppendLayerGeometry(NewData, Layers[LayerIndex], LayerIndex);
+    }
+
+    const bool bSameLayout = NewData.HasSameSectionLayout(RenderData);
+    const bool bBoundsChanged = !(NewData.LocalBox == RenderData.LocalBox);
+    RenderData = MoveTemp(NewData);
+    PendingLayerUploads.Init(false, Layers.Num());
+
+    if (bSameLayout && SceneProxy)
+    {
+        // Те же материалы и индексы: вершины переписываются в буферах существующего proxy
+        bPendingUploadAll = true;
+        MarkRenderDynamicDataDirty();
+        if (bBoundsChanged)
+        {
+            UpdateBounds();
+            MarkRenderTransformDirty();
+        }
+    }
+    else
+    {
+        bPendingUploadAll = false;
+        bPendingColorUpload = false;
+        UpdateBounds();
+        MarkRenderStateDirty();
+    }
+}
+
+bool UCharacter2DLayeredSpriteComponent::TryUpdateLayerGeometry(int32 LayerIndex)
+{
+    if (!RenderData.LayerRanges.IsValidIndex(LayerIndex))
+    {
+        return false;
+    }
+
+    const FCharacter2DLayeredSpriteLayer& Layer = Layers[LayerIndex];
+    const FCharacter2DLayeredSpriteLayerRange& Range = RenderData.LayerRanges[LayerIndex];
+
+    // Другое число вершин или материал — другие индексы и секции
+    FCharacter2DLayeredSpriteLayerDraw Draw;
+    ResolveLayerDraw(Layer, Draw);
+    if (Draw.NumVertices != (int32)Range.NumVertices || (Draw.NumVertices > 0 && Draw.Material != Range.Material))
+    {
+        return false;
+    }
+    if (Draw.NumVertices == 0)
+    {
+        return true;
+    }
+
+    // Рамка только растёт: для отсечения достаточно, полная пересборка её ужмёт
+    const FBox OldBox = RenderData.LocalBox;
+    WriteLayerVertices(Layer, LayerIndex, Draw, &RenderData.Vertices[Range.FirstVertex], RenderData.LocalBox);
+
+    if (SceneProxy)
+    {
+        PendingLayerUploads.SetNum(Layers.Num(), false);
+        PendingLayerUploads[LayerIndex] = true;
+        MarkRenderDynamicDataDirty();
+    }
+    if (!(OldBox == RenderData.LocalBox))
+    {
+        UpdateBounds();
+        MarkRenderTransformDirty();
+    }
+    return true;
+}
+
+void UCharacter2DLayeredSpriteComponent::UpdateLayerGeometry(int32 LayerIndex)
+{
+    if (!TryUpdateLayerGeometry(LayerIndex))
+    {
+        RebuildRenderData();
+    }
+}
+
+bool UCharacter2DLayeredSpriteComponent::ResolveLayerDraw(const FCharacter2DLayeredSpriteLayer& Layer, FCharacter2DLayeredSpriteLayerDraw& OutDraw)
+{
+    OutDraw = FCharacter2DLayeredSpriteLayerDraw();
+
+    // Кадр Flipbook виден и тогда, когда статичный слой скрыт (как EyelidComponent/MouthComponent);
+    // статичные слои под импостором не рисуются, поверх — только кадры Flipbook
+    if ((!Layer.bVisible && !Layer.bPlaying) || (ImpostorTexture && !Layer.bPlaying))
+    {
+        return false;
+    }
+
+    // Спрайт из атласа — один обрезанный квад; иначе запечённые треугольники спрайта
+    int32 AtlasFrameIndex = INDEX_NONE;
+    OutDraw.Sprite = Layer.GetDisplayedSprite(AtlasFrameIndex);
+    OutDraw.AtlasFrame = AtlasFrameIndex != INDEX_NONE ? &SourceAsset->SpriteAtlas.Frames[AtlasFrameIndex] : nullptr;
+    if (OutDraw.AtlasFrame)
+    {
+        OutDraw.NumVertices = 4;
+        OutDraw.Material = GetOrCreateTextureMaterial(GetSpriteBaseMaterial(OutDraw.AtlasFrame->Material), SourceAsset->SpriteAtlas.Texture.Get());
+    }
+    else if (OutDraw.Sprite)
+    {
+        OutDraw.NumVertices = OutDraw.Sprite->BakedRenderData.Num() - OutDraw.Sprite->BakedRenderData.Num() % 3;
+        OutDraw.Material = OutDraw.NumVertices > 0
+            ? GetOrCreateTextureMaterial(GetSpriteBaseMaterial(OutDraw.Sprite->GetDefaultMaterial()), OutDraw.Sprite->GetBakedTexture())
+            : nullptr;
+    }
+    return OutDraw.NumVertices > 0;
+}
+
+void UCharacter2DLayeredSpriteComponent::WriteLayerVertices(const FCharacter2DLayeredSpriteLayer& Layer, int32 LayerIndex, const FCharacter2DLayeredSpriteLayerDraw& Draw, FDynamicMeshVertex* OutVertices, FBox& InOutLocalBox) const
+{
+    const FTransform& Transform = Layer.bPlaying ? Layer.FrameTransform : Layer.LayerTransform;
+    const FVector DepthOffset = PaperAxisZ * (LayerDepthSpacing * LayerIndex);
+    const FVector3f TangentX(PaperAxisX);
+    const FVector3f TangentZ(-PaperAxisZ);
+    const FColor VertexColor = SpriteColor.ToFColor(false);
+
+    auto WriteVertex = [&](int32 Index, const FVector4& XYUV)
+    {
+        const FVector LocalPosition = Transform.TransformPosition(PaperAxisX * XYUV.X + PaperAxisY * XYUV.Y) + DepthOffset;
+
+        InOutLocalBox += LocalPosition;
+        OutVertices[Index] = FDynamicMeshVertex(FVector3f(LocalPosition), TangentX, TangentZ, FVector2f(XYUV.Z, XYUV.W), VertexColor);
+    };
+
+    if (Draw.AtlasFrame)
+    {
+        // Y спрайта направлен вверх, V атласа — вниз
+        const FBox2D& Rect = Draw.AtlasFrame->LocalRect;
+        const FBox2D& UV = Draw.AtlasFrame->UVRect;
+        WriteVertex(0, FVector4(Rect.Min.X, Rect.Max.Y, UV.Min.X, UV.Min.Y));
+        WriteVertex(1, FVector4(Rect.Max.X, Rect.Max.Y, UV.Max.X, UV.Min.Y));
+        WriteVertex(2, FVector4(Rect.Min.X, Rect.Min.Y, UV.Min.X, UV.Max.Y));
+        WriteVertex(3, FVector4(Rect.Max.X, Rect.Min.Y, UV.Max.X, UV.Max.Y));
+    }
+    else
+    {
+        for (int32 Index = 0; Index < Draw.NumVertices; ++Index)
+        {
+            WriteVertex(Index, Draw.Sprite->BakedRenderData[Index]);
+        }
+    }
+}
+
+void UCharacter2DLayeredSpriteComponent::AppendLayerGeometry(FCharacter2DLayeredSpriteRenderData& OutData, const FCharacter2DLayeredSpriteLayer& Layer, int32 LayerIndex)
+{
+    FCharacter2DLayeredSpriteLayerDraw Draw;
+    if (!ResolveLayerDraw(Layer, Draw))
+    {
+        return;
+    }
+
+    // Новая секция только при смене материала: подряд идущие слои одной текстуры — один draw call
+    if (OutData.Sections.IsEmpty() || OutData.Sections.Last().Material != Draw.Material)
+    {
+        FCharacter2DLayeredSpriteSection& NewSection = OutData.Sections.AddDefaulted_GetRef();
+        NewSection.Material = Draw.Material;
+        NewSection.FirstIndex = OutData.Indices.Num();
+        NewSection.MinVertexIndex = OutData.Vertices.Num();
+    }
+    FCharacter2DLayeredSpriteSection& Section = OutData.Sections.Last();
+
+    const uint32 BaseVertex = OutData.Vertices.Num();
+    FCharacter2DLayeredSpriteLayerRange& Range = OutData.LayerRanges[LayerIndex];
+    Range.Material = Draw.Material;
+    Range.FirstVertex = BaseVertex;
+    Range.NumVertices = Draw.NumVertices;
+
+    OutData.Vertices.SetNumUninitialized(BaseVertex + Draw.NumVertices);
+    WriteLayerVertices(Layer, LayerIndex, Draw, &OutData.Vertices[BaseVertex], OutData.LocalBox);
+
+    if (Draw.AtlasFrame)
+    {
+        OutData.Indices.Append({ BaseVertex, BaseVertex + 2, BaseVertex + 1, BaseVertex + 1, BaseVertex + 2, BaseVertex + 3 });
+        Section.NumTriangles += 2;
+    }
+    else
+    {
+        OutData.Indices.Reserve(OutData.Indices.Num() + Draw.NumVertices);
+        for (int32 Index = 0; Index < Draw.NumVertices; ++Index)
+        {
+            OutData.Indices.Add(BaseVertex + Index);
+        }
+        Section.NumTriangles += Draw.NumVertices / 3;
+    }
+
+    Section.MaxVertexIndex = OutData.Vertices.Num() - 1;
+}
+
+void UCharacter2DLayeredSpriteComponent::AppendImpostorGeometry(FCharacter2DLayeredSpriteRenderData& OutData)
+{
+    FCharacter2DLayeredSpriteSection& Section = OutData.Sections.AddDefaulted_GetRef();
+    Section.Material = GetOrCreateTextureMaterial(ImpostorMaterial, ImpostorTexture);
+    Section.FirstIndex = OutData.Indices.Num();
+    Section.MinVertexIndex = OutData.Vertices.Num();
+    Section.NumTriangles = 2;
+
+    // Квад на задней грани композиции, чтобы кадры Flipbook оставались перед ним; V текстуры — вниз
+    const FVector3f TangentX(PaperAxisX);
+    const FVector3f TangentZ(-PaperAxisZ);
+    const FColor VertexColor = SpriteColor.ToFColor(false);
+    const float Depth = ImpostorBox.Min.Y;
+
+    const uint32 BaseVertex = OutData.Vertices.Num();
+    auto AddVertex = [&](double X, double Z, float U, float V)
+    {
+        const FVector LocalPosition(X, Depth, Z);
+        OutData.LocalBox += LocalPosition;
+        OutData.Vertices.Emplace(FVector3f(LocalPosition), TangentX, TangentZ, FVector2f(U, V), VertexColor);
+    };
+
+    AddVertex(ImpostorBox.Min.X, ImpostorBox.Max.Z, 0.0f, 0.0f);
+    AddVertex(ImpostorBox.Max.X, ImpostorBox.Max.Z, 1.0f, 0.0f);
+    AddVertex(ImpostorBox.Min.X, ImpostorBox.Min.Z, 0.0f, 1.0f);
+    AddVertex(ImpostorBox.Max.X, ImpostorBox.Min.Z, 1.0f, 1.0f);
+
+    OutData.Indices.Append({ BaseVertex, BaseVertex + 2, BaseVertex + 1, BaseVertex + 1, BaseVertex + 2, BaseVertex + 3 });
+    Section.MaxVertexIndex = OutData.Vertices.Num() - 1;
+}
+
+void UCharacter2DLayeredSpriteComponent::RebuildAtlasLookup()
+{
+    AtlasFrameLookup.Reset();
+
+    if (!SourceAsset || !SourceAsset->CanUseSpriteAtlas())
+    {
+        return;
+    }
+
+    // Ключ — путь: спрайты кадров не обязаны быть загружены
+    const TArray<FCharacter2DAtlasFrame>& Frames = SourceAsset->SpriteAtlas.Frames;
+    AtlasFrameLookup.Reserve(Frames.Num());
+    for (int32 FrameIndex = 0; FrameIndex < Frames.Num(); ++FrameIndex)
+    {
+        if (Frames[FrameIndex].Material)
+        {
+            AtlasFrameLookup.Add(Frames[FrameIndex].SourceSprite, FrameIndex);
+        }
+    }
+}
+
+int32 UCharacter2DLayeredSpriteComponent::FindAtlasFrame(const FSoftObjectPath& SpritePath) const
+{
+    const int32* FrameIndex = SpritePath.IsNull() ? nullptr : AtlasFrameLookup.Find(SpritePath);
+    return FrameIndex ? *FrameIndex : INDEX_NONE;
+}
+
+void UCharacter2DLayeredSpriteComponent::ResolveExpressionSprite(FCharacter2DLayeredSpriteLayer& Layer) const
+{
+    // Без кадра в атласе (атлас устарел или спрайт в него не вошёл) — запечённая геометрия спрайта
+    Layer.ExpressionAtlasFrame = FindAtlasFrame(Layer.ExpressionSpritePath);
+    Layer.ExpressionSprite = Layer.ExpressionAtlasFrame == INDEX_NONE && !Layer.ExpressionSpritePath.IsNull()
+        ? Cast<UPaperSprite>(Layer.ExpressionSpritePath.TryLoad())
+        : nullptr;
+}
+
+void UCharacter2DLayeredSpriteComponent::ResolveFlipbookFrames(FCharacter2DLayeredSpriteLayer& Layer) const
+{
+    // Кадры Flipbook сопоставляются с атласом один раз на запуск, а не на каждый кадр
+    Layer.FlipbookAtlasFrames.Reset();
+    if (!Layer.Flipbook || !IsUsingSpriteAtlas())
+    {
+        return;
+    }
+
+    Layer.FlipbookAtlasFrames.SetNumUninitialized(Layer.Flipbook->GetNumKeyFrames());
+    for (int32 KeyFrame = 0; KeyFrame < Layer.FlipbookAtlasFrames.Num(); ++KeyFrame)
+    {
+        const UPaperSprite* FrameSprite = Layer.Flipbook->GetKeyFrameChecked(KeyFrame).Sprite;
+        Layer.FlipbookAtlasFrames[KeyFrame] = FrameSprite ? FindAtlasFrame(FSoftObjectPath(FrameSprite)) : INDEX_NONE;
+    }
+}
+
+UMaterialInterface* UCharacter2DLayeredSpriteComponent::GetSpriteBaseMaterial(UMaterialInterface* DefaultMaterial) const
+{
+    return (OverrideMaterials.Num() > 0 && OverrideMaterials[0])
+        ? OverrideMaterials[0].Get()
+        : DefaultMaterial;
+}
+
+UMaterialInterface* UCharacter2DLayeredSpriteComponent::GetOrCreateTextureMaterial(UMaterialInterface* BaseMaterial, UTexture* Texture)
+{
+    if (!BaseMaterial)
+    {
+        BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+    }
+
+    if (!Texture)
+    {
+        return BaseMaterial;
+    }
+
+    for (int32 Index = 0; Index < TextureMaterialKeys.Num(); ++Index)
+    {
+        if (TextureMaterialKeys[Index].Key == BaseMaterial && TextureMaterialKeys[Index].Value == Texture)
+        {
+            return TextureMaterials[Index];
+        }
+    }
+
+    UMaterialInstanceDynamic* TextureMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+    TextureMaterial->SetTextureParameterValue(SpriteTextureParameterName, Texture);
+
+    TextureMaterials.Add(TextureMaterial);
+    TextureMaterialKeys.Emplace(BaseMaterial, Texture);
+    return TextureMaterial;
+}
+
+void UCharacter2DLayeredSpriteComponent::SendRenderDynamicData_Concurrent()
+{
+    Super::SendRenderDynamicData_Concurrent();
+
+    if (!SceneProxy || !(bPendingUploadAll || bPendingColorUpload || PendingLayerUploads.Contains(true)))
+    {
+        return;
+    }
+
+    // В proxy уходят только изменившиеся позиции/UV; индексы и секции у него уже есть
+    FCharacter2DLayeredSpriteVertexUpdate Update;
+    auto AddRange = [this, &Update](uint32 FirstVertex, uint32 NumVertices)
+    {
+        Update.Ranges.Emplace(FirstVertex, NumVertices);
+        for (uint32 Index = FirstVertex; Index < FirstVertex + NumVertices; ++Index)
+        {
+            Update.Positions.Add(RenderData.Vertices[Index].Position);
+            Update.UVs.Add(RenderData.Vertices[Index].TextureCoordinate[0]);
+        }
+    };
+
+    if (bPendingUploadAll)
+    {
+        AddRange(0, RenderData.Vertices.Num());
+    }
+    else
+    {
+        for (TConstSetBitIterator<> It(PendingLayerUploads); It; ++It)
+        {
+            const FCharacter2DLayeredSpriteLayerRange& Range = RenderData.LayerRanges[It.GetIndex()];
+            if (Range.NumVertices > 0)
+            {
+                AddRange(Range.FirstVertex, Range.NumVertices);
+            }
+        }
+    }
+    if (bPendingColorUpload)
+    {
+        Update.Color = SpriteColor.ToFColor(false);
+    }
+
+    bPendingUploadAll = false;
+    bPendingColorUpload = false;
+    PendingLayerUploads.Init(false, Layers.Num());
+
+    FCharacter2DLayeredSpriteSceneProxy* Proxy = static_cast<FCharacter2DLayeredSpriteSceneProxy*>(SceneProxy);
+    ENQUEUE_RENDER_COMMAND(FSendCharacter2DLayeredSpriteVertices)(
+        [Proxy, Update = MoveTemp(Update)](FRHICommandListImmediate& RHICmdList)
+        {
+            Proxy->UpdateVertices_RenderThread(RHICmdList, Update);
+        });
+}
+
+FPrimitiveSceneProxy* UCharacter2DLayeredSpriteComponent::CreateSceneProxy()
+{
+    // Новый proxy создаёт буферы из текущих вершин — ожидающие обновления уже в них
+    bPendingUploadAll = false;
+    bPendingColorUpload = false;
+    PendingLayerUploads.Init(false, Layers.Num());
+    return RenderData.Indices.IsEmpty() ? nullptr : new FCharacter2DLayeredSpriteSceneProxy(this, RenderData);
+}
+
+FBoxSphereBounds UCharacter2DLayeredSpriteComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+    if (RenderData.LocalBox.IsValid)
+    {
+        return FBoxSphereBounds(RenderData.LocalBox).TransformBy(LocalToWorld);
+    }
+    return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+}
+
+void UCharacter2DLayeredSpriteComponent::GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials) const
+{
+    for (const FCharacter2DLayeredSpriteSection& Section : RenderData.Sections)
+    {
+        if (Section.Material)
+        {
+            OutMaterials.AddUnique(Section.Material);
+        }
+    }
+}
+
+UMaterialInterface* UCharacter2DLayeredSpriteComponent::GetMaterial(int32 MaterialIndex) const
+{
+    if (OverrideMaterials.IsValidIndex(MaterialIndex) && OverrideMaterials[MaterialIndex])
+    {
+        return OverrideMaterials[MaterialIndex];
+    }
+
+    for (const FCharacter2DLayeredSpriteLayer& Layer : Layers)
+    {
+        if (Layer.AtlasFrame != INDEX_NONE)
+        {
+            return SourceAsset->SpriteAtlas.Frames[Layer.AtlasFrame].Material;
+        }
+        if (Layer.Sprite)
+        {
+            return Layer.Sprite->GetDefaultMaterial();
+        }
+    }
+    return nullptr;
+}
+
+int32 UCharacter2DLayeredSpriteComponent::GetNumMaterials() const
+{
+    return 1;
+}
+
+/* ====================================================================== */
+/*                           Flipbook Playback                            */
+/* ====================================================================== */
+
+void UCharacter2DLayeredSpriteComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    AdvanceFlipbooks(DeltaTime);
+    UpdateTickEnabled();
+}
+
+void UCharacter2DLayeredSpriteComponent::AdvanceFlipbooks(float DeltaTime)
+{
+    bool bRebuild = false;
+
+    for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+    {
+        FCharacter2DLayeredSpriteLayer& Layer = Layers[LayerIndex];
+        if (!Layer.bPlaying || !Layer.Flipbook)
+        {
+            continue;
+        }
+
+        const float TotalDuration = Layer.Flipbook->GetTotalDuration();
+        Layer.PlaybackTime += DeltaTime * Layer.PlayRate;
+        if (Layer.PlaybackTime >= TotalDuration)
+        {
+            // Без зацикливания держим последний кадр до StopLayerFlipbook, как UPaperFlipbookComponent
+            Layer.PlaybackTime = (Layer.bLooping && TotalDuration > 0.0f)
+                ? FMath::Fmod(Layer.PlaybackTime, TotalDuration)
+                : TotalDuration;
+        }
+
+        const int32 NewFrameIndex = Layer.Flipbook->GetKeyFrameIndexAtTime(Layer.PlaybackTime, true);
+        if (NewFrameIndex != Layer.FrameIndex)
+        {
+            // Новый кадр того же размера — переписываются только вершины этого слоя
+            Layer.FrameIndex = NewFrameIndex;
+            bRebuild = bRebuild || !TryUpdateLayerGeometry(LayerIndex);
+        }
+    }
+
+    if (bRebuild)
+    {
+        RebuildRenderData();
+    }
+}
+
+void UCharacter2DLayeredSpriteComponent::UpdateTickEnabled()
+{
+    bool bNeedsTick = false;
+    for (const FCharacter2DLayeredSpriteLayer& Layer : Layers)
+    {
+        if (Layer.bPlaying && Layer.Flipbook &&
+            (Layer.bLooping || Layer.PlaybackTime < Layer.Flipbook->GetTotalDuration()))
+        {
+            bNeedsTick = true;
+            break;
+        }
+    }
+    SetComponentTickEnabled(bNeedsTick && !bFlipbooksPaused);
+}
+
+void UCharacter2DLayeredSpriteComponent::SetFlipbooksPaused(bool bPaused)
+{
+    if (bFlipbooksPaused != bPaused)
+    {
+        bFlipbooksPaused = bPaused;
+        UpdateTickEnabled();
+    }
+}
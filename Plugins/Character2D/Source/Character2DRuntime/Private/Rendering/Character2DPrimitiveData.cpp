@@ -0,0 +1,40 @@
+#include "Rendering/Character2DPrimitiveData.h"
+#include "Components/PrimitiveComponent.h"
+
+bool Character2DPrimitiveData::CanRunEmotionOnGpu(const FCharacter2DEmotionSettings& Settings)
+{
+    return Settings.AnimationCurve == nullptr;
+}
+
+void Character2DPrimitiveData::WriteEmotion(UPrimitiveComponent* Component, ECharacter2DEmotionEffect Type, const FCharacter2DEmotionSettings& Settings, float StartTime)
+{
+    if (!Component)
+    {
+        return;
+    }
+
+    Component->SetCustomPrimitiveDataFloat(EmotionType, static_cast<float>(Type));
+    Component->SetCustomPrimitiveDataFloat(EmotionStartTime, StartTime);
+    Component->SetCustomPrimitiveDataFloat(EmotionDuration, Settings.Duration);
+    Component->SetCustomPrimitiveDataFloat(EmotionIntensity, Settings.Intensity);
+    Component->SetCustomPrimitiveDataFloat(EmotionFrequency, Settings.ShakeFrequency);
+    Component->SetCustomPrimitiveDataFloat(EmotionEasing, static_cast<float>(Settings.Easing));
+    Component->SetCustomPrimitiveDataFloat(EmotionLoop, Settings.bLoop ? 1.0f : 0.0f);
+    Component->SetCustomPrimitiveDataVector4(EmotionColor, FVector4(Settings.TargetColor));
+}
+
+void Character2DPrimitiveData::ClearEmotion(UPrimitiveComponent* Component)
+{
+    if (Component)
+    {
+        Component->SetCustomPrimitiveDataFloat(EmotionType, static_cast<float>(ECharacter2DEmotionEffect::None));
+    }
+}
+
+void Character2DPrimitiveData::WriteTint(UPrimitiveComponent* Component, const FLinearColor& InTint)
+{
+    if (Component)
+    {
+        Component->SetCustomPrimitiveDataVector4(Tint, FVector4(InTint));
+    }
+}
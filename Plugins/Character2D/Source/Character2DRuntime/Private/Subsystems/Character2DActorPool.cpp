@@ -0,0 +1,191 @@
+#include "Subsystems/Character2DActorPool.h"
+#include "Character2DActor.h"
+#include "Character2DAsset.h"
+#include "Character2DStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_Character2D_PoolHits);
+DEFINE_STAT(STAT_Character2D_PoolRetargets);
+DEFINE_STAT(STAT_Character2D_PoolMisses);
+DEFINE_STAT(STAT_Character2D_PooledActors);
+
+static TAutoConsoleVariable<int32> CVarPoolMaxFree(
+    TEXT("Character2D.Pool.MaxFree"),
+    32,
+    TEXT("Сколько свободных персонажей держит пул мира, лишние при Release уничтожаются"),
+    ECVF_Default);
+
+/* ====================================================================== */
+/*                              Subsystem                                 */
+/* ====================================================================== */
+
+UCharacter2DActorPool* UCharacter2DActorPool::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UCharacter2DActorPool>() : nullptr;
+}
+
+bool UCharacter2DActorPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacter2DActorPool::Deinitialize()
+{
+    // Актёры уходят вместе с миром
+    FreeActors.Reset();
+    UpdateStats();
+
+    Super::Deinitialize();
+}
+
+void UCharacter2DActorPool::UpdateStats() const
+{
+    SET_DWORD_STAT(STAT_Character2D_PooledActors, FreeActors.Num());
+}
+
+/* ====================================================================== */
+/*                            Acquire / Release                           */
+/* ====================================================================== */
+
+ACharacter2DActor* UCharacter2DActorPool::Acquire(UCharacter2DAsset* Asset, const FTransform& Transform, TSubclassOf<ACharacter2DActor> Class)
+{
+    if (!Asset)
+    {
+        return nullptr;
+    }
+
+    const UClass* ActorClass = Class ? Class.Get() : ACharacter2DActor::StaticClass();
+
+    bool bSameAsset = false;
+    const int32 Index = FindFree(Asset, ActorClass, bSameAsset);
+    if (Index == INDEX_NONE)
+    {
+        ++NumMisses;
+        INC_DWORD_STAT(STAT_Character2D_PoolMisses);
+        return SpawnActor(Asset, Transform, Class);
+    }
+
+    ACharacter2DActor* Actor = FreeActors[Index];
+    FreeActors.RemoveAtSwap(Index, EAllowShrinking::No);
+    UpdateStats();
+
+    ++NumHits;
+    INC_DWORD_STAT(STAT_Character2D_PoolHits);
+    if (!bSameAsset)
+    {
+        ++NumRetargets;
+        INC_DWORD_STAT(STAT_Character2D_PoolRetargets);
+    }
+
+    Actor->UnparkFromPool(Asset, Transform);
+    return Actor;
+}
+
+void UCharacter2DActorPool::Release(ACharacter2DActor* Actor)
+{
+    if (!IsValid(Actor) || Actor->IsInPool() || Actor->GetWorld() != GetWorld())
+    {
+        return;
+    }
+
+    if (FreeActors.Num() >= FMath::Max(CVarPoolMaxFree.GetValueOnGameThread(), 0))
+    {
+        Actor->Destroy();
+        return;
+    }
+
+    Actor->ParkInPool();
+    FreeActors.Add(Actor);
+    UpdateStats();
+}
+
+void UCharacter2DActorPool::Prewarm(UCharacter2DAsset* Asset, int32 Count, TSubclassOf<ACharacter2DActor> Class)
+{
+    if (!Asset || Count <= 0)
+    {
+        return;
+    }
+
+    const UClass* ActorClass = Class ? Class.Get() : ACharacter2DActor::StaticClass();
+    int32 NumReady = 0;
+    for (const ACharacter2DActor* Actor : FreeActors)
+    {
+        NumReady += IsValid(Actor) && Actor->GetClass() == ActorClass && Actor->CharacterAsset == Asset ? 1 : 0;
+    }
+
+    const int32 MaxFree = FMath::Max(CVarPoolMaxFree.GetValueOnGameThread(), 0);
+    for (int32 Num = NumReady; Num < Count && FreeActors.Num() < MaxFree; ++Num)
+    {
+        ACharacter2DActor* Actor = SpawnActor(Asset, FTransform::Identity, Class);
+        if (!Actor)
+        {
+            break;
+        }
+        Actor->ParkInPool();
+        FreeActors.Add(Actor);
+    }
+    UpdateStats();
+}
+
+void UCharacter2DActorPool::Trim(int32 MaxFree)
+{
+    while (FreeActors.Num() > FMath::Max(MaxFree, 0))
+    {
+        // Первыми уходят дольше всех лежавшие
+        ACharacter2DActor* Actor = FreeActors[0];
+        FreeActors.RemoveAt(0, EAllowShrinking::No);
+        if (IsValid(Actor))
+        {
+            Actor->Destroy();
+        }
+    }
+    UpdateStats();
+}
+
+int32 UCharacter2DActorPool::FindFree(const UCharacter2DAsset* Asset, const UClass* Class, bool& bOutSameAsset)
+{
+    // Свободных уничтожили снаружи (выгрузка уровня и т.п.)
+    FreeActors.RemoveAll([](const ACharacter2DActor* Actor) { return !IsValid(Actor); });
+
+    int32 AnyIndex = INDEX_NONE;
+    for (int32 Index = FreeActors.Num() - 1; Index >= 0; --Index)
+    {
+        const ACharacter2DActor* Actor = FreeActors[Index];
+        if (Actor->GetClass() != Class)
+        {
+            continue;
+        }
+        if (Actor->CharacterAsset == Asset)
+        {
+            bOutSameAsset = true;
+            return Index;
+        }
+        if (AnyIndex == INDEX_NONE)
+        {
+            AnyIndex = Index;
+        }
+    }
+
+    bOutSameAsset = false;
+    return AnyIndex;
+}
+
+ACharacter2DActor* UCharacter2DActorPool::SpawnActor(UCharacter2DAsset* Asset, const FTransform& Transform, TSubclassOf<ACharacter2DActor> Class)
+{
+    UWorld* World = GetWorld();
+    UClass* ActorClass = Class ? Class.Get() : ACharacter2DActor::StaticClass();
+
+    // Ассет задаётся до OnConstruction, иначе персонаж собирался бы дважды
+    ACharacter2DActor* Actor = World->SpawnActorDeferred<ACharacter2DActor>(
+        ActorClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (!Actor)
+    {
+        return nullptr;
+    }
+
+    Actor->CharacterAsset = Asset;
+    Actor->FinishSpawning(Transform);
+    return Actor;
+}
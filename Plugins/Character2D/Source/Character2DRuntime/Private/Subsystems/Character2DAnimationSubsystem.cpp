@@ -0,0 +1,716 @@
+#include "Subsystems/Character2DAnimationSubsystem.h"
+#include "Character2DActor.h"
+#include "Character2DStats.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_STAT(STAT_Character2D_BlinksFired);
+DEFINE_STAT(STAT_Character2D_BlinksPerSecond);
+DEFINE_STAT(STAT_Character2D_AnimationEvaluate);
+DEFINE_STAT(STAT_Character2D_AnimationCommit);
+DEFINE_STAT(STAT_Character2D_ActiveMoves);
+DEFINE_STAT(STAT_Character2D_ActiveFades);
+DEFINE_STAT(STAT_Character2D_ActiveEmotions);
+
+/* ====================================================================== */
+/*                              Subsystem                                 */
+/* ====================================================================== */
+
+UCharacter2DAnimationSubsystem* UCharacter2DAnimationSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UCharacter2DAnimationSubsystem>() : nullptr;
+}
+
+bool UCharacter2DAnimationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // Превью ассета в редакторе тоже анимируется (SCharacter2DActionPanel); обычный мир редактора уровней — нет
+    return WorldType == EWorldType::Game
+        || WorldType == EWorldType::PIE
+        || WorldType == EWorldType::EditorPreview
+        || WorldType == EWorldType::GamePreview;
+}
+
+void UCharacter2DAnimationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    TweenCurves.SetNum(TweenPool.GetCapacity());
+}
+
+void UCharacter2DAnimationSubsystem::Deinitialize()
+{
+    for (int32 Slot = 0; Slot < SlotActors.Num(); ++Slot)
+    {
+        if (!SlotActors[Slot].IsExplicitlyNull())
+        {
+            ReleaseSlot(Slot);
+        }
+    }
+    SlotLookup.Reset();
+    BlinkWheel.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacter2DAnimationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacter2DAnimationSubsystem, STATGROUP_Tickables);
+}
+
+int32 UCharacter2DAnimationSubsystem::GetNumActiveSlots() const
+{
+    int32 NumActive = 0;
+    for (const uint8 Channels : SlotChannels)
+    {
+        NumActive += Channels != 0 ? 1 : 0;
+    }
+    return NumActive;
+}
+
+/* ====================================================================== */
+/*                                 Slots                                  */
+/* ====================================================================== */
+
+int32 UCharacter2DAnimationSubsystem::FindSlot(ACharacter2DActor* Actor) const
+{
+    const int32* Slot = SlotLookup.Find(Actor);
+    return Slot ? *Slot : INDEX_NONE;
+}
+
+int32 UCharacter2DAnimationSubsystem::FindOrAddSlot(ACharacter2DActor* Actor)
+{
+    int32 Slot = FindSlot(Actor);
+    if (Slot != INDEX_NONE)
+    {
+        return Slot;
+    }
+
+    if (FreeSlots.Num() > 0)
+    {
+        Slot = FreeSlots.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Slot = SlotActors.AddDefaulted();
+        SlotChannels.AddZeroed();
+        SlotOutputs.AddZeroed();
+        SlotRandom.AddDefaulted();
+
+        MoveFrom.AddZeroed();
+        MoveTo.AddZeroed();
+        MoveTween.Add(INDEX_NONE);
+
+        FadeIn.AddZeroed();
+        FadeTween.Add(INDEX_NONE);
+
+        EmotionType.AddZeroed();
+        EmotionIntensity.AddZeroed();
+        EmotionColor.AddZeroed();
+        EmotionBaseLocation.AddZeroed();
+        EmotionBaseScale.AddZeroed();
+        EmotionOnGpu.AddZeroed();
+        EmotionTween.Add(INDEX_NONE);
+
+        BlinkCookie.AddZeroed();
+        BlinkFireTick.AddZeroed();
+        BlinkRemaining.AddZeroed();
+        BlinkRestorePhase.AddZeroed();
+        BlinkPaused.AddZeroed();
+
+        OutLocation.AddZeroed();
+        OutScale.AddZeroed();
+        OutColor.AddZeroed();
+        OutOpacity.AddZeroed();
+    }
+
+    SlotActors[Slot] = Actor;
+    SlotChannels[Slot] = 0;
+    SlotOutputs[Slot] = 0;
+    BlinkPaused[Slot] = false;
+    SlotRandom[Slot].Initialize(static_cast<int32>(GetTypeHash(Actor->GetFName())) ^ Slot);
+    SlotLookup.Add(Actor, Slot);
+    return Slot;
+}
+
+void UCharacter2DAnimationSubsystem::ReleaseSlot(int32 Slot)
+{
+    SlotLookup.Remove(SlotActors[Slot]);
+    SlotActors[Slot] = nullptr;
+    SlotChannels[Slot] = 0;
+    SlotOutputs[Slot] = 0;
+    // Таймер прошлого владельца слота не должен сработать на новом
+    ++BlinkCookie[Slot];
+    ReleaseTween(MoveTween[Slot]);
+    ReleaseTween(FadeTween[Slot]);
+    ReleaseTween(EmotionTween[Slot]);
+    FreeSlots.Add(Slot);
+}
+
+FCharacter2DTween* UCharacter2DAnimationSubsystem::AcquireTween(int32& Handle)
+{
+    if (Handle == INDEX_NONE)
+    {
+        Handle = TweenPool.Acquire();
+        if (Handle == INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Character2D: tween pool exhausted (%d), animation applied instantly"), TweenPool.GetCapacity());
+            return nullptr;
+        }
+    }
+    return &TweenPool[Handle];
+}
+
+void UCharacter2DAnimationSubsystem::ReleaseTween(int32& Handle)
+{
+    if (Handle != INDEX_NONE)
+    {
+        TweenCurves[Handle] = nullptr;
+        TweenPool.Release(Handle);
+        Handle = INDEX_NONE;
+    }
+}
+
+void UCharacter2DAnimationSubsystem::SetTweenCurve(int32 Handle, const UCurveFloat* Curve)
+{
+    TweenCurves[Handle] = const_cast<UCurveFloat*>(Curve);
+}
+
+void UCharacter2DAnimationSubsystem::Unregister(ACharacter2DActor* Actor)
+{
+    const int32 Slot = FindSlot(Actor);
+    if (Slot != INDEX_NONE)
+    {
+        ReleaseSlot(Slot);
+    }
+}
+
+/* ====================================================================== */
+/*                               Channels                                 */
+/* ====================================================================== */
+
+namespace
+{
+    /** Curve — кривая настроек ассета по умолчанию; сравнение указателей, без кэша таблиц */
+    template <typename SettingsType>
+    bool IsAssetCurve(const ACharacter2DActor* Actor, const UCurveFloat* Curve, SettingsType FCharacter2DVisualNovelSettings::* DefaultSettings)
+    {
+        return Curve && Actor && Actor->CharacterAsset && (Actor->CharacterAsset->VisualNovelSettings.*DefaultSettings).AnimationCurve == Curve;
+    }
+}
+
+bool UCharacter2DAnimationSubsystem::StartMovement(ACharacter2DActor* Actor, const FVector& From, const FVector& To, const FCharacter2DMovementSettings& Settings)
+{
+    const int32 Slot = FindOrAddSlot(Actor);
+    FCharacter2DTween* Tween = AcquireTween(MoveTween[Slot]);
+    if (!Tween)
+    {
+        return false;
+    }
+
+    Tween->Start(Settings.Duration, Settings.Easing, Settings.AnimationCurve);
+    SetTweenCurve(MoveTween[Slot], Settings.AnimationCurve);
+    Tween->bAssetCurve = IsAssetCurve(Actor, Settings.AnimationCurve, &FCharacter2DVisualNovelSettings::DefaultMovementSettings);
+    Tween->Time = StartOffset;
+    MoveFrom[Slot] = From;
+    MoveTo[Slot] = To;
+    SlotChannels[Slot] |= Channel_Movement;
+    return true;
+}
+
+void UCharacter2DAnimationSubsystem::StopMovement(ACharacter2DActor* Actor)
+{
+    const int32 Slot = FindSlot(Actor);
+    if (Slot != INDEX_NONE)
+    {
+        SlotChannels[Slot] &= ~Channel_Movement;
+        ReleaseTween(MoveTween[Slot]);
+    }
+}
+
+bool UCharacter2DAnimationSubsystem::StartFade(ACharacter2DActor* Actor, bool bFadeIn, float Duration, ECharacter2DEasing Easing, const UCurveFloat* Curve)
+{
+    const int32 Slot = FindOrAddSlot(Actor);
+    FCharacter2DTween* Tween = AcquireTween(FadeTween[Slot]);
+    if (!Tween)
+    {
+        return false;
+    }
+
+    // Fade out проигрывает кривую fade in в обратную сторону
+    Tween->Start(Duration, Easing, Curve, false, !bFadeIn);
+    SetTweenCurve(FadeTween[Slot], Curve);
+    Tween->Time = StartOffset;
+    FadeIn[Slot] = bFadeIn;
+    SlotChannels[Slot] |= Channel_Fade;
+    return true;
+}
+
+void UCharacter2DAnimationSubsystem::StopFade(ACharacter2DActor* Actor)
+{
+    const int32 Slot = FindSlot(Actor);
+    if (Slot != INDEX_NONE)
+    {
+        SlotChannels[Slot] &= ~Channel_Fade;
+        ReleaseTween(FadeTween[Slot]);
+    }
+}
+
+bool UCharacter2DAnimationSubsystem::StartEmotion(ACharacter2DActor* Actor, ECharacter2DEmotionEffect Type, const FCharacter2DEmotionSettings& Settings, const FVector& BaseLocation, const FVector& BaseScale, bool bOnGpu)
+{
+    const int32 Slot = FindOrAddSlot(Actor);
+    FCharacter2DTween* Tween = AcquireTween(EmotionTween[Slot]);
+    if (!Tween)
+    {
+        return false;
+    }
+
+    Tween->Start(Settings.Duration, Settings.Easing, Settings.AnimationCurve, Settings.bLoop);
+    SetTweenCurve(EmotionTween[Slot], Settings.AnimationCurve);
+    Tween->bAssetCurve = IsAssetCurve(Actor, Settings.AnimationCurve, &FCharacter2DVisualNovelSettings::DefaultEmotionSettings);
+    Tween->Time = StartOffset;
+    EmotionType[Slot] = Type;
+    EmotionIntensity[Slot] = Settings.Intensity;
+    EmotionColor[Slot] = Settings.TargetColor;
+    EmotionBaseLocation[Slot] = BaseLocation;
+    EmotionBaseScale[Slot] = BaseScale;
+    EmotionOnGpu[Slot] = bOnGpu;
+    SlotChannels[Slot] |= Channel_Emotion;
+    return true;
+}
+
+void UCharacter2DAnimationSubsystem::StopEmotion(ACharacter2DActor* Actor)
+{
+    const int32 Slot = FindSlot(Actor);
+    if (Slot != INDEX_NONE)
+    {
+        SlotChannels[Slot] &= ~Channel_Emotion;
+        ReleaseTween(EmotionTween[Slot]);
+    }
+}
+
+void UCharacter2DAnimationSubsystem::ScheduleBlink(ACharacter2DActor* Actor, float Delay)
+{
+    ScheduleBlinkTimer(FindOrAddSlot(Actor), Delay, false);
+}
+
+void UCharacter2DAnimationSubsystem::ScheduleBlinkRestore(ACharacter2DActor* Actor, float Duration)
+{
+    ScheduleBlinkTimer(FindOrAddSlot(Actor), Duration, true);
+}
+
+void UCharacter2DAnimationSubsystem::ScheduleBlinkTimer(int32 Slot, float Delay, bool bRestorePhase)
+{
+    ++BlinkCookie[Slot];
+    BlinkRestorePhase[Slot] = bRestorePhase;
+    SlotChannels[Slot] |= Channel_Blink;
+
+    if (BlinkPaused[Slot])
+    {
+        BlinkRemaining[Slot] = Delay;
+        return;
+    }
+    BlinkFireTick[Slot] = BlinkWheel.Schedule(Slot, BlinkCookie[Slot], Delay);
+}
+
+void UCharacter2DAnimationSubsystem::CancelBlink(ACharacter2DActor* Actor)
+{
+    const int32 Slot = FindSlot(Actor);
+    if (Slot != INDEX_NONE)
+    {
+        ++BlinkCookie[Slot];
+        SlotChannels[Slot] &= ~Channel_Blink;
+    }
+}
+
+void UCharacter2DAnimationSubsystem::SetBlinkPaused(ACharacter2DActor* Actor, bool bPaused)
+{
+    // Слот заводится и без активного моргания: пауза действует на следующий ScheduleBlink
+    const int32 Slot = bPaused ? FindOrAddSlot(Actor) : FindSlot(Actor);
+    if (Slot == INDEX_NONE || BlinkPaused[Slot] == bPaused)
+    {
+        return;
+    }
+
+    BlinkPaused[Slot] = bPaused;
+    if (!(SlotChannels[Slot] & Channel_Blink))
+    {
+        return;
+    }
+
+    if (bPaused)
+    {
+        // Запись в колесе устаревает, остаток ждёт снятия паузы
+        BlinkRemaining[Slot] = BlinkWheel.GetSecondsUntil(BlinkFireTick[Slot]);
+        ++BlinkCookie[Slot];
+    }
+    else
+    {
+        ScheduleBlinkTimer(Slot, BlinkRemaining[Slot], BlinkRestorePhase[Slot]);
+    }
+}
+
+void UCharacter2DAnimationSubsystem::FireDueBlinks(float DeltaTime)
+{
+    DueBlinks.Reset();
+    BlinkWheel.Advance(DeltaTime, DueBlinks);
+
+    // Колбэки сразу ставят следующий таймер; он попадёт в колесо, а не в этот массив
+    for (const FCharacter2DTimingWheel::FEntry& Entry : DueBlinks)
+    {
+        const int32 Slot = Entry.Id;
+        if (!SlotActors.IsValidIndex(Slot) || BlinkCookie[Slot] != Entry.Cookie || !(SlotChannels[Slot] & Channel_Blink))
+        {
+            continue;
+        }
+
+        ACharacter2DActor* Actor = SlotActors[Slot].Get();
+        SlotChannels[Slot] &= ~Channel_Blink;
+        if (!Actor)
+        {
+            continue;
+        }
+
+        INC_DWORD_STAT(STAT_Character2D_BlinksFired);
+        ++BlinksThisSecond;
+        if (BlinkRestorePhase[Slot])
+        {
+            Actor->FinishBlink();
+        }
+        else
+        {
+            Actor->HandleBlink();
+        }
+    }
+}
+
+/* ====================================================================== */
+/*                               Snapshot                                 */
+/* ====================================================================== */
+
+void UCharacter2DAnimationSubsystem::CaptureSlotState(const ACharacter2DActor* Actor, FCharacter2DAnimationSlotState& OutState) const
+{
+    OutState = FCharacter2DAnimationSlotState();
+    // Только поиск по ключу, актёр не меняется
+    const int32 Slot = FindSlot(const_cast<ACharacter2DActor*>(Actor));
+    if (Slot == INDEX_NONE)
+    {
+        return;
+    }
+
+    const uint8 Channels = SlotChannels[Slot];
+    if (Channels & Channel_Movement)
+    {
+        OutState.bMoving = true;
+        OutState.Move = TweenPool[MoveTween[Slot]];
+        OutState.MoveCurve = TweenCurves[MoveTween[Slot]];
+        OutState.MoveFrom = MoveFrom[Slot];
+        OutState.MoveTo = MoveTo[Slot];
+    }
+    if (Channels & Channel_Fade)
+    {
+        OutState.bFading = true;
+        OutState.Fade = TweenPool[FadeTween[Slot]];
+        OutState.FadeCurve = TweenCurves[FadeTween[Slot]];
+        OutState.bFadeIn = FadeIn[Slot];
+    }
+    if (Channels & Channel_Emotion)
+    {
+        OutState.bEmotion = true;
+        OutState.Emotion = TweenPool[EmotionTween[Slot]];
+        OutState.EmotionCurve = TweenCurves[EmotionTween[Slot]];
+        OutState.EmotionType = EmotionType[Slot];
+        OutState.EmotionIntensity = EmotionIntensity[Slot];
+        OutState.EmotionColor = EmotionColor[Slot];
+        OutState.EmotionBaseLocation = EmotionBaseLocation[Slot];
+        OutState.EmotionBaseScale = EmotionBaseScale[Slot];
+        OutState.bEmotionOnGpu = EmotionOnGpu[Slot];
+    }
+    if (Channels & Channel_Blink)
+    {
+        OutState.bBlink = true;
+        OutState.BlinkRemaining = BlinkPaused[Slot] ? BlinkRemaining[Slot] : BlinkWheel.GetSecondsUntil(BlinkFireTick[Slot]);
+        OutState.bBlinkRestorePhase = BlinkRestorePhase[Slot];
+    }
+}
+
+bool UCharacter2DAnimationSubsystem::RestoreSlotState(ACharacter2DActor* Actor, const FCharacter2DAnimationSlotState& State)
+{
+    const bool bAnyChannel = State.bMoving || State.bFading || State.bEmotion || State.bBlink;
+    const int32 Slot = bAnyChannel ? FindOrAddSlot(Actor) : FindSlot(Actor);
+    if (Slot == INDEX_NONE)
+    {
+        return true;
+    }
+
+    // Твин канала переиспользуется: откат к соседней строке не ходит в пул
+    auto RestoreChannel = [this, Slot](bool bActive, EChannel Channel, int32& Handle, const FCharacter2DTween& Source, const TWeakObjectPtr<UCurveFloat>& SourceCurve)
+    {
+        if (!bActive)
+        {
+            SlotChannels[Slot] &= ~Channel;
+            ReleaseTween(Handle);
+            return true;
+        }
+        FCharacter2DTween* Tween = AcquireTween(Handle);
+        if (!Tween)
+        {
+            SlotChannels[Slot] &= ~Channel;
+            return false;
+        }
+        *Tween = Source;
+        // Таблица кривой живёт, пока жива сама кривая: её снова держит подсистема, а без неё твин идёт по Easing
+        const UCurveFloat* Curve = SourceCurve.Get();
+        if (!Curve)
+        {
+            Tween->Curve = nullptr;
+            Tween->bAssetCurve = false;
+        }
+        SetTweenCurve(Handle, Curve);
+        SlotChannels[Slot] |= Channel;
+        return true;
+    };
+
+    bool bRestored = RestoreChannel(State.bMoving, Channel_Movement, MoveTween[Slot], State.Move, State.MoveCurve);
+    MoveFrom[Slot] = State.MoveFrom;
+    MoveTo[Slot] = State.MoveTo;
+
+    bRestored &= RestoreChannel(State.bFading, Channel_Fade, FadeTween[Slot], State.Fade, State.FadeCurve);
+    FadeIn[Slot] = State.bFadeIn;
+
+    bRestored &= RestoreChannel(State.bEmotion, Channel_Emotion, EmotionTween[Slot], State.Emotion, State.EmotionCurve);
+    EmotionType[Slot] = State.EmotionType;
+    EmotionIntensity[Slot] = State.EmotionIntensity;
+    EmotionColor[Slot] = State.EmotionColor;
+    EmotionBaseLocation[Slot] = State.EmotionBaseLocation;
+    EmotionBaseScale[Slot] = State.EmotionBaseScale;
+    EmotionOnGpu[Slot] = State.bEmotionOnGpu;
+
+    if (State.bBlink)
+    {
+        ScheduleBlinkTimer(Slot, State.BlinkRemaining, State.bBlinkRestorePhase);
+    }
+    else
+    {
+        ++BlinkCookie[Slot];
+        SlotChannels[Slot] &= ~Channel_Blink;
+    }
+    return bRestored;
+}
+
+/* ====================================================================== */
+/*                                 Tick                                   */
+/* ====================================================================== */
+
+void UCharacter2DAnimationSubsystem::UpdateStats(float DeltaTime)
+{
+#if STATS
+    int32 NumMoves = 0;
+    int32 NumFades = 0;
+    int32 NumEmotions = 0;
+    for (const uint8 Channels : SlotChannels)
+    {
+        NumMoves += (Channels & Channel_Movement) ? 1 : 0;
+        NumFades += (Channels & Channel_Fade) ? 1 : 0;
+        NumEmotions += (Channels & Channel_Emotion) ? 1 : 0;
+    }
+    SET_DWORD_STAT(STAT_Character2D_ActiveMoves, NumMoves);
+    SET_DWORD_STAT(STAT_Character2D_ActiveFades, NumFades);
+    SET_DWORD_STAT(STAT_Character2D_ActiveEmotions, NumEmotions);
+
+    // Моргания за последнюю полную секунду: покадровый счётчик при 60+ fps почти всегда 0
+    BlinkStatWindow += DeltaTime;
+    if (BlinkStatWindow >= 1.0f)
+    {
+        SET_DWORD_STAT(STAT_Character2D_BlinksPerSecond, FMath::RoundToInt(BlinksThisSecond / BlinkStatWindow));
+        BlinksThisSecond = 0;
+        BlinkStatWindow = 0.0f;
+    }
+#endif
+}
+
+void UCharacter2DAnimationSubsystem::Tick(float DeltaTime)
+{
+    UpdateStats(DeltaTime);
+
+    const int32 NumSlots = SlotActors.Num();
+    if (NumSlots == 0)
+    {
+        BlinkWheel.Advance(DeltaTime, DueBlinks);
+        DueBlinks.Reset();
+        return;
+    }
+
+    // Расчёт: чистая математика по массивам, без обращения к актёрам
+    {
+        CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_AnimationEvaluate);
+        const EParallelForFlags Flags = NumSlots < ParallelSlotThreshold ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+        ParallelFor(NumSlots, [this, DeltaTime](int32 Slot)
+        {
+            EvaluateSlot(Slot, DeltaTime);
+        }, Flags);
+    }
+
+    // Применение: колбэки могут запускать новые анимации и добавлять слоты
+    CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_AnimationCommit);
+    for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        if (!SlotActors[Slot].IsExplicitlyNull() && !SlotActors[Slot].IsValid())
+        {
+            ReleaseSlot(Slot);
+        }
+        else if (SlotOutputs[Slot] != 0)
+        {
+            CommitSlot(Slot);
+        }
+    }
+
+    FireDueBlinks(DeltaTime);
+}
+
+void UCharacter2DAnimationSubsystem::EvaluateSlot(int32 Slot, float DeltaTime)
+{
+    uint8& Channels = SlotChannels[Slot];
+    uint16 Outputs = 0;
+
+    // Твины слота принадлежат только ему: параллельный проход пишет в разные элементы пула
+    if (Channels & Channel_Movement)
+    {
+        FCharacter2DTween& Tween = TweenPool[MoveTween[Slot]];
+        if (Tween.Advance(DeltaTime))
+        {
+            OutLocation[Slot] = MoveTo[Slot];
+            Channels &= ~Channel_Movement;
+            Outputs |= Output_MoveFinished;
+        }
+        else
+        {
+            OutLocation[Slot] = FMath::Lerp(MoveFrom[Slot], MoveTo[Slot], Tween.Evaluate());
+        }
+        Outputs |= Output_Location;
+    }
+
+    if (Channels & Channel_Fade)
+    {
+        FCharacter2DTween& Tween = TweenPool[FadeTween[Slot]];
+        if (Tween.Advance(DeltaTime))
+        {
+            Channels &= ~Channel_Fade;
+            Outputs |= Output_FadeFinished;
+        }
+        OutOpacity[Slot] = Tween.Evaluate();
+        Outputs |= Output_SpriteOpacity | Output_SkeletalOpacity;
+    }
+
+    if (Channels & Channel_Emotion)
+    {
+        FCharacter2DTween& Tween = TweenPool[EmotionTween[Slot]];
+        if (Tween.Advance(DeltaTime))
+        {
+            Channels &= ~Channel_Emotion;
+            Outputs |= Output_EmotionFinished;
+        }
+
+        const float Value = EmotionOnGpu[Slot] ? 0.0f : Tween.Evaluate();
+        const float Intensity = EmotionIntensity[Slot];
+
+        // Во время перемещения эмоция смещает текущую точку пути
+        const FVector BaseLocation = (Outputs & Output_Location) ? OutLocation[Slot] : EmotionBaseLocation[Slot];
+
+        switch (EmotionOnGpu[Slot] ? ECharacter2DEmotionEffect::None : EmotionType[Slot])
+        {
+        case ECharacter2DEmotionEffect::Shake:
+            {
+                const float ShakeAmount = Value * Intensity * 10.0f;
+                FRandomStream& Random = SlotRandom[Slot];
+                OutLocation[Slot] = BaseLocation + FVector(
+                    Random.FRandRange(-ShakeAmount, ShakeAmount),
+                    Random.FRandRange(-ShakeAmount, ShakeAmount),
+                    Random.FRandRange(-ShakeAmount, ShakeAmount));
+                Outputs |= Output_Location;
+            }
+            break;
+        case ECharacter2DEmotionEffect::Pulse:
+            OutScale[Slot] = EmotionBaseScale[Slot] * (1.0f + Value * Intensity * 0.2f);
+            Outputs |= Output_Scale;
+            break;
+        case ECharacter2DEmotionEffect::ColorShift:
+            OutColor[Slot] = FMath::Lerp(FLinearColor::White, EmotionColor[Slot], Value * Intensity);
+            Outputs |= Output_Color;
+            break;
+        case ECharacter2DEmotionEffect::Bounce:
+            OutLocation[Slot] = BaseLocation + FVector(0.0f, 0.0f, Value * Intensity * 50.0f);
+            Outputs |= Output_Location;
+            break;
+        case ECharacter2DEmotionEffect::Flash:
+            OutOpacity[Slot] = Value > 0.5f ? 1.0f : (0.3f + 0.7f * Intensity);
+            Outputs |= Output_SpriteOpacity;
+            break;
+        default:
+            break;
+        }
+    }
+
+    SlotOutputs[Slot] = Outputs;
+}
+
+void UCharacter2DAnimationSubsystem::CommitSlot(int32 Slot)
+{
+    ACharacter2DActor* Actor = SlotActors[Slot].Get();
+    const uint16 Outputs = SlotOutputs[Slot];
+    SlotOutputs[Slot] = 0;
+
+    // Завершившиеся твины возвращаются в пул на game thread
+    if (Outputs & Output_MoveFinished)
+    {
+        ReleaseTween(MoveTween[Slot]);
+    }
+    if (Outputs & Output_FadeFinished)
+    {
+        ReleaseTween(FadeTween[Slot]);
+    }
+    if (Outputs & Output_EmotionFinished)
+    {
+        ReleaseTween(EmotionTween[Slot]);
+    }
+
+    if (!Actor)
+    {
+        return;
+    }
+
+    if (Outputs & Output_Location)
+    {
+        Actor->SetActorLocation(OutLocation[Slot]);
+    }
+    if (Outputs & Output_Scale)
+    {
+        Actor->SetActorScale3D(OutScale[Slot]);
+    }
+    if (Outputs & Output_Color)
+    {
+        Actor->SetAllSpritesColor(OutColor[Slot]);
+    }
+    if (Outputs & Output_SpriteOpacity)
+    {
+        Actor->SetAllSpritesOpacity(OutOpacity[Slot]);
+    }
+    if (Outputs & Output_SkeletalOpacity)
+    {
+        Actor->SetAllSkeletalOpacity(OutOpacity[Slot]);
+    }
+
+    // События завершения — после применения последнего кадра
+    if (Outputs & Output_MoveFinished)
+    {
+        Actor->OnMovementFinished();
+    }
+    if (Outputs & Output_FadeFinished)
+    {
+        Actor->OnFadeFinished(FadeIn[Slot]);
+    }
+    if (Outputs & Output_EmotionFinished)
+    {
+        Actor->StopCurrentEmotion();
+    }
+}
@@ -0,0 +1,323 @@
+#include "Subsystems/Character2DDirector.h"
+#include "Subsystems/Character2DAnimationSubsystem.h"
+#include "Character2DActor.h"
+#include "Character2DStats.h"
+#include "Engine/World.h"
+#include "Misc/ScopeExit.h"
+
+DEFINE_STAT(STAT_Character2D_DirectorCommands);
+DEFINE_STAT(STAT_Character2D_DirectorCoalesced);
+DEFINE_STAT(STAT_Character2D_DirectorFlush);
+
+/* ====================================================================== */
+/*                              Subsystem                                 */
+/* ====================================================================== */
+
+UCharacter2DDirector* UCharacter2DDirector::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UCharacter2DDirector>() : nullptr;
+}
+
+bool UCharacter2DDirector::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacter2DDirector::Deinitialize()
+{
+    // Невыданные команды относятся к уходящему миру
+    Commands.Empty();
+    Drained.Empty();
+    Batches.Empty();
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacter2DDirector::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacter2DDirector, STATGROUP_Tickables);
+}
+
+/* ====================================================================== */
+/*                                Enqueue                                 */
+/* ====================================================================== */
+
+void UCharacter2DDirector::Enqueue(FCharacter2DCommand&& Command)
+{
+    if (Command.IssueTime < 0.0)
+    {
+        Command.IssueTime = GetCommandClock();
+    }
+    Commands.Enqueue(MoveTemp(Command));
+}
+
+void UCharacter2DDirector::Enqueue(ACharacter2DActor* Actor, ECharacter2DCommandType Type, TFunctionRef<void(FCharacter2DCommand&)> Setup)
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    FCharacter2DCommand Command;
+    Command.Actor = Actor;
+    Command.Type = Type;
+    Setup(Command);
+    Enqueue(MoveTemp(Command));
+}
+
+void UCharacter2DDirector::MoveTo(ACharacter2DActor* Actor, const FVector& Location, const FCharacter2DMovementSettings& Settings)
+{
+    Enqueue(Actor, ECharacter2DCommandType::Move, [&](FCharacter2DCommand& Command)
+    {
+        Command.Location = Location;
+        Command.Movement = Settings;
+    });
+}
+
+void UCharacter2DDirector::FadeIn(ACharacter2DActor* Actor, float Duration)
+{
+    Enqueue(Actor, ECharacter2DCommandType::FadeIn, [Duration](FCharacter2DCommand& Command) { Command.Duration = Duration; });
+}
+
+void UCharacter2DDirector::FadeOut(ACharacter2DActor* Actor, float Duration)
+{
+    Enqueue(Actor, ECharacter2DCommandType::FadeOut, [Duration](FCharacter2DCommand& Command) { Command.Duration = Duration; });
+}
+
+void UCharacter2DDirector::PlayEmotion(ACharacter2DActor* Actor, ECharacter2DEmotionEffect Emotion, const FCharacter2DEmotionSettings& Settings)
+{
+    Enqueue(Actor, ECharacter2DCommandType::Emotion, [&](FCharacter2DCommand& Command)
+    {
+        Command.Emotion = Emotion;
+        Command.EmotionSettings = Settings;
+    });
+}
+
+void UCharacter2DDirector::StopEmotion(ACharacter2DActor* Actor)
+{
+    Enqueue(Actor, ECharacter2DCommandType::StopEmotion, [](FCharacter2DCommand&) {});
+}
+
+void UCharacter2DDirector::SetBlinking(ACharacter2DActor* Actor, bool bEnable)
+{
+    Enqueue(Actor, ECharacter2DCommandType::Blinking, [bEnable](FCharacter2DCommand& Command) { Command.bEnable = bEnable; });
+}
+
+void UCharacter2DDirector::SetTalking(ACharacter2DActor* Actor, bool bEnable)
+{
+    Enqueue(Actor, ECharacter2DCommandType::Talking, [bEnable](FCharacter2DCommand& Command) { Command.bEnable = bEnable; });
+}
+
+void UCharacter2DDirector::SetExpression(ACharacter2DActor* Actor, FName Expression)
+{
+    Enqueue(Actor, ECharacter2DCommandType::Expression, [Expression](FCharacter2DCommand& Command) { Command.Expression = Expression; });
+}
+
+void UCharacter2DDirector::SetSpritesVisible(ACharacter2DActor* Actor, bool bVisible)
+{
+    Enqueue(Actor, ECharacter2DCommandType::SpritesVisible, [bVisible](FCharacter2DCommand& Command) { Command.bEnable = bVisible; });
+}
+
+void UCharacter2DDirector::SetSkeletalVisible(ACharacter2DActor* Actor, bool bVisible)
+{
+    Enqueue(Actor, ECharacter2DCommandType::SkeletalVisible, [bVisible](FCharacter2DCommand& Command) { Command.bEnable = bVisible; });
+}
+
+/* ====================================================================== */
+/*                                 Batch                                  */
+/* ====================================================================== */
+
+void UCharacter2DDirector::Tick(float DeltaTime)
+{
+    LastDeltaTime = DeltaTime;
+    PublishedWorldTime.store(GetWorld()->GetTimeSeconds(), std::memory_order_relaxed);
+    Flush();
+}
+
+double UCharacter2DDirector::GetCommandClock() const
+{
+    if (IsInGameThread())
+    {
+        if (const UWorld* World = GetWorld())
+        {
+            return World->GetTimeSeconds();
+        }
+    }
+    return PublishedWorldTime.load(std::memory_order_relaxed);
+}
+
+void UCharacter2DDirector::Flush()
+{
+    check(IsInGameThread());
+
+    // Flush из колбэка актёра (OnEmotionFinished) — новые команды дождутся следующего кадра
+    if (bFlushing)
+    {
+        return;
+    }
+
+    FCharacter2DCommand Command;
+    while (Commands.Dequeue(Command))
+    {
+        Drained.Add(MoveTemp(Command));
+    }
+    if (Drained.IsEmpty())
+    {
+        return;
+    }
+
+    CHARACTER2D_SCOPE_CYCLE_COUNTER(STAT_Character2D_DirectorFlush);
+    bFlushing = true;
+    ON_SCOPE_EXIT
+    {
+        Drained.Reset();
+        Batches.Reset();
+        bFlushing = false;
+    };
+
+    const int32 NumDropped = Coalesce();
+    NumCoalesced += NumDropped;
+    NumApplied += Drained.Num() - NumDropped;
+    INC_DWORD_STAT_BY(STAT_Character2D_DirectorCommands, Drained.Num() - NumDropped);
+    INC_DWORD_STAT_BY(STAT_Character2D_DirectorCoalesced, NumDropped);
+
+    // Команда старше кадра (выдана до паузы, на загрузке) не проматывается дальше одного кадра
+    const double ApplyTime = GetCommandClock();
+    for (const TPair<TWeakObjectPtr<ACharacter2DActor>, FPendingBatch>& Pair : Batches)
+    {
+        if (ACharacter2DActor* Actor = Pair.Key.Get())
+        {
+            ApplyBatch(Actor, Pair.Value, ApplyTime, LastDeltaTime);
+        }
+    }
+}
+
+int32 UCharacter2DDirector::Coalesce()
+{
+    int32 NumDropped = 0;
+    auto Replace = [&NumDropped](int32& Slot, int32 Index)
+    {
+        NumDropped += Slot != INDEX_NONE ? 1 : 0;
+        Slot = Index;
+    };
+
+    for (int32 Index = 0; Index < Drained.Num(); ++Index)
+    {
+        const FCharacter2DCommand& Command = Drained[Index];
+        FPendingBatch& Batch = Batches.FindOrAdd(Command.Actor);
+
+        switch (Command.Type)
+        {
+        case ECharacter2DCommandType::Move:
+            Replace(Batch.Move, Index);
+            break;
+        case ECharacter2DCommandType::FadeIn:
+        case ECharacter2DCommandType::FadeOut:
+            // Появление и исчезновение в одном кадре гасят друг друга: персонаж остаётся как был
+            if (Batch.Fade != INDEX_NONE && Drained[Batch.Fade].Type != Command.Type)
+            {
+                Batch.Fade = INDEX_NONE;
+                NumDropped += 2;
+            }
+            else
+            {
+                Replace(Batch.Fade, Index);
+            }
+            break;
+        case ECharacter2DCommandType::Emotion:
+        case ECharacter2DCommandType::StopEmotion:
+            Replace(Batch.Emotion, Index);
+            break;
+        case ECharacter2DCommandType::Blinking:
+            Replace(Batch.Blinking, Index);
+            break;
+        case ECharacter2DCommandType::Talking:
+            Replace(Batch.Talking, Index);
+            break;
+        case ECharacter2DCommandType::Expression:
+            Replace(Batch.Expression, Index);
+            break;
+        case ECharacter2DCommandType::SpritesVisible:
+            Replace(Batch.SpritesVisible, Index);
+            break;
+        case ECharacter2DCommandType::SkeletalVisible:
+            Replace(Batch.SkeletalVisible, Index);
+            break;
+        }
+    }
+    return NumDropped;
+}
+
+void UCharacter2DDirector::ApplyBatch(ACharacter2DActor* Actor, const FPendingBatch& Batch, double ApplyTime, float MaxCatchUp)
+{
+    UCharacter2DAnimationSubsystem* Animation = UCharacter2DAnimationSubsystem::Get(this);
+
+    // Твины, запущенные командой, стартуют с фазой, набежавшей с момента выдачи
+    auto WithStartOffset = [Animation, ApplyTime, MaxCatchUp](const FCharacter2DCommand& Command, TFunctionRef<void()> Apply)
+    {
+        const float Offset = FMath::Clamp(static_cast<float>(ApplyTime - Command.IssueTime), 0.0f, MaxCatchUp);
+        if (!Animation)
+        {
+            Apply();
+            return;
+        }
+        TGuardValue<float> Guard(Animation->StartOffset, Offset);
+        Apply();
+    };
+
+    // Сначала состояние, потом анимации: fade-in должен видеть уже включённые спрайты
+    if (Batch.SpritesVisible != INDEX_NONE)
+    {
+        Actor->SetSpritesVisible(Drained[Batch.SpritesVisible].bEnable);
+    }
+    if (Batch.SkeletalVisible != INDEX_NONE)
+    {
+        Actor->SetSkeletalVisible(Drained[Batch.SkeletalVisible].bEnable);
+    }
+    if (Batch.Expression != INDEX_NONE)
+    {
+        Actor->SetExpression(Drained[Batch.Expression].Expression);
+    }
+    if (Batch.Blinking != INDEX_NONE)
+    {
+        Actor->EnableBlinking(Drained[Batch.Blinking].bEnable);
+    }
+    if (Batch.Talking != INDEX_NONE)
+    {
+        Actor->EnableTalking(Drained[Batch.Talking].bEnable);
+    }
+
+    if (Batch.Move != INDEX_NONE)
+    {
+        const FCharacter2DCommand& Command = Drained[Batch.Move];
+        WithStartOffset(Command, [Actor, &Command]() { Actor->MoveToLocationWithSettings(Command.Location, Command.Movement); });
+    }
+    if (Batch.Fade != INDEX_NONE)
+    {
+        const FCharacter2DCommand& Command = Drained[Batch.Fade];
+        WithStartOffset(Command, [Actor, &Command]()
+        {
+            if (Command.Type == ECharacter2DCommandType::FadeIn)
+            {
+                Actor->PlayFadeIn(Command.Duration);
+            }
+            else
+            {
+                Actor->PlayFadeOut(Command.Duration);
+            }
+        });
+    }
+    if (Batch.Emotion != INDEX_NONE)
+    {
+        const FCharacter2DCommand& Command = Drained[Batch.Emotion];
+        if (Command.Type == ECharacter2DCommandType::StopEmotion)
+        {
+            Actor->StopCurrentEmotion();
+        }
+        else
+        {
+            WithStartOffset(Command, [Actor, &Command]() { Actor->PlayEmotion(Command.Emotion, Command.EmotionSettings); });
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include "Subsystems/Character2DImpostorSubsystem.h"
+#include "Character2DActor.h"
+#include "Engine/World.h"
+#include "Engine/SceneCapture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarImpostorEnable(
+    TEXT("Character2D.Impostor.Enable"),
+    true,
+    TEXT("Импосторы персонажей Character2D (0 — всегда рисовать слои)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarImpostorMaxBakesPerFrame(
+    TEXT("Character2D.Impostor.MaxBakesPerFrame"),
+    2,
+    TEXT("Сколько импосторов запекается за кадр, остальные ждут следующего"),
+    ECVF_Default);
+
+/* ====================================================================== */
+/*                              Subsystem                                 */
+/* ====================================================================== */
+
+UCharacter2DImpostorSubsystem* UCharacter2DImpostorSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UCharacter2DImpostorSubsystem>() : nullptr;
+}
+
+bool UCharacter2DImpostorSubsystem::IsEnabled()
+{
+    return CVarImpostorEnable.GetValueOnGameThread();
+}
+
+bool UCharacter2DImpostorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // В редакторе композиция меняется постоянно — только игра
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacter2DImpostorSubsystem::Deinitialize()
+{
+    PendingBakes.Reset();
+    FreeTargets.Reset();
+
+    if (IsValid(CaptureActor))
+    {
+        CaptureActor->Destroy();
+    }
+    CaptureActor = nullptr;
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacter2DImpostorSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacter2DImpostorSubsystem, STATGROUP_Tickables);
+}
+
+void UCharacter2DImpostorSubsystem::RequestBake(ACharacter2DActor* Actor)
+{
+    if (Actor)
+    {
+        PendingBakes.AddUnique(Actor);
+    }
+}
+
+void UCharacter2DImpostorSubsystem::CancelBake(ACharacter2DActor* Actor)
+{
+    PendingBakes.Remove(Actor);
+}
+
+/* ====================================================================== */
+/*                           Render Target Pool                           */
+/* ====================================================================== */
+
+UTextureRenderTarget2D* UCharacter2DImpostorSubsystem::AcquireTarget(FIntPoint Size)
+{
+    for (int32 Index = FreeTargets.Num() - 1; Index >= 0; --Index)
+    {
+        UTextureRenderTarget2D* Target = FreeTargets[Index];
+        if (Target && Target->SizeX == Size.X && Target->SizeY == Size.Y)
+        {
+            FreeTargets.RemoveAtSwap(Index, EAllowShrinking::No);
+            return Target;
+        }
+    }
+
+    // HDR со своей альфой: SCS_SceneColorHDR хранит в A инвертированное покрытие
+    UTextureRenderTarget2D* Target = NewObject<UTextureRenderTarget2D>(this);
+    Target->RenderTargetFormat = RTF_RGBA16f;
+    Target->ClearColor = FLinearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    Target->InitAutoFormat(Size.X, Size.Y);
+    Target->UpdateResourceImmediate(true);
+    return Target;
+}
+
+void UCharacter2DImpostorSubsystem::ReleaseTarget(UTextureRenderTarget2D* Target)
+{
+    if (!Target)
+    {
+        return;
+    }
+
+    if (FreeTargets.Num() >= MaxPooledTargets)
+    {
+        // Самая старая свободная цель уходит в GC
+        FreeTargets.RemoveAt(0, EAllowShrinking::No);
+    }
+    FreeTargets.Add(Target);
+}
+
+/* ====================================================================== */
+/*                                 Bake                                   */
+/* ====================================================================== */
+
+ASceneCapture2D* UCharacter2DImpostorSubsystem::GetOrCreateCapture()
+{
+    if (IsValid(CaptureActor))
+    {
+        return CaptureActor;
+    }
+
+    FActorSpawnParameters Params;
+    Params.ObjectFlags |= RF_Transient;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    CaptureActor = GetWorld()->SpawnActor<ASceneCapture2D>(Params);
+    if (!CaptureActor)
+    {
+        return nullptr;
+    }
+
+    USceneCaptureComponent2D* Capture = CaptureActor->GetCaptureComponent2D();
+    Capture->bCaptureEveryFrame = false;
+    Capture->bCaptureOnMovement = false;
+    Capture->ProjectionType = ECameraProjectionMode::Orthographic;
+    Capture->CaptureSource = ESceneCaptureSource::SCS_SceneColorHDR;
+    Capture->PrimitiveRenderMode = ESceneCapturePrimitiveRenderMode::PRM_UseShowOnlyList;
+    Capture->ShowFlags.SetAtmosphere(false);
+    Capture->ShowFlags.SetFog(false);
+    Capture->ShowFlags.SetVolumetricFog(false);
+    Capture->ShowFlags.SetMotionBlur(false);
+    return CaptureActor;
+}
+
+bool UCharacter2DImpostorSubsystem::Bake(ACharacter2DActor& Actor)
+{
+    if (!Actor.CanUseImpostor())
+    {
+        return false;
+    }
+
+    FBox LocalBox(ForceInit);
+    TArray<UPrimitiveComponent*> Components;
+    Actor.GatherImpostorComposition(LocalBox, Components);
+    if (!LocalBox.IsValid || Components.IsEmpty())
+    {
+        return false;
+    }
+
+    ASceneCapture2D* Capture = GetOrCreateCapture();
+    if (!Capture)
+    {
+        return false;
+    }
+
+    // Композиция в пространстве LayeredSprite: X — вправо, Z — вверх, +Y — к камере
+    const FTransform& SpriteToWorld = Actor.LayeredSprite->GetComponentTransform();
+    const FVector Scale = SpriteToWorld.GetScale3D().GetAbs();
+    const FVector LocalSize = LocalBox.GetSize();
+    const FVector2D WorldSize(FMath::Max(LocalSize.X * Scale.X, 1.0), FMath::Max(LocalSize.Z * Scale.Z, 1.0));
+
+    // Большие персонажи снимаются с меньшей плотностью, чтобы уложиться в MaxTargetSize
+    const double Density = FMath::Min3(static_cast<double>(Actor.ImpostorTexelDensity), MaxTargetSize / WorldSize.X, MaxTargetSize / WorldSize.Y);
+    const FIntPoint TargetSize(
+        FMath::Clamp(FMath::DivideAndRoundUp(FMath::CeilToInt(WorldSize.X * Density), TargetSizeStep) * TargetSizeStep, TargetSizeStep, MaxTargetSize),
+        FMath::Clamp(FMath::DivideAndRoundUp(FMath::CeilToInt(WorldSize.Y * Density), TargetSizeStep) * TargetSizeStep, TargetSizeStep, MaxTargetSize));
+
+    // Область расширяется под пропорции цели, чтобы пиксели оставались квадратными
+    const FVector Center = LocalBox.GetCenter();
+    const double HalfX = 0.5 * TargetSize.X / (Density * Scale.X);
+    const double HalfZ = 0.5 * TargetSize.Y / (Density * Scale.Z);
+    LocalBox.Min.X = Center.X - HalfX;
+    LocalBox.Max.X = Center.X + HalfX;
+    LocalBox.Min.Z = Center.Z - HalfZ;
+    LocalBox.Max.Z = Center.Z + HalfZ;
+
+    UTextureRenderTarget2D* Target = AcquireTarget(TargetSize);
+
+    const FVector CameraLocal(Center.X, LocalBox.Max.Y + LocalSize.Y + 100.0, Center.Z);
+    const FQuat LookAlongMinusY = FRotator(0.0, -90.0, 0.0).Quaternion();
+
+    USceneCaptureComponent2D* CaptureComponent = Capture->GetCaptureComponent2D();
+    CaptureComponent->SetWorldLocationAndRotation(
+        SpriteToWorld.TransformPosition(CameraLocal),
+        SpriteToWorld.GetRotation() * LookAlongMinusY);
+    CaptureComponent->OrthoWidth = 2.0 * HalfX * Scale.X;
+    CaptureComponent->TextureTarget = Target;
+    CaptureComponent->ClearShowOnlyComponents();
+    for (UPrimitiveComponent* Component : Components)
+    {
+        CaptureComponent->ShowOnlyComponent(Component);
+    }
+
+    // CaptureScene сам отправляет отложенные обновления примитивов, так что снимается текущая композиция
+    CaptureComponent->CaptureScene();
+    CaptureComponent->ClearShowOnlyComponents();
+    CaptureComponent->TextureTarget = nullptr;
+
+    Actor.ShowImpostor(Target, LocalBox);
+    return true;
+}
+
+/* ====================================================================== */
+/*                                 Tick                                   */
+/* ====================================================================== */
+
+void UCharacter2DImpostorSubsystem::Tick(float DeltaTime)
+{
+    if (PendingBakes.IsEmpty() || !IsEnabled())
+    {
+        return;
+    }
+
+    const int32 MaxBakes = FMath::Max(CVarImpostorMaxBakesPerFrame.GetValueOnGameThread(), 1);
+    int32 NumBaked = 0;
+    while (!PendingBakes.IsEmpty() && NumBaked < MaxBakes)
+    {
+        // Порядок запросов сохраняется: первыми запекаются дольше всех ждавшие
+        TWeakObjectPtr<ACharacter2DActor> Actor = PendingBakes[0];
+        PendingBakes.RemoveAt(0, EAllowShrinking::No);
+
+        if (Actor.IsValid() && Bake(*Actor))
+        {
+            ++NumBaked;
+        }
+    }
+}
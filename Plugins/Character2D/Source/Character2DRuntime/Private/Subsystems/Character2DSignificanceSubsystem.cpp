@@ -0,0 +1,290 @@
+#include "Subsystems/Character2DSignificanceSubsystem.h"
+#include "Character2DActor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+
+/* ====================================================================== */
+/*                           Console Variables                            */
+/* ====================================================================== */
+
+static TAutoConsoleVariable<bool> CVarSignificanceEnable(
+    TEXT("Character2D.Significance.Enable"),
+    true,
+    TEXT("Уровни детализации Character2D по значимости (0 — все персонажи Full)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceUpdateInterval(
+    TEXT("Character2D.Significance.UpdateInterval"),
+    0.25f,
+    TEXT("Период пересчёта значимости, сек"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSignificanceMaxFull(
+    TEXT("Character2D.Significance.MaxFull"),
+    8,
+    TEXT("Бюджет персонажей уровня Full (-1 — без ограничения), остальные опускаются в Reduced"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSignificanceMaxReduced(
+    TEXT("Character2D.Significance.MaxReduced"),
+    32,
+    TEXT("Бюджет персонажей уровня Reduced (-1 — без ограничения), остальные опускаются в Dormant"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceReducedScreenSize(
+    TEXT("Character2D.Significance.ReducedScreenSize"),
+    0.15f,
+    TEXT("Размер на экране (доля высоты), ниже которого персонаж уходит в Reduced"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceDormantScreenSize(
+    TEXT("Character2D.Significance.DormantScreenSize"),
+    0.02f,
+    TEXT("Размер на экране (доля высоты), ниже которого персонаж уходит в Dormant"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceRenderedTolerance(
+    TEXT("Character2D.Significance.RenderedTolerance"),
+    0.5f,
+    TEXT("Сколько секунд без отрисовки персонаж ещё считается видимым"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceReducedBlinkIntervalScale(
+    TEXT("Character2D.Significance.ReducedBlinkIntervalScale"),
+    2.0f,
+    TEXT("Множитель интервала между морганиями на уровне Reduced"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceReducedFlipbookRate(
+    TEXT("Character2D.Significance.ReducedFlipbookRate"),
+    12.0f,
+    TEXT("Частота обновления Flipbook на уровне Reduced, раз в секунду (0 — каждый кадр)"),
+    ECVF_Default);
+
+/* ====================================================================== */
+/*                              Subsystem                                 */
+/* ====================================================================== */
+
+UCharacter2DSignificanceSubsystem* UCharacter2DSignificanceSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UCharacter2DSignificanceSubsystem>() : nullptr;
+}
+
+bool UCharacter2DSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // В редакторе и превью персонажи всегда Full
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacter2DSignificanceSubsystem::Deinitialize()
+{
+    Actors.Reset();
+    Tiers.Reset();
+    Scores.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacter2DSignificanceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacter2DSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+float UCharacter2DSignificanceSubsystem::GetReducedBlinkIntervalScale()
+{
+    return FMath::Max(CVarSignificanceReducedBlinkIntervalScale.GetValueOnGameThread(), 1.0f);
+}
+
+float UCharacter2DSignificanceSubsystem::GetReducedFlipbookTickInterval()
+{
+    const float Rate = CVarSignificanceReducedFlipbookRate.GetValueOnGameThread();
+    return Rate > 0.0f ? 1.0f / Rate : 0.0f;
+}
+
+void UCharacter2DSignificanceSubsystem::Register(ACharacter2DActor* Actor)
+{
+    if (Actor && !Actors.Contains(Actor))
+    {
+        Actors.Add(Actor);
+        Tiers.Add(ECharacter2DSignificanceTier::Full);
+        Scores.Add(0.0f);
+        RequestUpdate();
+    }
+}
+
+void UCharacter2DSignificanceSubsystem::Unregister(ACharacter2DActor* Actor)
+{
+    const int32 Index = Actors.IndexOfByKey(Actor);
+    if (Index != INDEX_NONE)
+    {
+        Actors.RemoveAtSwap(Index, EAllowShrinking::No);
+        Tiers.RemoveAtSwap(Index, EAllowShrinking::No);
+        Scores.RemoveAtSwap(Index, EAllowShrinking::No);
+    }
+}
+
+int32 UCharacter2DSignificanceSubsystem::GetNumInTier(ECharacter2DSignificanceTier Tier) const
+{
+    int32 Num = 0;
+    for (const ECharacter2DSignificanceTier ActorTier : Tiers)
+    {
+        Num += ActorTier == Tier ? 1 : 0;
+    }
+    return Num;
+}
+
+/* ====================================================================== */
+/*                                 Tick                                   */
+/* ====================================================================== */
+
+void UCharacter2DSignificanceSubsystem::Tick(float DeltaTime)
+{
+    const bool bEnabled = CVarSignificanceEnable.GetValueOnGameThread();
+    if (!bEnabled)
+    {
+        if (bWasEnabled)
+        {
+            ResetTiers();
+            bWasEnabled = false;
+        }
+        return;
+    }
+    bWasEnabled = true;
+
+    TimeUntilUpdate -= DeltaTime;
+    if (TimeUntilUpdate > 0.0f)
+    {
+        return;
+    }
+    TimeUntilUpdate = FMath::Max(CVarSignificanceUpdateInterval.GetValueOnGameThread(), 0.0f);
+
+    UpdateTiers();
+}
+
+void UCharacter2DSignificanceSubsystem::GatherViews(TArray<FViewInfo, TInlineAllocator<4>>& OutViews) const
+{
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* Controller = It->Get();
+        if (!Controller || !Controller->IsLocalController() || !Controller->PlayerCameraManager)
+        {
+            continue;
+        }
+
+        const FMinimalViewInfo& POV = Controller->PlayerCameraManager->GetCameraCacheView();
+        FViewInfo& View = OutViews.AddDefaulted_GetRef();
+        View.Location = POV.Location;
+        View.TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(POV.FOV, 1.0f, 170.0f) * 0.5f));
+        View.OrthoWidth = POV.ProjectionMode == ECameraProjectionMode::Orthographic ? FMath::Max(POV.OrthoWidth, 1.0f) : 0.0f;
+    }
+}
+
+float UCharacter2DSignificanceSubsystem::CalcScore(const ACharacter2DActor& Actor, TConstArrayView<FViewInfo> Views) const
+{
+    const float SpeakerBonus = Actor.IsActiveSpeaker() ? SpeakerScoreBonus : 0.0f;
+
+    // Не рисовался (вне кадра или перекрыт) — размер на экране не важен
+    if (!Actor.WasRecentlyRendered(CVarSignificanceRenderedTolerance.GetValueOnGameThread()))
+    {
+        return SpeakerBonus;
+    }
+
+    FVector Origin;
+    FVector Extent;
+    Actor.GetActorBounds(true, Origin, Extent);
+    const float Radius = Extent.Size();
+
+    float ScreenSize = 0.0f;
+    for (const FViewInfo& View : Views)
+    {
+        const float ViewSize = View.OrthoWidth > 0.0f
+            ? 2.0f * Radius / View.OrthoWidth
+            : Radius / FMath::Max(FVector::Dist(View.Location, Origin) * View.TanHalfFOV, UE_KINDA_SMALL_NUMBER);
+        ScreenSize = FMath::Max(ScreenSize, ViewSize);
+    }
+
+    return FMath::Min(ScreenSize, 1.0f) + SpeakerBonus;
+}
+
+void UCharacter2DSignificanceSubsystem::UpdateTiers()
+{
+    for (int32 Index = Actors.Num() - 1; Index >= 0; --Index)
+    {
+        if (!Actors[Index].IsValid())
+        {
+            Actors.RemoveAtSwap(Index, EAllowShrinking::No);
+            Tiers.RemoveAtSwap(Index, EAllowShrinking::No);
+            Scores.RemoveAtSwap(Index, EAllowShrinking::No);
+        }
+    }
+
+    TArray<FViewInfo, TInlineAllocator<4>> Views;
+    GatherViews(Views);
+    if (Views.IsEmpty())
+    {
+        // Некому смотреть (сервер, загрузка) — не трогаем персонажей
+        return;
+    }
+
+    for (int32 Index = 0; Index < Actors.Num(); ++Index)
+    {
+        Scores[Index] = CalcScore(*Actors[Index], Views);
+    }
+
+    TArray<int32, TInlineAllocator<64>> Order;
+    Order.Reserve(Actors.Num());
+    for (int32 Index = 0; Index < Actors.Num(); ++Index)
+    {
+        Order.Add(Index);
+    }
+    Order.Sort([this](int32 A, int32 B) { return Scores[A] > Scores[B]; });
+
+    const float ReducedScreenSize = CVarSignificanceReducedScreenSize.GetValueOnGameThread();
+    const float DormantScreenSize = CVarSignificanceDormantScreenSize.GetValueOnGameThread();
+    const int32 MaxFull = CVarSignificanceMaxFull.GetValueOnGameThread();
+    const int32 MaxReduced = CVarSignificanceMaxReduced.GetValueOnGameThread();
+
+    int32 NumFull = 0;
+    int32 NumReduced = 0;
+    for (const int32 Index : Order)
+    {
+        const float Score = Scores[Index];
+        ECharacter2DSignificanceTier Tier = Score >= ReducedScreenSize ? ECharacter2DSignificanceTier::Full
+            : Score >= DormantScreenSize ? ECharacter2DSignificanceTier::Reduced
+            : ECharacter2DSignificanceTier::Dormant;
+
+        // Бюджеты: лишние опускаются на уровень ниже в порядке убывания оценки
+        if (Tier == ECharacter2DSignificanceTier::Full && MaxFull >= 0 && NumFull >= MaxFull)
+        {
+            Tier = ECharacter2DSignificanceTier::Reduced;
+        }
+        if (Tier == ECharacter2DSignificanceTier::Reduced && MaxReduced >= 0 && NumReduced >= MaxReduced)
+        {
+            Tier = ECharacter2DSignificanceTier::Dormant;
+        }
+
+        NumFull += Tier == ECharacter2DSignificanceTier::Full ? 1 : 0;
+        NumReduced += Tier == ECharacter2DSignificanceTier::Reduced ? 1 : 0;
+
+        if (Tiers[Index] != Tier)
+        {
+            Tiers[Index] = Tier;
+            Actors[Index]->SetSignificanceTier(Tier);
+        }
+    }
+}
+
+void UCharacter2DSignificanceSubsystem::ResetTiers()
+{
+    for (int32 Index = 0; Index < Actors.Num(); ++Index)
+    {
+        if (Tiers[Index] != ECharacter2DSignificanceTier::Full && Actors[Index].IsValid())
+        {
+            Actors[Index]->SetSignificanceTier(ECharacter2DSignificanceTier::Full);
+        }
+        Tiers[Index] = ECharacter2DSignificanceTier::Full;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Animation/Character2DTween.h"
+
+class UCurveFloat;
+
+/**
+ * Общий на процесс кэш запечённых UCurveFloat.
+ * Кривые из FCharacter2DVisualNovelSettings разделяются сотнями персонажей:
+ * каждая запекается один раз, твины хранят указатель на таблицу.
+ *
+ * Ключ — FObjectKey (индекс + серийный номер): новая кривая по адресу или индексу
+ * удалённой не получит её таблицу. Таблицы удалённых кривых освобождаются после
+ * сборки мусора; кривые запущенных твинов держит UCharacter2DAnimationSubsystem.
+ * Правка кривой перезапекает таблицу на месте. Только game thread.
+ */
+class CHARACTER2DRUNTIME_API FCharacter2DCurveCache
+{
+public:
+    static FCharacter2DCurveCache& Get();
+
+    /** Подписка на правки кривых (FCharacter2DRuntimeModule) */
+    void Initialize();
+    void Shutdown();
+
+    /** Освобождает таблицы кривых, которых больше нет */
+    void PurgeStaleEntries();
+
+    /** Таблица кривой; запекается при первом обращении или после правки */
+    const FCharacter2DCurveLUT* FindOrBake(const UCurveFloat* Curve);
+
+    /** Перезапечь таблицу кривой, если она в кэше */
+    void Invalidate(const UCurveFloat* Curve);
+
+    int32 GetNumCached() const { return Entries.Num(); }
+    uint64 GetNumHits() const { return NumHits; }
+    uint64 GetNumMisses() const { return NumMisses; }
+
+private:
+    struct FEntry
+    {
+        TUniquePtr<FCharacter2DCurveLUT> Table;
+#if WITH_EDITOR
+        /** Хэш ключей на момент запекания: ловит правки, прошедшие мимо PostEditChange */
+        uint32 KeysHash = 0;
+#endif
+    };
+
+#if WITH_EDITOR
+    static uint32 HashCurveKeys(const UCurveFloat* Curve);
+    void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& Event);
+    FDelegateHandle PropertyChangedHandle;
+#endif
+
+    FDelegateHandle PostGarbageCollectHandle;
+
+    TMap<FObjectKey, FEntry> Entries;
+    uint64 NumHits = 0;
+    uint64 NumMisses = 0;
+};
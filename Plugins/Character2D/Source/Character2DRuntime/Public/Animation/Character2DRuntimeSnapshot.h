@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Character2DAsset.h"
+
+class ACharacter2DActor;
+
+/* ───────────────────────────── Snapshot ───────────────────────────── */
+/** Квантованный твин: длительность в сотых секунды, фаза — доля длительности */
+struct FCharacter2DSnapshotTween
+{
+    uint16 DurationCs = 0;
+    uint16 Phase = 0;
+    ECharacter2DEasing Easing = ECharacter2DEasing::Linear;
+};
+
+/**
+ * Состояние персонажа во время игры: положение, видимость, прозрачность,
+ * выражение, моргание/разговор и идущие анимации (тип + фаза, без UObject).
+ *
+ * Структура POD фиксированного размера — снимки лежат в заранее выделенных
+ * массивах (FCharacter2DSnapshotHistory). На диск пишется через Serialize:
+ * версия, флаги и только активные секции; координаты квантуются шагом LocationStep.
+ *
+ * Кривые не сохраняются: твин с кривой ассета (движение/эмоция по умолчанию,
+ * fade) восстанавливается с той же кривой, с любой другой — с её Easing.
+ * Фаза flipbook'ов моргания и разговора не сохраняется: они перезапускаются.
+ */
+struct CHARACTER2DRUNTIME_API FCharacter2DRuntimeSnapshot
+{
+    static constexpr uint8 Version = 1;
+    /** Шаг квантования координат (1/16 юнита) */
+    static constexpr float LocationStep = 1.0f / 16.0f;
+    /** Шаг квантования масштаба */
+    static constexpr float ScaleStep = 1.0f / 1024.0f;
+
+    enum EFlags : uint16
+    {
+        Flag_Valid            = 1 << 0,
+        Flag_Hidden           = 1 << 1,
+        Flag_SpritesVisible   = 1 << 2,
+        Flag_SkeletalVisible  = 1 << 3,
+        Flag_Blinking         = 1 << 4,
+        Flag_Talking          = 1 << 5,
+        Flag_Moving           = 1 << 6,
+        Flag_MoveAssetCurve   = 1 << 7,
+        Flag_Fading           = 1 << 8,
+        Flag_FadeIn           = 1 << 9,
+        Flag_Emotion          = 1 << 10,
+        Flag_EmotionAssetCurve= 1 << 11,
+        Flag_EmotionLoop      = 1 << 12,
+        Flag_EmotionOnGpu     = 1 << 13,
+        Flag_BlinkScheduled   = 1 << 14,
+    };
+
+    uint16 Flags = 0;
+    int16 Expression = INDEX_NONE;
+    uint8 Opacity = 255;
+    FIntVector Location = FIntVector::ZeroValue;
+    int16 Scale[3] = {1024, 1024, 1024};
+
+    /* Blink */
+    int32 BlinkRandomSeed = 0;
+    uint16 BlinkRemainingMs = 0;
+
+    /* Movement */
+    FIntVector MoveFrom = FIntVector::ZeroValue;
+    FIntVector MoveTo = FIntVector::ZeroValue;
+    FCharacter2DSnapshotTween MoveTween;
+
+    /* Fade */
+    FCharacter2DSnapshotTween FadeTween;
+
+    /* Emotion */
+    FCharacter2DSnapshotTween EmotionTween;
+    ECharacter2DEmotionEffect EmotionType = ECharacter2DEmotionEffect::None;
+    uint8 EmotionIntensity = 0;
+    uint8 EmotionFrequency = 0;
+    FColor EmotionColor = FColor::White;
+    FIntVector EmotionBaseLocation = FIntVector::ZeroValue;
+    int16 EmotionBaseScale[3] = {1024, 1024, 1024};
+
+    bool IsValid() const { return (Flags & Flag_Valid) != 0; }
+    void Reset() { *this = FCharacter2DRuntimeSnapshot(); }
+
+    /** Снимает состояние актёра; без выделений памяти в куче */
+    void Capture(const ACharacter2DActor& Actor);
+
+    /** Возвращает актёра к снимку без событий завершения (OnEmotionFinished не вызывается) */
+    void Restore(ACharacter2DActor& Actor) const;
+
+    /** Компактная двоичная форма; false — версия новее поддерживаемой или данные испорчены */
+    bool Serialize(FArchive& Ar);
+};
+
+static_assert(std::is_trivially_copyable_v<FCharacter2DRuntimeSnapshot>, "FCharacter2DRuntimeSnapshot must stay POD");
+
+/* ───────────────────────────── History ───────────────────────────── */
+/**
+ * Кольцо снимков по строкам диалога: MaxLines строк по MaxCharacters персонажей.
+ * Память выделяется в конструкторе; PushLine и Rollback ничего не выделяют,
+ * самая старая строка затирается новой.
+ */
+class CHARACTER2DRUNTIME_API FCharacter2DSnapshotHistory
+{
+public:
+    explicit FCharacter2DSnapshotHistory(int32 InMaxLines = 128, int32 InMaxCharacters = 32);
+
+    /** Снимок сцены перед строкой; актёры сверх MaxCharacters не сохраняются */
+    void PushLine(TConstArrayView<ACharacter2DActor*> Actors);
+
+    /**
+     * Откат на Steps строк назад (1 — к последнему PushLine). Actors — те же и в том же
+     * порядке, что при PushLine; восстановленная строка и более новые отбрасываются.
+     * false — столько строк в истории нет.
+     */
+    bool Rollback(int32 Steps, TConstArrayView<ACharacter2DActor*> Actors);
+
+    int32 Num() const { return NumLines; }
+    int32 GetMaxLines() const { return MaxLines; }
+    int32 GetMaxCharacters() const { return MaxCharacters; }
+
+    void Reset();
+
+private:
+    int32 MaxLines = 0;
+    int32 MaxCharacters = 0;
+
+    /** MaxLines * MaxCharacters, строка за строкой */
+    TArray<FCharacter2DRuntimeSnapshot> Snapshots;
+    /** Персонажей в строке */
+    TArray<int32> LineCounts;
+
+    /** Следующая строка для записи */
+    int32 Head = 0;
+    int32 NumLines = 0;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/* ───────────────────────────── Timing Wheel ───────────────────────────── */
+/**
+ * Иерархическое колесо таймеров: вставка O(1), за тик разбирается одна корзина,
+ * так что стоимость не растёт с числом ожидающих таймеров.
+ *
+ * Время квантуется тиками TickSeconds. Уровень 0 — 256 корзин по тику,
+ * уровни 1 и 2 — по 64 корзины, каждая размером с весь предыдущий уровень
+ * (горизонт ~4.8 ч, дальше срок обрезается). Отмены нет: владелец сверяет
+ * Cookie сработавшей записи со своим и отбрасывает устаревшие.
+ */
+class CHARACTER2DRUNTIME_API FCharacter2DTimingWheel
+{
+public:
+    static constexpr float TickSeconds = 1.0f / 60.0f;
+
+    struct FEntry
+    {
+        uint64 FireTick = 0;
+        int32 Id = INDEX_NONE;
+        uint32 Cookie = 0;
+    };
+
+    /** Сработает на первом тике не раньше чем через DelaySeconds; возвращает этот тик */
+    uint64 Schedule(int32 Id, uint32 Cookie, float DelaySeconds);
+
+    /** Продвигает время; сработавшие записи дописываются в OutExpired в порядке срабатывания */
+    void Advance(float DeltaTime, TArray<FEntry>& OutExpired);
+
+    /** Сколько секунд осталось до тика FireTick */
+    float GetSecondsUntil(uint64 FireTick) const;
+
+    /** Записей в колесе, включая устаревшие (отменённые владельцем) */
+    int32 Num() const { return NumEntries; }
+
+    void Reset();
+
+private:
+    static constexpr int32 Level0Bits = 8;
+    static constexpr int32 LevelBits = 6;
+    static constexpr int32 Level0Size = 1 << Level0Bits;
+    static constexpr int32 LevelSize = 1 << LevelBits;
+    static constexpr uint64 MaxDelayTicks = uint64(1) << (Level0Bits + 2 * LevelBits);
+
+    void Insert(const FEntry& Entry);
+    /** Переносит корзину верхнего уровня вниз, когда её интервал становится ближайшим */
+    void Cascade(TArray<FEntry>& Bucket);
+    void ProcessTick(TArray<FEntry>& OutExpired);
+
+    TArray<FEntry> Level0[Level0Size];
+    TArray<FEntry> Level1[LevelSize];
+    TArray<FEntry> Level2[LevelSize];
+
+    uint64 CurrentTick = 0;
+    float Accumulator = 0.0f;
+    int32 NumEntries = 0;
+};
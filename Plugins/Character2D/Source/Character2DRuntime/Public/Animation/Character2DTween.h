@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Character2DAsset.h"
+
+class UCurveFloat;
+
+/* ───────────────────────────── Easing ───────────────────────────── */
+namespace Character2DEasing
+{
+    /** Значение встроенной кривой для нормализованного времени [0..1] */
+    CHARACTER2DRUNTIME_API float Apply(ECharacter2DEasing Easing, float Alpha);
+}
+
+/* ───────────────────────────── Curve LUT ───────────────────────────── */
+/** UCurveFloat, запечённая в таблицу по нормализованному времени [0..1] */
+struct CHARACTER2DRUNTIME_API FCharacter2DCurveLUT
+{
+    static constexpr int32 NumSamples = 65;
+
+    float Samples[NumSamples] = {};
+
+    /** Ключи кривой растягиваются на [0..1] */
+    void Bake(const UCurveFloat* Curve);
+
+    float Sample(float Alpha) const
+    {
+        const float Position = FMath::Clamp(Alpha, 0.0f, 1.0f) * (NumSamples - 1);
+        const int32 Index = FMath::Min(FMath::FloorToInt32(Position), NumSamples - 2);
+        return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - Index);
+    }
+};
+
+/* ───────────────────────────── Tween ───────────────────────────── */
+/** POD-твин: время, длительность и кривая; без UObject и аллокаций */
+struct CHARACTER2DRUNTIME_API FCharacter2DTween
+{
+    float Time = 0.0f;
+    float Duration = 0.0f;
+    ECharacter2DEasing Easing = ECharacter2DEasing::Linear;
+    bool bLoop = false;
+    /** Кривая читается с конца (fade out по кривой fade in) */
+    bool bReverse = false;
+    /** Таблица из FCharacter2DCurveCache; заменяет Easing */
+    const FCharacter2DCurveLUT* Curve = nullptr;
+    /** Curve — кривая ассета по умолчанию; ставит владелец твина после Start (нужно снимку) */
+    bool bAssetCurve = false;
+
+    /** Curve, если задана, берётся из общего кэша таблиц и заменяет Easing */
+    void Start(float InDuration, ECharacter2DEasing InEasing, const UCurveFloat* InCurve, bool bInLoop = false, bool bInReverse = false);
+
+    /** Продвигает время; true — твин закончился на этом шаге */
+    bool Advance(float DeltaTime);
+
+    float GetAlpha() const
+    {
+        return Duration > 0.0f ? FMath::Clamp(Time / Duration, 0.0f, 1.0f) : 1.0f;
+    }
+
+    float Evaluate() const
+    {
+        const float Alpha = bReverse ? 1.0f - GetAlpha() : GetAlpha();
+        return Curve ? Curve->Sample(Alpha) : Character2DEasing::Apply(Easing, Alpha);
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<FCharacter2DTween>, "FCharacter2DTween must stay POD");
+
+/* ───────────────────────────── Pool ───────────────────────────── */
+/** Пул твинов фиксированной ёмкости: память выделяется один раз, хэндлы стабильны */
+class CHARACTER2DRUNTIME_API FCharacter2DTweenPool
+{
+public:
+    explicit FCharacter2DTweenPool(int32 InCapacity);
+
+    /** Хэндл свободного твина или INDEX_NONE, если пул заполнен */
+    int32 Acquire();
+    void Release(int32 Handle);
+
+    FCharacter2DTween& operator[](int32 Handle) { return Tweens[Handle]; }
+    const FCharacter2DTween& operator[](int32 Handle) const { return Tweens[Handle]; }
+
+    int32 GetCapacity() const { return Tweens.Num(); }
+    int32 GetNumUsed() const { return Tweens.Num() - FreeHandles.Num(); }
+
+private:
+    TArray<FCharacter2DTween> Tweens;
+    TArray<int32> FreeHandles;
+};
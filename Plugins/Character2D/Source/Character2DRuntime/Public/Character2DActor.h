@@ -4,22 +4,82 @@
 #include "GameFramework/Actor.h"
 #include "PaperSpriteComponent.h"
 #include "PaperFlipbookComponent.h"
-#include "TimerManager.h"
-#include "Components/TimelineComponent.h"
 #include "Character2DAsset.h"
+#include "Character2DEnums.h"
+#include "Components/Character2DLayeredSpriteComponent.h"
 #include "Character2DActor.generated.h"
 
+class UTextureRenderTarget2D;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCharacter2DEmotionFinished, ECharacter2DEmotionEffect, EmotionType);
 
+/** Какие настройки ассета уже применены к компонентам актёра (для RefreshFromAsset по разнице) */
+USTRUCT()
+struct FCharacter2DAppliedState
+{
+    GENERATED_BODY()
+
+    UPROPERTY(Transient)
+    TArray<FCharacter2DSpriteLayer> SpriteLayers;
+
+    UPROPERTY(Transient)
+    FCharacter2DBlinkSettings Blink;
+
+    UPROPERTY(Transient)
+    FCharacter2DTalkSettings Talk;
+
+    UPROPERTY(Transient)
+    FCharacter2DSpriteTransformStructure SpriteTransform;
+
+    UPROPERTY(Transient)
+    FCharacter2DSkeletalPart SkeletalBody;
+
+    UPROPERTY(Transient)
+    FCharacter2DSkeletalPart SkeletalArms;
+
+    UPROPERTY(Transient)
+    FCharacter2DSkeletalPart SkeletalHead;
+
+    UPROPERTY(Transient)
+    TArray<FCharacter2DExpressionSet> ExpressionSets;
+
+    int32 BlinkLayerId = INDEX_NONE;
+    int32 TalkLayerId = INDEX_NONE;
+
+    FVector SkeletalGlobalOffset = FVector::ZeroVector;
+    float SkeletalGlobalScale = 1.0f;
+
+    bool bLayeredSprites = false;
+    bool bSpritesVisible = false;
+    bool bSkeletalVisible = false;
+
+    /** false — ничего не применено, следующее обновление полное */
+    bool bValid = false;
+};
+
 UCLASS(BlueprintType, Blueprintable)
 class CHARACTER2DRUNTIME_API ACharacter2DActor : public AActor
 {
     GENERATED_BODY()
 
+    // Перемещение, fade, эмоции и таймер моргания считаются пакетно в подсистеме
+    friend class UCharacter2DAnimationSubsystem;
+    // Снимок композиции и показ импостора
+    friend class UCharacter2DImpostorSubsystem;
+    // Сброс при возврате в пул и перенастройка при выдаче
+    friend class UCharacter2DActorPool;
+    // Снимок и откат состояния во время игры
+    friend struct FCharacter2DRuntimeSnapshot;
+
 public:
     ACharacter2DActor();
 
     /* ---------------- Components ---------------- */
+    /**
+     * Default subobjects, но регистрируются только при первом использовании: когда скелет
+     * показывается (SetSkeletalVisible) или к сокету части прикрепляется слой. У персонажа
+     * только из спрайтов остаются незарегистрированными.
+     */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Components")
     TObjectPtr<USkeletalMeshComponent> BodyComponent;
 
@@ -30,48 +90,61 @@ public:
     TObjectPtr<USkeletalMeshComponent> HeadComponent;
 
     /* ---------------- Sprite components ------------------ */
+    /**
+     * По компоненту на слой CharacterAsset->SpriteLayers (тот же индекс); создаются
+     * только без LayeredSprite и только для слоёв, которые есть в ассете
+     */
+    UPROPERTY(VisibleInstanceOnly, Transient, BlueprintReadOnly, Category="Components|Sprites")
+    TArray<TObjectPtr<UPaperSpriteComponent>> SpriteLayerComponents;
+
+    /** Все спрайтовые слои одним примитивом (используется вместо SpriteLayerComponents и Flipbook-компонентов) */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteBody;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteArms;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteHead;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteEyebrow;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteEyes;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteEyelids;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Sprites")
-    TObjectPtr<UPaperSpriteComponent> SpriteMouth;
+    TObjectPtr<UCharacter2DLayeredSpriteComponent> LayeredSprite;
 
     /* ---------------- Flipbook components ---------------- */
+    /** Регистрируются при первом моргании/разговоре без LayeredSprite; до этого не рисуются и не тикают */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Animation")
     TObjectPtr<UPaperFlipbookComponent> EyelidComponent;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Animation")
     TObjectPtr<UPaperFlipbookComponent> MouthComponent;
 
-    /* ---------------- Timeline components ---------------- */
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Timeline")
-    TObjectPtr<UTimelineComponent> MovementTimeline;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Timeline")
-    TObjectPtr<UTimelineComponent> EmotionTimeline;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components|Timeline")
-    TObjectPtr<UTimelineComponent> FadeTimeline;
-
     /* ---------------- DataAsset reference ---------------- */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character")
     TObjectPtr<UCharacter2DAsset> CharacterAsset;
 
+    /** Рисовать спрайтовые слои одним примитивом, если ни один слой не прикреплён к сокету */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Rendering")
+    bool bUseLayeredSprites = true;
+
+    /** GPU: эмоция пишется в Custom Primitive Data и считается в материале (см. Character2DPrimitiveData.h) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character|Rendering")
+    ECharacter2DEmotionRenderMode EmotionRenderMode = ECharacter2DEmotionRenderMode::CPU;
+
+    /** PrimitiveData: fade/цвет — запись в Custom Primitive Data, настоящий fade скелетных мешей (нужны материалы с CPD) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Rendering")
+    ECharacter2DTintRenderMode TintRenderMode = ECharacter2DTintRenderMode::SpriteColor;
+
+    /** Статичная композиция рисуется одним квадом из render target (UCharacter2DImpostorSubsystem); только с LayeredSprite */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Rendering|Impostor")
+    bool bUseImpostor = false;
+
+    /** Материал квада: снимок в параметре SpriteTexture, альфа снимка инвертирована (OpacityMask = 1 - A) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Rendering|Impostor", meta=(EditCondition="bUseImpostor"))
+    TObjectPtr<UMaterialInterface> ImpostorMaterial;
+
+    /** Пикселей снимка на единицу мира */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Rendering|Impostor", meta=(EditCondition="bUseImpostor", ClampMin="0.1", ClampMax="8.0"))
+    float ImpostorTexelDensity = 1.0f;
+
+    /** Учитывать персонажа в UCharacter2DSignificanceSubsystem (иначе всегда Full) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Significance")
+    bool bUseSignificance = true;
+
+    /** Зерно случайных интервалов моргания; 0 — от имени актёра (у каждого своё, но стабильное) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Character|Animation")
+    int32 BlinkSeed = 0;
+
     /* ---------------- Runtime State ---------------------- */
     UPROPERTY(BlueprintReadOnly, Category="Character|Runtime")
     bool bSpritesVisible = true;
@@ -141,76 +214,207 @@ public:
     UFUNCTION(BlueprintCallable, Category="Character|Animation")
     void EnableTalking(bool bEnable);
 
+    /** Перезапускает поток случайных чисел моргания — для повторов и тестов */
+    UFUNCTION(BlueprintCallable, Category="Character|Animation")
+    void SetBlinkSeed(int32 Seed);
+
     UFUNCTION(BlueprintCallable, Category="Character|Animation")
     bool IsBlinking() const { return bIsBlinking; }
 
     UFUNCTION(BlueprintCallable, Category="Character|Animation")
     bool IsTalking() const { return bIsTalking; }
 
+    /* ---------------- Expressions ---------------- */
+    /** Выражение из UCharacter2DAsset::ExpressionSets; None — спрайты слоёв из ассета */
+    UFUNCTION(BlueprintCallable, Category="Character|Expression")
+    bool SetExpression(FName Name);
+
+    /** Переключает только слои, спрайты которых у выражений различаются; INDEX_NONE — без выражения */
+    UFUNCTION(BlueprintCallable, Category="Character|Expression")
+    bool SetExpressionByIndex(int32 Index);
+
+    UFUNCTION(BlueprintCallable, Category="Character|Expression")
+    int32 GetExpressionIndex() const { return ExpressionIndex; }
+
+    /** Применяет только то, что изменилось в ассете с прошлого обновления */
     UFUNCTION(BlueprintCallable, Category="Character|Runtime")
     void RefreshFromAsset();
 
+    /** Заново применить части маски из ассета, даже если они не менялись (подмена слоёв в игре) */
+    void RefreshLayers(ECharacter2DLayerMask Mask);
+
+    UFUNCTION(BlueprintCallable, Category="Character|Runtime", meta=(DisplayName="Refresh Layers"))
+    void K2_RefreshLayers(UPARAM(meta=(Bitmask, BitmaskEnum="/Script/Character2DRuntime.ECharacter2DLayerMask")) int32 Mask)
+    {
+        RefreshLayers(static_cast<ECharacter2DLayerMask>(Mask));
+    }
+
+    /**
+     * Асинхронно подгрузить спрайты и скелетные части ассета, затем пересобрать
+     * персонажа и вызвать OnLoaded. Без предзагрузки части грузятся синхронно
+     * при первом использовании.
+     */
+    UFUNCTION(BlueprintCallable, Category="Character|Runtime")
+    void PreloadAsync(FOnCharacter2DAssetLoaded OnLoaded);
+
+    /** Спрайты сейчас рисуются через LayeredSprite */
+    UFUNCTION(BlueprintCallable, Category="Character|Rendering")
+    bool IsUsingLayeredSprites() const { return bLayeredSpritesActive; }
+
+    /** Сбросить импостор и запечь заново (после ручной смены слоёв/материалов) */
+    UFUNCTION(BlueprintCallable, Category="Character|Rendering")
+    void InvalidateImpostor();
+
+    UFUNCTION(BlueprintCallable, Category="Character|Rendering")
+    bool IsShowingImpostor() const { return ImpostorTarget != nullptr; }
+
+    /* ---------------- Significance ------------------------- */
+    /** Говорящий персонаж всегда получает уровень Full (в пределах бюджета) */
+    UFUNCTION(BlueprintCallable, Category="Character|Significance")
+    void SetActiveSpeaker(bool bSpeaker);
+
+    UFUNCTION(BlueprintCallable, Category="Character|Significance")
+    bool IsActiveSpeaker() const { return bIsActiveSpeaker || bIsTalking; }
+
+    UFUNCTION(BlueprintCallable, Category="Character|Significance")
+    ECharacter2DSignificanceTier GetSignificanceTier() const { return SignificanceTier; }
+
+    /** Применяет уровень детализации; вызывается UCharacter2DSignificanceSubsystem */
+    void SetSignificanceTier(ECharacter2DSignificanceTier Tier);
+
+    /** Спрятан в UCharacter2DActorPool и ждёт Acquire */
+    UFUNCTION(BlueprintCallable, Category="Character|Runtime")
+    bool IsInPool() const { return bInPool; }
+
+    /** Компактный снимок состояния во время игры для сохранений (FCharacter2DRuntimeSnapshot) */
+    UFUNCTION(BlueprintCallable, Category="Character|Runtime")
+    void SaveRuntimeState(TArray<uint8>& OutData) const;
+
+    /** false — данные испорчены или записаны более новой версией; состояние не меняется */
+    UFUNCTION(BlueprintCallable, Category="Character|Runtime")
+    bool LoadRuntimeState(const TArray<uint8>& Data);
+
 protected:
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
     virtual void OnConstruction(const FTransform& Transform) override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
     /* --- Animation State --- */
-    FTimerHandle BlinkTimerHandle;
-    FTimerHandle BlinkRestoreHandle;
     bool bIsBlinking = false;
     bool bIsTalking = false;
+    bool bLayeredSpritesActive = false;
+    bool bEmotionOnGpu = false;
+    bool bIsActiveSpeaker = false;
+    bool bInPool = false;
+    /** Спрайтовый бандл запрошен из GetLoadedFlipbook и ещё не загружен */
+    bool bSpriteBundleLoadPending = false;
+    ECharacter2DSignificanceTier SignificanceTier = ECharacter2DSignificanceTier::Full;
+    /** Интервалы, скорость и двойное моргание — детерминированно от BlinkSeed */
+    FRandomStream BlinkRandom;
 
     /* --- Visual Effect State --- */
     ECharacter2DEmotionEffect CurrentEmotionType = ECharacter2DEmotionEffect::None;
     
     FVector OriginalActorLocation;
     FVector OriginalActorScale;
-    FLinearColor OriginalSpriteColors[7];
+    /** По слоям, как SpriteLayerComponents */
+    TArray<FLinearColor> OriginalSpriteColors;
+    FLinearColor OriginalLayeredSpriteColor = FLinearColor::White;
+
+    /* --- Impostor --- */
+    UPROPERTY(Transient)
+    TObjectPtr<UTextureRenderTarget2D> ImpostorTarget;
+
+    /* --- Applied asset state --- */
+    UPROPERTY(Transient)
+    FCharacter2DAppliedState AppliedState;
+
+    /* --- Expression --- */
+    int32 ExpressionIndex = INDEX_NONE;
+    /** Показанные индексы спрайтов выражения по слоям (INDEX_NONE — спрайт из ассета, Unknown — сверить заново) */
+    static constexpr int16 UnknownExpressionSprite = -2;
+    TArray<int16> AppliedExpressionSprites;
+
+    /* --- Custom Primitive Data tint (TintRenderMode == PrimitiveData) --- */
+    FLinearColor PrimitiveSpriteTint = FLinearColor::White;
+    FLinearColor OriginalPrimitiveSpriteTint = FLinearColor::White;
+    float PrimitiveSkeletalOpacity = 1.0f;
     
     /* --- Movement state --- */
-    FVector MovementStartLocation;
     FVector MovementTargetLocation;
     
-    /* --- Current settings for timeline callbacks --- */
-    FCharacter2DEmotionSettings CurrentEmotionSettings;
-    FCharacter2DMovementSettings CurrentMovementSettings;
-    
-    /* --- Timeline Callbacks --- */
-    UFUNCTION()
-    void OnMovementTimelineUpdate(float Value);
-    
-    UFUNCTION()
-    void OnMovementTimelineFinished();
-    
-    UFUNCTION()
-    void OnEmotionTimelineUpdate(float Value);
-    
-    UFUNCTION()
-    void OnEmotionTimelineFinished();
-    
-    UFUNCTION()
-    void OnFadeTimelineUpdate(float Value);
-    
-    UFUNCTION()
-    void OnFadeTimelineFinished();
+    /* --- Impostor --- */
+    /** Композиция статична и её можно снять (цвет белый, нет fade, скелет не анимирован) */
+    bool CanUseImpostor() const;
+    bool IsSkeletalAnimated() const;
+    /** Что снимать и в каких границах (пространство LayeredSprite) */
+    void GatherImpostorComposition(FBox& OutLocalBox, TArray<UPrimitiveComponent*>& OutComponents) const;
+    void ShowImpostor(UTextureRenderTarget2D* Target, const FBox& LocalBox);
+    /** Убирает импостор и возвращает цель в пул; без перезапекания */
+    void ReleaseImpostor();
+    /** Ставит в очередь запекания, если импостор нужен и ещё не показан */
+    void RequestImpostor();
+    void HandleStaticLayersChanged();
+
+    /* --- Pool --- */
+    /** Регистрация в подсистемах, автоморгание/разговор (BeginPlay и выдача из пула) */
+    void StartCharacterRuntime();
+    /** Обратное StartCharacterRuntime (EndPlay и возврат в пул) */
+    void StopCharacterRuntime();
+    /** Остановить всё, вернуть прозрачность и спрятать */
+    void ParkInPool();
+    /** Сменить ассет (только если другой), поставить в Transform и запустить */
+    void UnparkFromPool(UCharacter2DAsset* Asset, const FTransform& Transform);
+
+    /* --- Animation Subsystem Callbacks --- */
+    void OnMovementFinished();
+    void OnFadeFinished(bool bFadeIn);
+    bool StartFade(bool bFadeIn, float Duration);
+
+    /* --- Asset application --- */
+    /** Что в ассете отличается от AppliedState */
+    ECharacter2DLayerMask DiffAppliedState() const;
+    /** Настраивает компоненты частей маски и запоминает применённое */
+    void ApplyAssetState(ECharacter2DLayerMask Mask);
+    /** Сверяет таблицу выражения с AppliedExpressionSprites и меняет только отличающиеся слои */
+    void ApplyExpressionSprites();
+    /** Спрайт слоя (индекс в SpriteLayers ассета) с учётом выражения */
+    UPaperSprite* GetLayerDisplaySprite(int32 LayerIndex) const;
+    UPaperSpriteComponent* GetSpriteComponent(int32 LayerIndex) const;
+    /** Компонент родителя слоя или RootComponent */
+    USceneComponent* GetLayerAttachParent(int32 LayerIndex) const;
+
+    /* --- Deferred components --- */
+    /** Скелетная часть Target; при первом обращении регистрируется и настраивается из ассета */
+    USkeletalMeshComponent* GetOrRegisterSkeletalComponent(ECharacter2DAttachmentTarget Target);
+    /** Компоненты для частей с мешем в ассете (скелет стал видимым) */
+    void EnsureSkeletalComponents();
+    /** Анимация скелета только на Full и только если меш виден или к его сокетам прикреплены слои */
+    void UpdateSkeletalTick(USkeletalMeshComponent* Component) const;
+    /** Flipbook моргания (BlinkFlipbook) или разговора (TalkFlipbook); регистрируется при первом показе */
+    UPaperFlipbookComponent* GetOrRegisterFlipbookComponent(ECharacter2DLayerMask Flipbook);
+    /** Анимация, родитель слоя и сокет Flipbook из ассета; незарегистрированный компонент не трогается */
+    void SetupFlipbookComponent(ECharacter2DLayerMask Flipbook);
+    /** Спрайтовый бандл для текущего режима: без спрайтов из атласа, если слои рисует LayeredSprite с атласом */
+    FName GetSpriteBundle() const;
+    /** Уже загруженный Flipbook; иначе асинхронно грузит спрайтовый бандл и возвращает nullptr (без синхронной загрузки) */
+    UPaperFlipbook* GetLoadedFlipbook(const TSoftObjectPtr<UPaperFlipbook>& Flipbook);
 
     /* --- Helper Methods --- */
     void SetupComponents();
     void SetupSpriteComponent(UPaperSpriteComponent* Component, const FCharacter2DSpriteLayer& Layer);
     void SetupSkeletalComponent(USkeletalMeshComponent* Component, const FCharacter2DSkeletalPart& Part);
+    void SetupLayeredSprites();
+    /** Ровно по компоненту на слой ассета: недостающие создаются, лишние уничтожаются */
+    void SyncSpriteLayerComponents();
+    void ClearSpriteComponents();
     void AttachSpriteToSocket(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteLayer& Layer);
     void AttachFlipbookToSocket(UPaperFlipbookComponent* FlipbookComp,
         ECharacter2DAttachmentTarget Target, FName Socket, bool bUseSocketTransform,
         const FVector& Offset, float Scale);
 
-    // New methods for Body/Arms structures
-    void SetupSpriteComponentFromStruct(UPaperSpriteComponent* Component, const FCharacter2DSpriteBodyStructure& BodyStruct);
-    void SetupSpriteComponentFromStruct(UPaperSpriteComponent* Component, const FCharacter2DSpriteArmsStructure& ArmsStruct);
-    void AttachSpriteToSocketFromStruct(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteBodyStructure& BodyStruct);
-    void AttachSpriteToSocketFromStruct(UPaperSpriteComponent* SpriteComp, const FCharacter2DSpriteArmsStructure& ArmsStruct);
-
     bool HasValidSprites() const;
     bool HasValidSkeletalMeshes() const;
     
@@ -220,22 +424,27 @@ private:
     void SetAllSpritesOpacity(float Opacity);
     void SetAllSpritesColor(const FLinearColor& Color);
     void SetAllSkeletalOpacity(float Opacity);
+    /** Текущая прозрачность спрайтов (fade) */
+    float GetSpritesOpacity() const;
+    bool UsesPrimitiveDataTint() const { return TintRenderMode == ECharacter2DTintRenderMode::PrimitiveData; }
+    /** Пишет текущий tint спрайтам (bSprites) и/или скелетным мешам (bSkeletal) */
+    void WritePrimitiveTint(bool bSprites, bool bSkeletal);
     
     TArray<UPaperSpriteComponent*> GetAllSpriteComponents() const;
     TArray<USkeletalMeshComponent*> GetAllSkeletalComponents() const;
-    USkeletalMeshComponent* GetSkeletalComponentByTarget(ECharacter2DAttachmentTarget Target) const;
+    /** Inline-ёмкость хватает на LayeredSprite + скелет и на типичный набор слоёв без него */
+    using FRenderPrimitiveArray = TArray<UPrimitiveComponent*, TInlineAllocator<16>>;
+    /** Примитивы, которые сейчас рисуют персонажа (для Custom Primitive Data); без кучи в пределах inline-ёмкости */
+    FRenderPrimitiveArray GetRenderPrimitives() const;
+    /** Первый из GetRenderPrimitives без сборки массива */
+    UPrimitiveComponent* GetFirstRenderPrimitive() const;
 
     /* --- Animation Methods --- */
     void StartBlinking();
     void StopBlinking();
     void HandleBlink();
+    void FinishBlink();
     void StartTalking();
     void StopTalking();
 
-    /* --- Emotion Implementation --- */
-    void ExecuteShakeEmotion(const FCharacter2DEmotionSettings& Settings);
-    void ExecutePulseEmotion(const FCharacter2DEmotionSettings& Settings);
-    void ExecuteColorShiftEmotion(const FCharacter2DEmotionSettings& Settings);
-    void ExecuteBounceEmotion(const FCharacter2DEmotionSettings& Settings);
-    void ExecuteFlashEmotion(const FCharacter2DEmotionSettings& Settings);
 };
\ No newline at end of file
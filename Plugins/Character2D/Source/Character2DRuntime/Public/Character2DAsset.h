@@ -5,6 +5,8 @@
 #include "PaperSprite.h"
 #include "PaperFlipbook.h"
 #include "Curves/CurveFloat.h"
+#include "Engine/StreamableManager.h"
+#include "Character2DEnums.h"
 #include "Character2DAsset.generated.h"
 
 class FAssetRegistryTagsContext;
@@ -21,6 +23,19 @@ enum class ECharacter2DEmotionEffect : uint8
     Flash       UMETA(DisplayName = "Flash")
 };
 
+/* ───────────────────────────── Easing ───────────────────────────── */
+/** Встроенные кривые анимаций; AnimationCurve, если задана, имеет приоритет */
+UENUM(BlueprintType)
+enum class ECharacter2DEasing : uint8
+{
+    Linear      UMETA(DisplayName = "Linear"),
+    EaseIn      UMETA(DisplayName = "Ease In"),
+    EaseOut     UMETA(DisplayName = "Ease Out"),
+    EaseInOut   UMETA(DisplayName = "Ease In Out"),
+    SmoothStep  UMETA(DisplayName = "Smooth Step"),
+    PingPong    UMETA(DisplayName = "Ping Pong (0 → 1 → 0)")
+};
+
 /* ───────────────────────────── Sprite Attachment ───────────────────────────── */
 UENUM(BlueprintType)
 enum class ECharacter2DAttachmentTarget : uint8
@@ -41,6 +56,10 @@ struct FCharacter2DMovementSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement", meta=(ClampMin="0.0"))
     float Duration = 1.0f;
 
+    /** Built-in easing used when no AnimationCurve is set */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
+    ECharacter2DEasing Easing = ECharacter2DEasing::Linear;
+
     /** Animation curve for the movement */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
     TObjectPtr<UCurveFloat> AnimationCurve = nullptr;
@@ -76,6 +95,10 @@ struct FCharacter2DEmotionSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Emotion")
     bool bLoop = false;
 
+    /** Built-in easing used when no AnimationCurve is set */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Emotion")
+    ECharacter2DEasing Easing = ECharacter2DEasing::PingPong;
+
     /** Animation curve for the effect */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Emotion")
     TObjectPtr<UCurveFloat> AnimationCurve = nullptr;
@@ -88,8 +111,8 @@ struct FCharacter2DBlinkSettings
     GENERATED_BODY()
 
     /** Flipbook с кадрами моргания (открыто → полу-закрыто → закрыто) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Blink")
-    TObjectPtr<UPaperFlipbook> BlinkFlipbook = nullptr;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Blink", meta=(AssetBundles="Sprite"))
+    TSoftObjectPtr<UPaperFlipbook> BlinkFlipbook;
 
     /** Сдвиг от корня (X вправо, Y вверх) для Flipbook */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Blink")
@@ -133,8 +156,8 @@ struct FCharacter2DTalkSettings
     GENERATED_BODY()
 
     /** Flipbook с кадрами говорения (движение губ) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Talk")
-    TObjectPtr<UPaperFlipbook> TalkFlipbook = nullptr;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Talk", meta=(AssetBundles="Sprite"))
+    TSoftObjectPtr<UPaperFlipbook> TalkFlipbook;
 
     /** Сдвиг от корня (X вправо, Y вверх) для Flipbook */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Talk")
@@ -162,57 +185,30 @@ struct FCharacter2DTalkSettings
 };
 
 /* ───────────────────────────── Sprite Layer ───────────────────────────── */
+/**
+ * Спрайтовый слой персонажа. Слои лежат в UCharacter2DAsset::SpriteLayers в порядке
+ * отрисовки; родитель, моргание, разговор и выражения ссылаются на слой по Id,
+ * который не меняется при переименовании и перестановке слоёв.
+ */
 USTRUCT(BlueprintType)
 struct FCharacter2DSpriteLayer
 {
     GENERATED_BODY()
 
-    /** Имя слоя (автозаполняется из категории) */
+    /** Постоянный Id слоя; выдаёт ассет (UCharacter2DAsset::EnsureSpriteLayerIds) */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Sprite")
-    FName Name;
-
-    /** Статичный спрайт */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    TObjectPtr<UPaperSprite> Sprite = nullptr;
-
-    /** Attachment target (which skeletal mesh to attach to) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment")
-    ECharacter2DAttachmentTarget AttachmentTarget = ECharacter2DAttachmentTarget::None;
-
-    /** Socket name for attachment (if AttachmentTarget is set) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment", meta=(EditCondition="AttachmentTarget != ECharacter2DAttachmentTarget::None", EditConditionHides))
-    FName SocketName;
-
-    /** Whether to use socket transform (true) or apply custom offset/scale (false) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment", meta=(EditCondition="AttachmentTarget != ECharacter2DAttachmentTarget::None", EditConditionHides))
-    bool bUseSocketTransform = true;
-
-    /** Локальный оффсет (X вправо, Y вверх) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    FVector Offset = FVector::ZeroVector;
+    int32 Id = INDEX_NONE;
 
-    /** Локальный Scale */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite")
-    float Scale = 1.0f;
+    FName Name;
 
-    /** Видимость */
+    /** Id родительского слоя: оффсет и масштаб считаются от него, без своего сокета слой следует за ним (лицо за головой) */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    bool bVisible = true;
-};
-
-/* ───────────────────────────── Sprite Body Structure ───────────────────────────── */
-USTRUCT(BlueprintType)
-struct FCharacter2DSpriteBodyStructure
-{
-    GENERATED_BODY()
-
-    /** Имя слоя (автозаполняется из категории) */
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Sprite")
-    FName Name;
+    int32 ParentId = INDEX_NONE;
 
     /** Статичный спрайт */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    TObjectPtr<UPaperSprite> Sprite = nullptr;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite", meta=(AssetBundles="Sprite"))
+    TSoftObjectPtr<UPaperSprite> Sprite;
 
     /** Attachment target (which skeletal mesh to attach to) */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment")
@@ -237,86 +233,49 @@ struct FCharacter2DSpriteBodyStructure
     /** Видимость */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
     bool bVisible = true;
-
-    FCharacter2DSpriteBodyStructure()
-    {
-        Name = TEXT("Body");
-    }
 };
 
-/* ───────────────────────────── Sprite Arms Structure ───────────────────────────── */
+/* ───────────────────────────── Sprite Transform Structure ───────────────────────────── */
 USTRUCT(BlueprintType)
-struct FCharacter2DSpriteArmsStructure
+struct FCharacter2DSpriteTransformStructure
 {
     GENERATED_BODY()
 
-    /** Имя слоя (автозаполняется из категории) */
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Sprite")
-    FName Name;
-
-    /** Статичный спрайт */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    TObjectPtr<UPaperSprite> Sprite = nullptr;
-
-    /** Attachment target (which skeletal mesh to attach to) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment")
-    ECharacter2DAttachmentTarget AttachmentTarget = ECharacter2DAttachmentTarget::None;
-
-    /** Socket name for attachment (if AttachmentTarget is set) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment", meta=(EditCondition="AttachmentTarget != ECharacter2DAttachmentTarget::None", EditConditionHides))
-    FName SocketName;
-
-    /** Whether to use socket transform (true) or apply custom offset/scale (false) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite|Attachment", meta=(EditCondition="AttachmentTarget != ECharacter2DAttachmentTarget::None", EditConditionHides))
-    bool bUseSocketTransform = true;
-
-    /** Локальный оффсет (X вправо, Y вверх) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    FVector Offset = FVector::ZeroVector;
-
-    /** Локальный Scale */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite")
-    float Scale = 1.0f;
-
-    /** Видимость */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite")
-    bool bVisible = true;
+    /** Глобальный оффсет для всех Sprite */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Transform", meta=(DisplayName="Global Offset"))
+    FVector GlobalOffset = FVector::ZeroVector;
 
-    FCharacter2DSpriteArmsStructure()
-    {
-        Name = TEXT("Arms");
-    }
+    /** Глобальный Scale для всех Sprite */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Transform", meta=(DisplayName="Global Scale"))
+    float GlobalScale = 1.0f;
 };
 
-/* ───────────────────────────── Sprite Head Structure ───────────────────────────── */
-USTRUCT(BlueprintType)
+/* ───────────────────────────── Legacy Sprite Structure ───────────────────────────── */
+/** Фиксированный набор слоёв головы; только для загрузки ассетов до FCharacter2DCustomVersion::GenericSpriteLayers */
+USTRUCT()
 struct FCharacter2DSpriteHeadStructure
 {
     GENERATED_BODY()
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite", meta=(DisplayName="Head"))
+    UPROPERTY()
     FCharacter2DSpriteLayer Head;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite", meta=(DisplayName="Eyebrow"))
+    UPROPERTY()
     FCharacter2DSpriteLayer Eyebrow;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite", meta=(DisplayName="Eyes"))
+    UPROPERTY()
     FCharacter2DSpriteLayer Eyes;
 
-    /** Статичный слой век */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite", meta=(DisplayName="Eyelids"))
+    UPROPERTY()
     FCharacter2DSpriteLayer Eyelids;
 
-    /** Настройки случайного моргания */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Blink", meta=(DisplayName="Eyelids Blink Settings"))
+    UPROPERTY()
     FCharacter2DBlinkSettings EyelidsBlinkSettings;
 
-    /** Статичный слой рта */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite", meta=(DisplayName="Mouth"))
+    UPROPERTY()
     FCharacter2DSpriteLayer Mouth;
 
-    /** Настройки разговора */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Talk", meta=(DisplayName="Mouth Talk Settings"))
+    UPROPERTY()
     FCharacter2DTalkSettings MouthTalkSettings;
 
     FCharacter2DSpriteHeadStructure()
@@ -329,148 +288,184 @@ struct FCharacter2DSpriteHeadStructure
     }
 };
 
-/* ───────────────────────────── Sprite Transform Structure ───────────────────────────── */
-USTRUCT(BlueprintType)
-struct FCharacter2DSpriteTransformStructure
-{
-    GENERATED_BODY()
-
-    /** Глобальный оффсет для всех Sprite */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Transform", meta=(DisplayName="Global Offset"))
-    FVector GlobalOffset = FVector::ZeroVector;
-
-    /** Глобальный Scale для всех Sprite */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Transform", meta=(DisplayName="Global Scale"))
-    float GlobalScale = 1.0f;
-};
-
-/* ───────────────────────────── Sprite Structure ───────────────────────────── */
-USTRUCT(BlueprintType)
+/**
+ * Прежняя структура Body/Arms/Head; только для загрузки. Тела и руки раньше были
+ * отдельными копиями FCharacter2DSpriteLayer (redirect в Config/DefaultCharacter2D.ini).
+ */
+USTRUCT()
 struct FCharacter2DSpriteStructure
 {
     GENERATED_BODY()
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Body")
-    FCharacter2DSpriteBodyStructure Body;
+    UPROPERTY()
+    FCharacter2DSpriteLayer Body;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Arms")
-    FCharacter2DSpriteArmsStructure Arms;
+    UPROPERTY()
+    FCharacter2DSpriteLayer Arms;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Head")
+    UPROPERTY()
     FCharacter2DSpriteHeadStructure Head;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sprite Transform")
+    UPROPERTY()
     FCharacter2DSpriteTransformStructure Transform;
 
-    // Legacy properties for backward compatibility - marked as deprecated
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyBody;
+#if WITH_EDITORONLY_DATA
+    // Старый плоский формат: читается из ассетов до FCharacter2DCustomVersion::LegacySpriteFieldsRemoved,
+    // не сохраняется (_DEPRECATED) и не попадает в cooked-сборку
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyBody_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyArms;
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyArms_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyHead;
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyHead_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyEyebrow;
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyEyebrow_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyEyes;
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyEyes_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyEyelids;
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyEyelids_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DBlinkSettings LegacyEyelidsBlinkSettings;
+    UPROPERTY()
+    FCharacter2DBlinkSettings LegacyEyelidsBlinkSettings_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DSpriteLayer LegacyMouth;
+    UPROPERTY()
+    FCharacter2DSpriteLayer LegacyMouth_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FCharacter2DTalkSettings LegacyMouthTalkSettings;
+    UPROPERTY()
+    FCharacter2DTalkSettings LegacyMouthTalkSettings_DEPRECATED;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    FVector LegacyGlobalOffset = FVector::ZeroVector;
+    UPROPERTY()
+    FVector LegacyGlobalOffset_DEPRECATED = FVector::ZeroVector;
 
-    UPROPERTY(meta=(DeprecatedProperty))
-    float LegacyGlobalScale = 1.0f;
+    UPROPERTY()
+    float LegacyGlobalScale_DEPRECATED = 1.0f;
+#endif
 
     FCharacter2DSpriteStructure()
     {
-        // Initialize new structure
-        Body = FCharacter2DSpriteBodyStructure();
-        Arms = FCharacter2DSpriteArmsStructure();
-        Head = FCharacter2DSpriteHeadStructure();
-        Transform = FCharacter2DSpriteTransformStructure();
+        Body.Name = TEXT("Body");
+        Arms.Name = TEXT("Arms");
     }
 
-    // Migration helper - call this in PostLoad to migrate old data
+#if WITH_EDITORONLY_DATA
+    /** Перенос Legacy*-полей в новую структуру; один раз, при загрузке ассета старой версии */
     void MigrateFromLegacyStructure()
     {
         // Migrate body
-        if (LegacyBody.Sprite != nullptr || !LegacyBody.Offset.IsZero() || LegacyBody.Scale != 1.0f)
+        if (!LegacyBody_DEPRECATED.Sprite.IsNull() || !LegacyBody_DEPRECATED.Offset.IsZero() || LegacyBody_DEPRECATED.Scale != 1.0f)
         {
-            Body.Sprite = LegacyBody.Sprite;
-            Body.AttachmentTarget = LegacyBody.AttachmentTarget;
-            Body.SocketName = LegacyBody.SocketName;
-            Body.bUseSocketTransform = LegacyBody.bUseSocketTransform;
-            Body.Offset = LegacyBody.Offset;
-            Body.Scale = LegacyBody.Scale;
-            Body.bVisible = LegacyBody.bVisible;
+            Body.Sprite = LegacyBody_DEPRECATED.Sprite;
+            Body.AttachmentTarget = LegacyBody_DEPRECATED.AttachmentTarget;
+            Body.SocketName = LegacyBody_DEPRECATED.SocketName;
+            Body.bUseSocketTransform = LegacyBody_DEPRECATED.bUseSocketTransform;
+            Body.Offset = LegacyBody_DEPRECATED.Offset;
+            Body.Scale = LegacyBody_DEPRECATED.Scale;
+            Body.bVisible = LegacyBody_DEPRECATED.bVisible;
         }
 
         // Migrate arms
-        if (LegacyArms.Sprite != nullptr || !LegacyArms.Offset.IsZero() || LegacyArms.Scale != 1.0f)
+        if (!LegacyArms_DEPRECATED.Sprite.IsNull() || !LegacyArms_DEPRECATED.Offset.IsZero() || LegacyArms_DEPRECATED.Scale != 1.0f)
         {
-            Arms.Sprite = LegacyArms.Sprite;
-            Arms.AttachmentTarget = LegacyArms.AttachmentTarget;
-            Arms.SocketName = LegacyArms.SocketName;
-            Arms.bUseSocketTransform = LegacyArms.bUseSocketTransform;
-            Arms.Offset = LegacyArms.Offset;
-            Arms.Scale = LegacyArms.Scale;
-            Arms.bVisible = LegacyArms.bVisible;
+            Arms.Sprite = LegacyArms_DEPRECATED.Sprite;
+            Arms.AttachmentTarget = LegacyArms_DEPRECATED.AttachmentTarget;
+            Arms.SocketName = LegacyArms_DEPRECATED.SocketName;
+            Arms.bUseSocketTransform = LegacyArms_DEPRECATED.bUseSocketTransform;
+            Arms.Offset = LegacyArms_DEPRECATED.Offset;
+            Arms.Scale = LegacyArms_DEPRECATED.Scale;
+            Arms.bVisible = LegacyArms_DEPRECATED.bVisible;
         }
 
         // Migrate head structure
-        if (LegacyHead.Sprite != nullptr || !LegacyHead.Offset.IsZero() || LegacyHead.Scale != 1.0f)
+        if (!LegacyHead_DEPRECATED.Sprite.IsNull() || !LegacyHead_DEPRECATED.Offset.IsZero() || LegacyHead_DEPRECATED.Scale != 1.0f)
         {
-            Head.Head = LegacyHead;
+            Head.Head = LegacyHead_DEPRECATED;
         }
-        if (LegacyEyebrow.Sprite != nullptr || !LegacyEyebrow.Offset.IsZero() || LegacyEyebrow.Scale != 1.0f)
+        if (!LegacyEyebrow_DEPRECATED.Sprite.IsNull() || !LegacyEyebrow_DEPRECATED.Offset.IsZero() || LegacyEyebrow_DEPRECATED.Scale != 1.0f)
         {
-            Head.Eyebrow = LegacyEyebrow;
+            Head.Eyebrow = LegacyEyebrow_DEPRECATED;
         }
-        if (LegacyEyes.Sprite != nullptr || !LegacyEyes.Offset.IsZero() || LegacyEyes.Scale != 1.0f)
+        if (!LegacyEyes_DEPRECATED.Sprite.IsNull() || !LegacyEyes_DEPRECATED.Offset.IsZero() || LegacyEyes_DEPRECATED.Scale != 1.0f)
         {
-            Head.Eyes = LegacyEyes;
+            Head.Eyes = LegacyEyes_DEPRECATED;
         }
-        if (LegacyEyelids.Sprite != nullptr || !LegacyEyelids.Offset.IsZero() || LegacyEyelids.Scale != 1.0f)
+        if (!LegacyEyelids_DEPRECATED.Sprite.IsNull() || !LegacyEyelids_DEPRECATED.Offset.IsZero() || LegacyEyelids_DEPRECATED.Scale != 1.0f)
         {
-            Head.Eyelids = LegacyEyelids;
+            Head.Eyelids = LegacyEyelids_DEPRECATED;
         }
-        if (LegacyMouth.Sprite != nullptr || !LegacyMouth.Offset.IsZero() || LegacyMouth.Scale != 1.0f)
+        if (!LegacyMouth_DEPRECATED.Sprite.IsNull() || !LegacyMouth_DEPRECATED.Offset.IsZero() || LegacyMouth_DEPRECATED.Scale != 1.0f)
         {
-            Head.Mouth = LegacyMouth;
+            Head.Mouth = LegacyMouth_DEPRECATED;
         }
 
         // Migrate animation settings
-        if (LegacyEyelidsBlinkSettings.BlinkFlipbook != nullptr)
+        if (!LegacyEyelidsBlinkSettings_DEPRECATED.BlinkFlipbook.IsNull())
         {
-            Head.EyelidsBlinkSettings = LegacyEyelidsBlinkSettings;
+            Head.EyelidsBlinkSettings = LegacyEyelidsBlinkSettings_DEPRECATED;
         }
-        if (LegacyMouthTalkSettings.TalkFlipbook != nullptr)
+        if (!LegacyMouthTalkSettings_DEPRECATED.TalkFlipbook.IsNull())
         {
-            Head.MouthTalkSettings = LegacyMouthTalkSettings;
+            Head.MouthTalkSettings = LegacyMouthTalkSettings_DEPRECATED;
         }
 
         // Migrate transform
-        if (!LegacyGlobalOffset.IsZero() || LegacyGlobalScale != 1.0f)
+        if (!LegacyGlobalOffset_DEPRECATED.IsZero() || LegacyGlobalScale_DEPRECATED != 1.0f)
         {
-            Transform.GlobalOffset = LegacyGlobalOffset;
-            Transform.GlobalScale = LegacyGlobalScale;
+            Transform.GlobalOffset = LegacyGlobalOffset_DEPRECATED;
+            Transform.GlobalScale = LegacyGlobalScale_DEPRECATED;
         }
+
+        // Данные перенесены — старые поля больше не держат память
+        LegacyBody_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyArms_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyHead_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyEyebrow_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyEyes_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyEyelids_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyEyelidsBlinkSettings_DEPRECATED = FCharacter2DBlinkSettings();
+        LegacyMouth_DEPRECATED = FCharacter2DSpriteLayer();
+        LegacyMouthTalkSettings_DEPRECATED = FCharacter2DTalkSettings();
     }
+#endif
+};
+
+/* ───────────────────────────── Expression Sets ───────────────────────────── */
+/** Замена спрайта одного слоя в выражении */
+USTRUCT(BlueprintType)
+struct FCharacter2DExpressionLayer
+{
+    GENERATED_BODY()
+
+    /** Id слоя из UCharacter2DAsset::SpriteLayers */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Expression")
+    int32 LayerId = INDEX_NONE;
+
+    /** Пусто — слой показывает свой спрайт из SpriteLayers */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Expression", meta=(AssetBundles="Sprite"))
+    TSoftObjectPtr<UPaperSprite> Sprite;
+
+#if WITH_EDITORONLY_DATA
+    /** Слой фиксированного набора (до FCharacter2DCustomVersion::GenericSpriteLayers) */
+    UPROPERTY()
+    ECharacter2DSpriteLayer Layer_DEPRECATED = ECharacter2DSpriteLayer::Mouth;
+#endif
+};
+
+/** Именованное выражение лица: какие слои чем заменить; остальные слои — из SpriteLayers */
+USTRUCT(BlueprintType)
+struct FCharacter2DExpressionSet
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Expression")
+    FName Name;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Expression", meta=(TitleProperty="LayerId"))
+    TArray<FCharacter2DExpressionLayer> Layers;
 };
 
 /* ───────────────────────────── Skeletal Material Entry ───────────────────────────── */
@@ -480,8 +475,8 @@ struct FCharacter2DSkeletalMaterial
     GENERATED_BODY()
 
     /** Материал */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Skeletal")
-    TObjectPtr<UMaterialInterface> Material = nullptr;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Skeletal", meta=(AssetBundles="Skeletal"))
+    TSoftObjectPtr<UMaterialInterface> Material;
 
     /** Индекс слота (0,1,2…) */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Skeletal")
@@ -495,16 +490,16 @@ struct FCharacter2DSkeletalPart
     GENERATED_BODY()
 
     /** SkeletalMesh */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal")
-    TObjectPtr<USkeletalMesh> Mesh = nullptr;
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal", meta=(AssetBundles="Skeletal"))
+    TSoftObjectPtr<USkeletalMesh> Mesh;
 
     /** Список материалов + индекс */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal")
     TArray<FCharacter2DSkeletalMaterial> Materials;
 
     /** AnimBlueprint */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal")
-    TSubclassOf<UAnimInstance> AnimInstance;
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal", meta=(AssetBundles="Skeletal"))
+    TSoftClassPtr<UAnimInstance> AnimInstance;
 
     /** Локальный оффсет */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal")
@@ -533,17 +528,109 @@ struct FCharacter2DVisualNovelSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Visual Novel|Appearance")
     float DefaultFadeDuration = 1.0f;
 
+    /** Built-in fade easing used when no DefaultFadeCurve is set */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Visual Novel|Appearance")
+    ECharacter2DEasing DefaultFadeEasing = ECharacter2DEasing::Linear;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Visual Novel|Appearance")
     TObjectPtr<UCurveFloat> DefaultFadeCurve = nullptr;
 };
 
+/* ───────────────────────────── Sprite Atlas ───────────────────────────── */
+USTRUCT(BlueprintType)
+struct FCharacter2DAtlasFrame
+{
+    GENERATED_BODY()
+
+    /** Исходный спрайт (слой или кадр Flipbook) */
+    UPROPERTY(VisibleAnywhere, Category="Atlas")
+    FSoftObjectPath SourceSprite;
+
+    /** Обрезанный прямоугольник в пространстве спрайта (UU, X вправо, Y вверх); смещение обрезки уже учтено */
+    UPROPERTY(VisibleAnywhere, Category="Atlas")
+    FBox2D LocalRect = FBox2D(ForceInit);
+
+    /** Прямоугольник кадра в UV атласа */
+    UPROPERTY(VisibleAnywhere, Category="Atlas")
+    FBox2D UVRect = FBox2D(ForceInit);
+
+    /** Материал спрайта по умолчанию: кадр рисуется без загрузки самого спрайта */
+    UPROPERTY(VisibleAnywhere, Category="Atlas")
+    TObjectPtr<UMaterialInterface> Material = nullptr;
+};
+
+USTRUCT(BlueprintType)
+struct FCharacter2DSpriteAtlas
+{
+    GENERATED_BODY()
+
+    /** Общая текстура всех слоёв и кадров Flipbook */
+    UPROPERTY(VisibleAnywhere, Category="Atlas")
+    TObjectPtr<UTexture2D> Texture = nullptr;
+
+    UPROPERTY(VisibleAnywhere, Category="Atlas")
+    TArray<FCharacter2DAtlasFrame> Frames;
+
+    /** Хэш исходных спрайтов на момент сборки (см. UCharacter2DAsset::ComputeSpriteAtlasHash) */
+    UPROPERTY()
+    uint32 SourceHash = 0;
+
+    bool IsValid() const { return Texture != nullptr && Frames.Num() > 0; }
+
+    /**
+     * Индекс кадра, который рисуется без загрузки спрайта, или INDEX_NONE.
+     * Кадры атласов, собранных до записи Material, не годятся — для них нужен исходный спрайт.
+     */
+    int32 FindFrameIndex(const FSoftObjectPath& SpritePath) const;
+};
+
+DECLARE_DYNAMIC_DELEGATE(FOnCharacter2DAssetLoaded);
+
 /* ───────────────────────────── DataAsset ───────────────────────────── */
+/**
+ * Спрайты, Flipbook, меши, материалы и AnimInstance — мягкие ссылки с бандлами
+ * "Sprite" и "Skeletal": ассет грузится без зависимостей, нужные части
+ * подгружаются асинхронно через RequestLoad и держатся до ReleaseBundles.
+ */
 UCLASS(BlueprintType)
-class CHARACTER2DRUNTIME_API UCharacter2DAsset : public UDataAsset
+class CHARACTER2DRUNTIME_API UCharacter2DAsset : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
 public:
+    static const FPrimaryAssetType PrimaryAssetType;
+    static const FName SpriteBundle;
+    static const FName SkeletalBundle;
+
+    /** Как SpriteBundle, но без спрайтов, попавших в SpriteAtlas: их кадры рисуются из текстуры атласа */
+    static const FName SpriteAtlasBundle;
+
+    /* ─── Async Loading ──────────────────────────────────────────── */
+    /** Пути зависимостей бандлов (SpriteBundle / SpriteAtlasBundle / SkeletalBundle) */
+    void GatherBundlePaths(TConstArrayView<FName> Bundles, TArray<FSoftObjectPath>& OutPaths) const;
+
+    /**
+     * Асинхронно грузит бандлы через FStreamableManager ассет-менеджера.
+     * OnLoaded вызывается на game thread, сразу — если всё уже загружено.
+     * Загруженное держится ассетом до ReleaseBundles.
+     */
+    TSharedPtr<FStreamableHandle> RequestLoad(TConstArrayView<FName> Bundles, FStreamableDelegate OnLoaded = FStreamableDelegate(), TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+    /** Предзагрузка для сценариев сцены (Blueprint); пустой список — все бандлы */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Loading")
+    void PreloadBundles(const TArray<FName>& Bundles, FOnCharacter2DAssetLoaded OnLoaded);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Loading")
+    bool AreBundlesLoaded(const TArray<FName>& Bundles) const;
+
+    /** Отпускает удержание загруженных бандлов (объекты выгрузит GC, если на них больше никто не ссылается) */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Loading")
+    void ReleaseBundles();
+
+    //~ Begin UPrimaryDataAsset Interface
+    virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+    //~ End UPrimaryDataAsset Interface
+
     /* ─── Skeletal Parts ───────────────────────────────────────── */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Skeletal", meta=(DisplayName="Body"))
     FCharacter2DSkeletalPart Body;
@@ -563,96 +650,160 @@ public:
     float GlobalScale = 1.0f;
 
     /* ─── Sprite ─────────────────────────────────────────────────── */
+    /** Спрайтовые слои в порядке отрисовки (снизу вверх); персонаж платит только за те, что есть */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite", meta=(TitleProperty="Name"))
+    TArray<FCharacter2DSpriteLayer> SpriteLayers;
+
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite")
-    FCharacter2DSpriteStructure SpriteStructure;
+    FCharacter2DSpriteTransformStructure SpriteTransform;
 
-    /* ─── Visual Novel Effects ────────────────────────────────────── */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Visual Novel")
-    FCharacter2DVisualNovelSettings VisualNovelSettings;
+    /** Id слоя, статичный спрайт которого подменяется кадрами моргания */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite|Blink")
+    int32 BlinkLayerId = INDEX_NONE;
 
-    /** Автоматически моргать при запуске */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="General")
-    bool bAutoBlink = false;
+    /** Настройки случайного моргания */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite|Blink")
+    FCharacter2DBlinkSettings BlinkSettings;
 
-    /** Автоматически говорить при запуске */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="General")
-    bool bAutoTalk = false;
+    /** Id слоя, статичный спрайт которого подменяется кадрами разговора */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite|Talk")
+    int32 TalkLayerId = INDEX_NONE;
 
-    /** Enable both sprite and skeletal mesh rendering simultaneously */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="General")
-    bool bEnableDualRendering = false;
+    /** Настройки разговора */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite|Talk")
+    FCharacter2DTalkSettings TalkSettings;
 
-    // Helper functions to access sprite data with backward compatibility
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteBodyStructure& GetBodySprite() const
+    /** Индекс слоя в SpriteLayers по Id или INDEX_NONE */
+    int32 FindSpriteLayerIndex(int32 LayerId) const
     {
-        return SpriteStructure.Body;
+        return LayerId == INDEX_NONE ? INDEX_NONE
+            : SpriteLayers.IndexOfByPredicate([LayerId](const FCharacter2DSpriteLayer& Layer) { return Layer.Id == LayerId; });
     }
 
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteArmsStructure& GetArmsSprite() const
-    {
-        return SpriteStructure.Arms;
-    }
+    /** Id слоя по имени или INDEX_NONE */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    int32 FindSpriteLayerId(FName Name) const;
 
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteLayer& GetHeadSprite() const
-    {
-        return SpriteStructure.Head.Head;
-    }
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    bool GetSpriteLayer(int32 LayerId, FCharacter2DSpriteLayer& OutLayer) const;
 
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteLayer& GetEyebrowSprite() const
+    /** Индекс родителя слоя в SpriteLayers; INDEX_NONE — нет родителя, он не найден или замыкает цикл */
+    int32 GetSpriteLayerParentIndex(int32 LayerIndex) const;
+
+    /** Трансформ слоя относительно актёра: свой оффсет/масштаб с глобальными, затем цепочка родителей */
+    FTransform GetSpriteLayerTransform(int32 LayerIndex) const;
+
+    /** Добавляет слой поверх остальных; возвращает выданный Id */
+    int32 AddSpriteLayer(FName Name, const TSoftObjectPtr<UPaperSprite>& Sprite, int32 ParentId = INDEX_NONE);
+
+    /** Выдаёт Id слоям без Id и копиям (дублирование элемента массива в редакторе копирует Id) */
+    void EnsureSpriteLayerIds();
+
+    /* ─── Expressions ────────────────────────────────────────────── */
+    /** Варианты лица для ACharacter2DActor::SetExpression; порядок задаёт индексы SetExpressionByIndex */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite|Expressions", meta=(TitleProperty="Name"))
+    TArray<FCharacter2DExpressionSet> ExpressionSets;
+
+    /** Индекс выражения по имени или INDEX_NONE */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Expressions")
+    int32 FindExpressionIndex(FName Name) const;
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Expressions")
+    int32 GetNumExpressions() const { return ExpressionTableNum; }
+
+    /** Индекс спрайта слоя LayerIndex в выражении (для GetExpressionSprite) или INDEX_NONE — свой спрайт слоя */
+    int32 GetExpressionSpriteIndex(int32 Expression, int32 LayerIndex) const
     {
-        return SpriteStructure.Head.Eyebrow;
+        return Expression >= 0 && Expression < ExpressionTableNum && LayerIndex >= 0 && LayerIndex < ExpressionTableLayers
+            ? ExpressionTable[Expression * ExpressionTableLayers + LayerIndex]
+            : INDEX_NONE;
     }
 
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteLayer& GetEyesSprite() const
+    /** Загруженный заранее (бандл Sprite) спрайт выражения; иначе грузит синхронно */
+    UPaperSprite* GetExpressionSprite(int32 SpriteIndex) const
     {
-        return SpriteStructure.Head.Eyes;
+        return ExpressionSprites.IsValidIndex(SpriteIndex) ? ExpressionSprites[SpriteIndex].LoadSynchronous() : nullptr;
     }
 
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteLayer& GetEyelidsSprite() const
+    /** Путь спрайта выражения без загрузки (пустой — свой спрайт слоя) */
+    FSoftObjectPath GetExpressionSpritePath(int32 SpriteIndex) const
     {
-        return SpriteStructure.Head.Eyelids;
+        return ExpressionSprites.IsValidIndex(SpriteIndex) ? ExpressionSprites[SpriteIndex].ToSoftObjectPath() : FSoftObjectPath();
     }
 
-    UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
-    const FCharacter2DSpriteLayer& GetMouthSprite() const
+    /** Сворачивает ExpressionSets в плоскую таблицу слой → индекс спрайта */
+    void BuildExpressionTable();
+
+    /** Базовый спрайт слоя LayerIndex из SpriteLayers */
+    const TSoftObjectPtr<UPaperSprite>& GetLayerSprite(int32 LayerIndex) const
     {
-        return SpriteStructure.Head.Mouth;
+        return SpriteLayers[LayerIndex].Sprite;
     }
 
+    /* ─── Visual Novel Effects ────────────────────────────────────── */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Visual Novel")
+    FCharacter2DVisualNovelSettings VisualNovelSettings;
+
+    /** Автоматически моргать при запуске */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="General")
+    bool bAutoBlink = false;
+
+    /** Автоматически говорить при запуске */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="General")
+    bool bAutoTalk = false;
+
+    /** Enable both sprite and skeletal mesh rendering simultaneously */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="General")
+    bool bEnableDualRendering = false;
+
+    /* ─── Sprite Atlas ───────────────────────────────────────────── */
+    /** Собирать при сохранении обрезанный атлас всех слоёв и кадров Flipbook */
+    UPROPERTY(EditAnywhere, Category="Sprite|Atlas")
+    bool bBuildSpriteAtlas = true;
+
+    UPROPERTY(VisibleAnywhere, Category="Sprite|Atlas")
+    FCharacter2DSpriteAtlas SpriteAtlas;
+
+    /** Все уникальные спрайты ассета: слои + кадры моргания и разговора (грузит синхронно) */
+    void GatherAtlasSprites(TArray<UPaperSprite*>& OutSprites) const;
+
+    /** Атлас можно рисовать вместо спрайтов: собран, а в редакторе ещё и соответствует текущим спрайтам */
+    bool CanUseSpriteAtlas() const;
+
     UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
     const FCharacter2DBlinkSettings& GetBlinkSettings() const
     {
-        return SpriteStructure.Head.EyelidsBlinkSettings;
+        return BlinkSettings;
     }
 
     UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
     const FCharacter2DTalkSettings& GetTalkSettings() const
     {
-        return SpriteStructure.Head.MouthTalkSettings;
+        return TalkSettings;
     }
 
     UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
     FVector GetGlobalSpriteOffset() const
     {
-        return SpriteStructure.Transform.GlobalOffset;
+        return SpriteTransform.GlobalOffset;
     }
 
     UFUNCTION(BlueprintCallable, Category = "Character2D|Sprites")
     float GetGlobalSpriteScale() const
     {
-        return SpriteStructure.Transform.GlobalScale;
+        return SpriteTransform.GlobalScale;
     }
 
 #if WITH_EDITOR
     // Editor-only hooks
     virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
     virtual void GetAssetRegistryTags(FAssetRegistryTagsContext Context) const override;
+
+    /** Хэш исходных данных атласа: пути спрайтов, их геометрия и исходные текстуры */
+    uint32 ComputeSpriteAtlasHash() const;
+
+    /** Атлас собран и соответствует текущим спрайтам */
+    bool IsSpriteAtlasUpToDate() const;
 #endif
 
     /** Runtime validation methods */
@@ -665,10 +816,37 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Character2D|Validation")
     bool HasValidSkeletalConfiguration() const;
 
+    virtual void Serialize(FArchive& Ar) override;
+
 protected:
     virtual void PostLoad() override;
     
 private:
-    /** Migrate data from legacy versions */
-    void MigrateLegacyData();
+#if WITH_EDITORONLY_DATA
+    /** Структура Body/Arms/Head до FCharacter2DCustomVersion::GenericSpriteLayers; переносится в SpriteLayers */
+    UPROPERTY()
+    FCharacter2DSpriteStructure SpriteStructure_DEPRECATED;
+
+    /** Migrate data from legacy versions: шаги для всех версий ассета новее Version */
+    void MigrateLegacyData(int32 Version);
+
+    /** SpriteStructure_DEPRECATED → SpriteLayers; Id слоя равен значению ECharacter2DSpriteLayer */
+    void MigrateSpriteLayers();
+#endif
+
+    /** Следующий свободный Id слоя; выданные Id не переиспользуются */
+    UPROPERTY()
+    int32 NextSpriteLayerId = 0;
+
+    /** Удержание асинхронно загруженных бандлов */
+    TArray<TSharedPtr<FStreamableHandle>> BundleHandles;
+
+    /** Уникальные спрайты всех выражений */
+    TArray<TSoftObjectPtr<UPaperSprite>> ExpressionSprites;
+    /** ExpressionTableNum x ExpressionTableLayers индексов в ExpressionSprites */
+    TArray<int16> ExpressionTable;
+    TMap<FName, int32> ExpressionLookup;
+    int32 ExpressionTableNum = 0;
+    /** Число слоёв на момент BuildExpressionTable */
+    int32 ExpressionTableLayers = 0;
 };
\ No newline at end of file
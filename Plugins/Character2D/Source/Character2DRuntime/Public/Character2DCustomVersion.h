@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Guid.h"
+
+/** Версия сериализации ассетов плагина (UCharacter2DAsset) */
+struct CHARACTER2DRUNTIME_API FCharacter2DCustomVersion
+{
+    enum Type
+    {
+        // До введения версии: Legacy*-поля спрайтов, миграция на каждой загрузке
+        BeforeCustomVersionWasAdded = 0,
+
+        // Legacy*-поля перенесены в Body/Arms/Head/Transform и больше не сохраняются
+        LegacySpriteFieldsRemoved,
+
+        // Body/Arms/Head заменены списком SpriteLayers со стабильными Id; выражения ссылаются на Id слоя
+        GenericSpriteLayers,
+
+        // -----<new versions can be added above this line>-------------------------------------------------
+        VersionPlusOne,
+        LatestVersion = VersionPlusOne - 1
+    };
+
+    static const FGuid GUID;
+
+private:
+    FCharacter2DCustomVersion() {}
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "Misc/EnumClassFlags.h"
 #include "Character2DEnums.generated.h"
 
 UENUM(BlueprintType)
@@ -9,3 +10,76 @@ enum class ECharacter2DEditMode : uint8
 	Head  UMETA(DisplayName="Head"),
 	Pose  UMETA(DisplayName="Pose")
 };
+
+/**
+ * Слои прежнего фиксированного набора. Остались только для загрузки старых ассетов:
+ * при миграции слой получает Id, равный значению (см. UCharacter2DAsset::SpriteLayers).
+ */
+UENUM()
+enum class ECharacter2DSpriteLayer : uint8
+{
+	Body     UMETA(DisplayName="Body"),
+	Arms     UMETA(DisplayName="Arms"),
+	Head     UMETA(DisplayName="Head"),
+	Eyebrow  UMETA(DisplayName="Eyebrow"),
+	Eyes     UMETA(DisplayName="Eyes"),
+	Eyelids  UMETA(DisplayName="Eyelids"),
+	Mouth    UMETA(DisplayName="Mouth"),
+	Count    UMETA(Hidden)
+};
+
+/** Где считаются эффекты эмоций */
+UENUM(BlueprintType)
+enum class ECharacter2DEmotionRenderMode : uint8
+{
+	/** Смещение/масштаб/цвет актёра каждый кадр на game thread */
+	CPU  UMETA(DisplayName="CPU"),
+	/** Параметры один раз пишутся в Custom Primitive Data, эффект считает материал */
+	GPU  UMETA(DisplayName="GPU (Material)")
+};
+
+/** Чем выполняются fade и подкраска персонажа */
+UENUM(BlueprintType)
+enum class ECharacter2DTintRenderMode : uint8
+{
+	/** Цвет вершин спрайтов; скелетные меши при fade только скрываются */
+	SpriteColor    UMETA(DisplayName="Sprite Color (Legacy)"),
+	/** Custom Primitive Data на всех примитивах, включая скелетные меши (см. Character2DPrimitiveData.h) */
+	PrimitiveData  UMETA(DisplayName="Custom Primitive Data")
+};
+
+/** Уровень детализации персонажа по значимости (UCharacter2DSignificanceSubsystem) */
+UENUM(BlueprintType)
+enum class ECharacter2DSignificanceTier : uint8
+{
+	/** Всё анимируется с полной частотой */
+	Full     UMETA(DisplayName="Full"),
+	/** Реже моргает, Flipbook обновляются с пониженной частотой, скелетные меши не анимируются */
+	Reduced  UMETA(DisplayName="Reduced"),
+	/** Ничего не тикает, таймер моргания на паузе (фаза сохраняется) */
+	Dormant  UMETA(DisplayName="Dormant")
+};
+
+/**
+ * Части персонажа для частичного обновления (ACharacter2DActor::RefreshLayers).
+ * Спрайтовые слои произвольные (UCharacter2DAsset::SpriteLayers) и идут одним битом;
+ * биты 1-6 раньше были слоями фиксированного набора и не используются.
+ */
+UENUM(meta=(Bitflags, UseEnumValuesAsMaskValuesInEditor="true"))
+enum class ECharacter2DLayerMask : uint32
+{
+	None           = 0 UMETA(Hidden),
+	Sprites        = 1 << 0 UMETA(DisplayName="Sprite Layers"),
+	BlinkFlipbook  = 1 << 7,
+	TalkFlipbook   = 1 << 8,
+	SkeletalBody   = 1 << 9,
+	SkeletalArms   = 1 << 10,
+	SkeletalHead   = 1 << 11,
+	/** Видимость спрайтов и скелета по составу ассета (bEnableDualRendering) */
+	Visibility     = 1 << 12,
+
+	Flipbooks      = BlinkFlipbook | TalkFlipbook UMETA(Hidden),
+	Skeletal       = SkeletalBody | SkeletalArms | SkeletalHead UMETA(Hidden),
+	All            = Sprites | Flipbooks | Skeletal | Visibility UMETA(Hidden)
+};
+ENUM_CLASS_FLAGS(ECharacter2DLayerMask);
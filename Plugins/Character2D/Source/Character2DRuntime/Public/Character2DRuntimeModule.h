@@ -4,6 +4,6 @@
 class CHARACTER2DRUNTIME_API FCharacter2DRuntimeModule : public IModuleInterface
 {
 public:
-    virtual void StartupModule() override {}
-    virtual void ShutdownModule() override {}
+    virtual void StartupModule() override;
+    virtual void ShutdownModule() override;
 };
\ No newline at end of file
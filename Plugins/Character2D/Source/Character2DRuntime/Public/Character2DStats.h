@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** stat Character2D — счётчики рантайма плагина */
+DECLARE_STATS_GROUP(TEXT("Character2D"), STATGROUP_Character2D, STATCAT_Advanced);
+
+/* ─── Game thread time ─── */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnConstruction"), STAT_Character2D_OnConstruction, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Asset State"), STAT_Character2D_ApplyAssetState, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Set Sprites Opacity"), STAT_Character2D_SetSpritesOpacity, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Set Sprites Color"), STAT_Character2D_SetSpritesColor, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Set Skeletal Opacity"), STAT_Character2D_SetSkeletalOpacity, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handle Blink"), STAT_Character2D_HandleBlink, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Animation Evaluate"), STAT_Character2D_AnimationEvaluate, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Animation Commit"), STAT_Character2D_AnimationCommit, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Director Flush"), STAT_Character2D_DirectorFlush, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+
+/* ─── Characters ─── */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Characters"), STAT_Character2D_ActiveCharacters, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Moves"), STAT_Character2D_ActiveMoves, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Fades"), STAT_Character2D_ActiveFades, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Emotions"), STAT_Character2D_ActiveEmotions, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Components Updated"), STAT_Character2D_ComponentsUpdated, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+
+/* ─── Insights ─── */
+/** Канал Unreal Insights с командами персонажам: -trace=cpu,Character2D */
+UE_TRACE_CHANNEL_EXTERN(Character2DChannel, CHARACTER2DRUNTIME_API);
+
+/** Цикл-счётчик stat Character2D и событие CPU-профайлера Insights одним макросом */
+#define CHARACTER2D_SCOPE_CYCLE_COUNTER(Stat) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+
+/** Команда персонажу в Insights ("Character2D.MoveTo BP_Alice_C_0"); строка собирается, только если канал включён */
+#define CHARACTER2D_TRACE_COMMAND(Command, Actor) \
+    TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL( \
+        UE_TRACE_CHANNELEXPR_IS_ENABLED(Character2DChannel) ? *FString::Printf(TEXT("Character2D.%s %s"), TEXT(Command), *GetNameSafe(Actor)) : TEXT(""), \
+        Character2DChannel)
+
+/* ─── Curve LUT cache ─── */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Curve LUT Hits"), STAT_Character2D_CurveLUTHits, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Curve LUT Misses"), STAT_Character2D_CurveLUTMisses, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Curve LUTs Cached"), STAT_Character2D_CurveLUTsCached, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+
+/* ─── Actor pool ─── */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Hits"), STAT_Character2D_PoolHits, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Retargets"), STAT_Character2D_PoolRetargets, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Misses"), STAT_Character2D_PoolMisses, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Actors"), STAT_Character2D_PooledActors, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+
+/* ─── Blink scheduling ─── */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blinks Fired"), STAT_Character2D_BlinksFired, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Blinks Per Second"), STAT_Character2D_BlinksPerSecond, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+
+/* ─── Director ─── */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Director Commands"), STAT_Character2D_DirectorCommands, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Director Coalesced"), STAT_Character2D_DirectorCoalesced, STATGROUP_Character2D, CHARACTER2DRUNTIME_API);
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "DynamicMeshBuilder.h"
+#include "Character2DEnums.h"
+#include "Character2DLayeredSpriteComponent.generated.h"
+
+class UCharacter2DAsset;
+struct FCharacter2DAtlasFrame;
+class UPaperSprite;
+class UPaperFlipbook;
+class UMaterialInstanceDynamic;
+
+/* ───────────────────────────── Layer State ───────────────────────────── */
+/** Состояние слоя; индекс совпадает с индексом в UCharacter2DAsset::SpriteLayers */
+USTRUCT()
+struct FCharacter2DLayeredSpriteLayer
+{
+    GENERATED_BODY()
+
+    /** Статичный спрайт слоя из ассета; загружается, только если его нет в атласе */
+    UPROPERTY(Transient)
+    TObjectPtr<UPaperSprite> Sprite = nullptr;
+
+    /** Кадр атласа статичного спрайта или INDEX_NONE */
+    int32 AtlasFrame = INDEX_NONE;
+
+    /** Спрайт выражения поверх спрайта из ассета (пустой путь — спрайт ассета); обновление слоёв из ассета его не сбрасывает */
+    FSoftObjectPath ExpressionSpritePath;
+
+    /** Загруженный спрайт выражения — только если его нет в атласе */
+    UPROPERTY(Transient)
+    TObjectPtr<UPaperSprite> ExpressionSprite = nullptr;
+
+    int32 ExpressionAtlasFrame = INDEX_NONE;
+
+    /** Трансформ слоя относительно компонента */
+    UPROPERTY(Transient)
+    FTransform LayerTransform = FTransform::Identity;
+
+    /** Трансформ кадров Flipbook относительно компонента (у слоёв моргания и разговора — трансформ родителя) */
+    UPROPERTY(Transient)
+    FTransform FrameTransform = FTransform::Identity;
+
+    UPROPERTY(Transient)
+    bool bVisible = true;
+
+    /** Flipbook, кадры которого подменяют статичный спрайт во время воспроизведения */
+    UPROPERTY(Transient)
+    TObjectPtr<UPaperFlipbook> Flipbook = nullptr;
+
+    /** Кадры атласа для ключевых кадров Flipbook (INDEX_NONE — рисуется спрайт кадра) */
+    TArray<int32> FlipbookAtlasFrames;
+
+    float PlayRate = 1.0f;
+    float PlaybackTime = 0.0f;
+    int32 FrameIndex = INDEX_NONE;
+    bool bLooping = false;
+    bool bPlaying = false;
+
+    /**
+     * Что сейчас выводится (статичный спрайт, выражение или кадр Flipbook):
+     * OutAtlasFrame — кадр атласа или INDEX_NONE, тогда возвращается спрайт для запечённой геометрии.
+     */
+    const UPaperSprite* GetDisplayedSprite(int32& OutAtlasFrame) const;
+};
+
+/* ───────────────────────────── Render Section ───────────────────────────── */
+/** Непрерывный диапазон индексов с одним материалом/текстурой (один draw call) */
+struct FCharacter2DLayeredSpriteSection
+{
+    TObjectPtr<UMaterialInterface> Material = nullptr;
+    int32 FirstIndex = 0;
+    int32 NumTriangles = 0;
+    uint32 MinVertexIndex = 0;
+    uint32 MaxVertexIndex = 0;
+};
+
+/** Вершины одного слоя в общем буфере: по ним кадр Flipbook или выражение обновляется на месте */
+struct FCharacter2DLayeredSpriteLayerRange
+{
+    TObjectPtr<UMaterialInterface> Material = nullptr;
+    uint32 FirstVertex = 0;
+    uint32 NumVertices = 0;
+};
+
+/** Что рисует слой сейчас: кадр атласа (квад) или запечённые треугольники спрайта */
+struct FCharacter2DLayeredSpriteLayerDraw
+{
+    const UPaperSprite* Sprite = nullptr;
+    const FCharacter2DAtlasFrame* AtlasFrame = nullptr;
+    UMaterialInterface* Material = nullptr;
+    int32 NumVertices = 0;
+};
+
+/** Геометрия всех слоёв персонажа, собранная в один vertex/index буфер */
+struct FCharacter2DLayeredSpriteRenderData
+{
+    TArray<FDynamicMeshVertex> Vertices;
+    TArray<uint32> Indices;
+    TArray<FCharacter2DLayeredSpriteSection> Sections;
+
+    /** По индексу слоя; NumVertices == 0 — слой не рисуется */
+    TArray<FCharacter2DLayeredSpriteLayerRange> LayerRanges;
+    FBox LocalBox = FBox(ForceInit);
+
+    /** Те же секции и индексы: новые вершины можно записать в буферы существующего proxy */
+    bool HasSameSectionLayout(const FCharacter2DLayeredSpriteRenderData& Other) const;
+};
+
+/**
+ * Рисует все спрайтовые слои UCharacter2DAsset (сколько их есть в ассете) одним примитивом:
+ * один scene proxy, один vertex/index буфер, по одному draw call на каждую
+ * последовательность слоёв с общей текстурой (один на персонажа при атласе).
+ * Кадры моргания и разговора подменяются обновлением вершин/UV слоя,
+ * без переключения отдельных компонентов.
+ */
+UCLASS(ClassGroup=(Character2D), meta=(BlueprintSpawnableComponent))
+class CHARACTER2DRUNTIME_API UCharacter2DLayeredSpriteComponent : public UMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    UCharacter2DLayeredSpriteComponent();
+
+    /** Имя текстурного параметра в материалах спрайтов Paper2D */
+    static const FName SpriteTextureParameterName;
+
+    /** Проверяет, можно ли нарисовать спрайтовые слои ассета одним примитивом (без крепления к сокетам) */
+    static bool CanBatchAsset(const UCharacter2DAsset* Asset);
+
+    /** Перестраивает слои по ассету */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    void SetCharacterAsset(UCharacter2DAsset* InAsset);
+
+    /** Перечитать слои из ассета; Flipbook и выражения сохраняются, если число слоёв то же */
+    void RefreshLayersFromAsset();
+
+    UCharacter2DAsset* GetCharacterAsset() const { return SourceAsset; }
+
+    /* Слои адресуются индексом в UCharacter2DAsset::SpriteLayers (см. FindSpriteLayerIndex) */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    void SetLayerVisible(int32 LayerIndex, bool bVisible);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    bool IsLayerVisible(int32 LayerIndex) const;
+
+    int32 GetNumLayers() const { return Layers.Num(); }
+
+    /**
+     * Спрайты выражения для слоёв с установленным битом Changed, Sprites — пути по индексу слоя
+     * (пустой — спрайт из ассета). Одна пересборка на все слои; при атласе меняются только UV,
+     * а сами спрайты не загружаются.
+     */
+    void SetExpressionSprites(const TBitArray<>& Changed, TConstArrayView<FSoftObjectPath> Sprites);
+
+    /** Подменяет статичный спрайт слоя кадрами Flipbook */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Animation")
+    void PlayLayerFlipbook(int32 LayerIndex, UPaperFlipbook* Flipbook, float PlayRate = 1.0f, bool bLoop = false);
+
+    /** Останавливает Flipbook и возвращает статичный спрайт слоя */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Animation")
+    void StopLayerFlipbook(int32 LayerIndex);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Animation")
+    bool IsLayerFlipbookPlaying(int32 LayerIndex) const;
+
+    bool IsAnyLayerFlipbookPlaying() const;
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    void SetSpriteColor(const FLinearColor& NewColor);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Sprites")
+    FLinearColor GetSpriteColor() const { return SpriteColor; }
+
+    /**
+     * Показывать вместо статичных слоёв один квад с готовой композицией персонажа (импостор);
+     * играющие Flipbook (моргание, рот) рисуются поверх своими квадами.
+     * LocalBox — область композиции в пространстве компонента (X — вправо, Z — вверх).
+     */
+    void SetImpostor(UTexture* Texture, UMaterialInterface* Material, const FBox& LocalBox);
+    void ClearImpostor();
+    bool IsShowingImpostor() const { return ImpostorTexture != nullptr; }
+
+    /** Статичная композиция изменилась (слои, видимость, материал); импостор уже сброшен */
+    FSimpleMulticastDelegate OnStaticLayersChanged;
+
+    /** Пауза Flipbook слоёв без сброса времени воспроизведения (значимость Dormant) */
+    void SetFlipbooksPaused(bool bPaused);
+
+    /** Количество секций (draw calls) в текущей геометрии */
+    int32 GetNumSections() const { return RenderData.Sections.Num(); }
+
+    /** Слои рисуются из атласа ассета (см. UCharacter2DAsset::SpriteAtlas) */
+    bool IsUsingSpriteAtlas() const { return !AtlasFrameLookup.IsEmpty(); }
+
+    /** Смещение каждого следующего слоя по оси глубины Paper2D (против z-fighting между секциями) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite")
+    float LayerDepthSpacing = 0.0f;
+
+    //~ Begin UPrimitiveComponent Interface
+    virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+    virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+    virtual void GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials = false) const override;
+    virtual UMaterialInterface* GetMaterial(int32 MaterialIndex) const override;
+    virtual int32 GetNumMaterials() const override;
+    virtual void SetMaterial(int32 ElementIndex, UMaterialInterface* Material) override;
+    //~ End UPrimitiveComponent Interface
+
+    //~ Begin UActorComponent Interface
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void SendRenderDynamicData_Concurrent() override;
+    //~ End UActorComponent Interface
+
+protected:
+    UPROPERTY(Transient)
+    TArray<FCharacter2DLayeredSpriteLayer> Layers;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sprite")
+    FLinearColor SpriteColor = FLinearColor::White;
+
+    /** Ассет-источник; держит атлас и спрайты */
+    UPROPERTY(Transient)
+    TObjectPtr<UCharacter2DAsset> SourceAsset = nullptr;
+
+    /** Материалы с подставленной текстурой: по одному на пару (материал спрайта, текстура) */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UMaterialInstanceDynamic>> TextureMaterials;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UTexture> ImpostorTexture = nullptr;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UMaterialInterface> ImpostorMaterial = nullptr;
+
+private:
+    /** Пересобирает геометрию; при той же раскладке секций отправляет вершины в proxy без пересоздания */
+    void RebuildRenderData();
+
+    /**
+     * Перезаписывает вершины одного слоя на месте, если число вершин и материал те же
+     * (кадр Flipbook, выражение из атласа); false — нужна RebuildRenderData.
+     */
+    bool TryUpdateLayerGeometry(int32 LayerIndex);
+
+    /** TryUpdateLayerGeometry, иначе полная пересборка */
+    void UpdateLayerGeometry(int32 LayerIndex);
+
+    /** Спрайт, трансформ и видимость всех слоёв из SourceAsset */
+    void ApplyAssetLayers();
+
+    void AppendLayerGeometry(FCharacter2DLayeredSpriteRenderData& OutData, const FCharacter2DLayeredSpriteLayer& Layer, int32 LayerIndex);
+
+    /** false — слой сейчас не рисуется (скрыт, под импостором или без спрайта) */
+    bool ResolveLayerDraw(const FCharacter2DLayeredSpriteLayer& Layer, FCharacter2DLayeredSpriteLayerDraw& OutDraw);
+    void WriteLayerVertices(const FCharacter2DLayeredSpriteLayer& Layer, int32 LayerIndex, const FCharacter2DLayeredSpriteLayerDraw& Draw, FDynamicMeshVertex* OutVertices, FBox& InOutLocalBox) const;
+    void AppendImpostorGeometry(FCharacter2DLayeredSpriteRenderData& OutData);
+    UMaterialInterface* GetOrCreateTextureMaterial(UMaterialInterface* BaseMaterial, UTexture* Texture);
+
+    /** OverrideMaterials[0], если задан, иначе материал спрайта по умолчанию */
+    UMaterialInterface* GetSpriteBaseMaterial(UMaterialInterface* DefaultMaterial) const;
+
+    /** Сбрасывает импостор и оповещает владельца; вызывается при изменении статичных слоёв */
+    void NotifyStaticLayersChanged();
+    void RebuildAtlasLookup();
+
+    /** Кадр атласа для спрайта или INDEX_NONE */
+    int32 FindAtlasFrame(const FSoftObjectPath& SpritePath) const;
+
+    /** Кадр атласа выражения; без него спрайт выражения загружается */
+    void ResolveExpressionSprite(FCharacter2DLayeredSpriteLayer& Layer) const;
+
+    /** Кадры атласа для ключевых кадров Flipbook слоя */
+    void ResolveFlipbookFrames(FCharacter2DLayeredSpriteLayer& Layer) const;
+    void AdvanceFlipbooks(float DeltaTime);
+    void UpdateTickEnabled();
+
+    /** Ключи TextureMaterials: (базовый материал, текстура) */
+    TArray<TPair<const UMaterialInterface*, const UTexture*>> TextureMaterialKeys;
+
+    /** Путь спрайта → кадр атласа; пусто, если атлас не собран или устарел */
+    TMap<FSoftObjectPath, int32> AtlasFrameLookup;
+
+    FCharacter2DLayeredSpriteRenderData RenderData;
+    FBox ImpostorBox = FBox(ForceInit);
+
+    /** Ещё не отправленное в proxy: вершины слоёв, все вершины после пересборки той же раскладки, цвет */
+    TBitArray<> PendingLayerUploads;
+    bool bPendingUploadAll = false;
+    bool bPendingColorUpload = false;
+    bool bFlipbooksPaused = false;
+};
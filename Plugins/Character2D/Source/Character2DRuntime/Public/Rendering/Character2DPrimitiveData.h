@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Character2DAsset.h"
+
+class UPrimitiveComponent;
+
+/**
+ * Раскладка Custom Primitive Data персонажа (читается в материале через
+ * PerInstanceCustomData / Custom Primitive Data по индексу).
+ *
+ * Эмоция записывается один раз при старте; материал считает эффект сам:
+ *   Alpha = saturate((Time - StartTime) / Duration), при Loop — frac(...)
+ *   Value = Easing(Alpha) (формулы Character2DEasing::Apply, Easing — индекс ECharacter2DEasing)
+ *   Shake      — WPO: (hash(floor(Time * Frequency)) * 2 - 1) * Value * Intensity * 10
+ *   Bounce     — WPO: Z += Value * Intensity * 50
+ *   Pulse      — WPO: (LocalPosition - ActorPosition) * Value * Intensity * 0.2
+ *   ColorShift — BaseColor *= lerp(1, TargetColor, Value * Intensity)
+ *   Flash      — Opacity *= Value > 0.5 ? 1 : 0.3 + 0.7 * Intensity
+ * Type == 0 (None) — эффект выключен.
+ *
+ * Tint/fade (ECharacter2DTintRenderMode::PrimitiveData) — четыре float на примитив:
+ *   BaseColor *= Tint.rgb, Opacity *= Tint.a
+ * Спрайтам и скелетным мешам пишутся разные значения (flash красит только спрайты).
+ * Материал скелетных мешей должен быть Translucent или Masked (dither), иначе Tint.a не виден.
+ */
+namespace Character2DPrimitiveData
+{
+    /* ─── Emotion (0..10) ─── */
+    constexpr int32 EmotionType       = 0;   // ECharacter2DEmotionEffect
+    constexpr int32 EmotionStartTime  = 1;   // UWorld::GetTimeSeconds() на старте (= Time в материале)
+    constexpr int32 EmotionDuration   = 2;
+    constexpr int32 EmotionIntensity  = 3;
+    constexpr int32 EmotionFrequency  = 4;   // ShakeFrequency
+    constexpr int32 EmotionEasing     = 5;   // ECharacter2DEasing
+    constexpr int32 EmotionLoop       = 6;   // 0 / 1
+    constexpr int32 EmotionColor      = 7;   // 7..10: TargetColor RGBA
+    constexpr int32 EmotionNumFloats  = 11;
+
+    /* ─── Tint / fade (11..14) ─── */
+    constexpr int32 Tint              = 11;  // 11..14: RGB — цвет, A — прозрачность
+    constexpr int32 NumFloats         = 15;
+
+    /** Эмоцию можно отдать в материал: кривая-ассет на GPU не переносится */
+    CHARACTER2DRUNTIME_API bool CanRunEmotionOnGpu(const FCharacter2DEmotionSettings& Settings);
+
+    CHARACTER2DRUNTIME_API void WriteEmotion(UPrimitiveComponent* Component, ECharacter2DEmotionEffect Type, const FCharacter2DEmotionSettings& Settings, float StartTime);
+    CHARACTER2DRUNTIME_API void ClearEmotion(UPrimitiveComponent* Component);
+
+    /** Одна запись в CPD, без пересоздания render state */
+    CHARACTER2DRUNTIME_API void WriteTint(UPrimitiveComponent* Component, const FLinearColor& Tint);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "Character2DActorPool.generated.h"
+
+class ACharacter2DActor;
+class UCharacter2DAsset;
+
+/**
+ * Пул персонажей для смены сцен: Release прячет актёра вместо Destroy,
+ * Acquire отдаёт спрятанного — без 16 подобъектов и регистрации компонентов.
+ *
+ * Сначала ищется свободный актёр с тем же ассетом (повторная настройка не нужна),
+ * затем любой того же класса (перенастройка под новый ассет), иначе — спавн.
+ * Попадания и промахи — в stat Character2D и GetNumHits / GetNumMisses.
+ */
+UCLASS()
+class CHARACTER2DRUNTIME_API UCharacter2DActorPool : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    static UCharacter2DActorPool* Get(const UObject* WorldContextObject);
+
+    /** Актёр с ассетом Asset в точке Transform; Class — nullptr для ACharacter2DActor */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool", meta=(DeterminesOutputType="Class"))
+    ACharacter2DActor* Acquire(UCharacter2DAsset* Asset, const FTransform& Transform, TSubclassOf<ACharacter2DActor> Class = nullptr);
+
+    /** Сбросить состояние и спрятать; сверх Character2D.Pool.MaxFree актёр уничтожается */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    void Release(ACharacter2DActor* Actor);
+
+    /** Заранее создать свободных актёров под ассет сцены (до Count штук в пуле) */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    void Prewarm(UCharacter2DAsset* Asset, int32 Count, TSubclassOf<ACharacter2DActor> Class = nullptr);
+
+    /** Уничтожить свободных актёров сверх MaxFree */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    void Trim(int32 MaxFree = 0);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    int32 GetNumFree() const { return FreeActors.Num(); }
+
+    /** Acquire без спавна (с тем же ассетом или с перенастройкой) */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    int32 GetNumHits() const { return NumHits; }
+
+    /** Из попаданий — с перенастройкой под другой ассет */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    int32 GetNumRetargets() const { return NumRetargets; }
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    int32 GetNumMisses() const { return NumMisses; }
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Pool")
+    void ResetCounters() { NumHits = NumRetargets = NumMisses = 0; }
+
+    //~ Begin USubsystem / UWorldSubsystem Interface
+    virtual void Deinitialize() override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~ End USubsystem / UWorldSubsystem Interface
+
+private:
+    ACharacter2DActor* SpawnActor(UCharacter2DAsset* Asset, const FTransform& Transform, TSubclassOf<ACharacter2DActor> Class);
+    /** Индекс свободного актёра: с тем же ассетом, иначе любого того же класса */
+    int32 FindFree(const UCharacter2DAsset* Asset, const UClass* Class, bool& bOutSameAsset);
+    void UpdateStats() const;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<ACharacter2DActor>> FreeActors;
+
+    int32 NumHits = 0;
+    int32 NumRetargets = 0;
+    int32 NumMisses = 0;
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Character2DAsset.h"
+#include "Animation/Character2DTween.h"
+#include "Animation/Character2DTimingWheel.h"
+#include "Character2DAnimationSubsystem.generated.h"
+
+class ACharacter2DActor;
+class UCurveFloat;
+
+/** Каналы одного актёра в подсистеме — для снимков и отката (FCharacter2DRuntimeSnapshot) */
+struct FCharacter2DAnimationSlotState
+{
+    bool bMoving = false;
+    bool bFading = false;
+    bool bEmotion = false;
+    bool bBlink = false;
+
+    /*
+     * Кривые твинов: таблица Curve в твине действительна, пока жива её UCurveFloat.
+     * RestoreSlotState снова держит кривую от сборки мусора, а собранную — сбрасывает на Easing
+     */
+    TWeakObjectPtr<UCurveFloat> MoveCurve;
+    TWeakObjectPtr<UCurveFloat> FadeCurve;
+    TWeakObjectPtr<UCurveFloat> EmotionCurve;
+
+    /* Movement */
+    FCharacter2DTween Move;
+    FVector MoveFrom = FVector::ZeroVector;
+    FVector MoveTo = FVector::ZeroVector;
+
+    /* Fade */
+    FCharacter2DTween Fade;
+    bool bFadeIn = false;
+
+    /* Emotion */
+    FCharacter2DTween Emotion;
+    ECharacter2DEmotionEffect EmotionType = ECharacter2DEmotionEffect::None;
+    float EmotionIntensity = 0.0f;
+    FLinearColor EmotionColor = FLinearColor::White;
+    FVector EmotionBaseLocation = FVector::ZeroVector;
+    FVector EmotionBaseScale = FVector::OneVector;
+    bool bEmotionOnGpu = false;
+
+    /* Blink */
+    float BlinkRemaining = 0.0f;
+    bool bBlinkRestorePhase = false;
+};
+
+/**
+ * Анимации всех ACharacter2DActor мира (перемещение, fade, эмоции, таймер моргания)
+ * одним проходом вместо трёх UTimelineComponent и FTimerManager на персонажа.
+ *
+ * Состояние хранится struct-of-arrays по слотам, время и кривые — в POD-твинах
+ * из пула фиксированной ёмкости; кадр считается через ParallelFor
+ * (только математика, без UObject-вызовов), затем результаты пакетом
+ * применяются к актёрам на game thread.
+ *
+ * Таймеры моргания — в общем FCharacter2DTimingWheel: за кадр разбираются только
+ * сработавшие, стоимость не зависит от числа моргающих персонажей.
+ */
+UCLASS()
+class CHARACTER2DRUNTIME_API UCharacter2DAnimationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+    // Запуск команд со сдвигом фазы (StartOffset)
+    friend class UCharacter2DDirector;
+
+public:
+    /** Порог числа слотов, начиная с которого проход идёт на worker-потоках */
+    static constexpr int32 ParallelSlotThreshold = 32;
+
+    /** Ёмкость пула твинов (до трёх на персонажа: перемещение, fade, эмоция) */
+    static constexpr int32 TweenPoolCapacity = 1024;
+
+    static UCharacter2DAnimationSubsystem* Get(const UObject* WorldContextObject);
+
+    /* ─── Movement ─── */
+    /** false — пул твинов заполнен, анимация не запущена */
+    bool StartMovement(ACharacter2DActor* Actor, const FVector& From, const FVector& To, const FCharacter2DMovementSettings& Settings);
+    void StopMovement(ACharacter2DActor* Actor);
+
+    /* ─── Fade ─── */
+    bool StartFade(ACharacter2DActor* Actor, bool bFadeIn, float Duration, ECharacter2DEasing Easing, const UCurveFloat* Curve);
+    void StopFade(ACharacter2DActor* Actor);
+
+    /* ─── Emotion ─── */
+    /** bOnGpu — эффект считает материал (Custom Primitive Data), слот только отсчитывает время до завершения */
+    bool StartEmotion(ACharacter2DActor* Actor, ECharacter2DEmotionEffect Type, const FCharacter2DEmotionSettings& Settings, const FVector& BaseLocation, const FVector& BaseScale, bool bOnGpu = false);
+    void StopEmotion(ACharacter2DActor* Actor);
+
+    /* ─── Blink timer ─── */
+    /** Через Delay секунд вызовет ACharacter2DActor::HandleBlink */
+    void ScheduleBlink(ACharacter2DActor* Actor, float Delay);
+    /** Через Duration секунд вызовет ACharacter2DActor::FinishBlink */
+    void ScheduleBlinkRestore(ACharacter2DActor* Actor, float Duration);
+    void CancelBlink(ACharacter2DActor* Actor);
+    /** Пауза таймера моргания: оставшееся время сохраняется и досчитывается после снятия паузы */
+    void SetBlinkPaused(ACharacter2DActor* Actor, bool bPaused);
+
+    /* ─── Snapshot ─── */
+    /** Текущие каналы актёра; без слота — всё выключено */
+    void CaptureSlotState(const ACharacter2DActor* Actor, FCharacter2DAnimationSlotState& OutState) const;
+    /** Заменяет каналы актёра сохранёнными, без колбэков завершения; false — пул твинов заполнен */
+    bool RestoreSlotState(ACharacter2DActor* Actor, const FCharacter2DAnimationSlotState& State);
+
+    /** Освобождает слот актёра (EndPlay) */
+    void Unregister(ACharacter2DActor* Actor);
+
+    int32 GetNumActiveSlots() const;
+    int32 GetNumScheduledBlinks() const { return BlinkWheel.Num(); }
+    int32 GetNumActiveTweens() const { return TweenPool.GetNumUsed(); }
+
+    //~ Begin USubsystem / UWorldSubsystem Interface
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~ End USubsystem / UWorldSubsystem Interface
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    /** Вне игры тикает только в мирах превью (см. DoesSupportWorldType) */
+    virtual bool IsTickableInEditor() const override { return true; }
+    //~ End FTickableGameObject Interface
+
+private:
+    /** Каналы анимации слота (битовая маска) */
+    enum EChannel : uint8
+    {
+        Channel_Movement = 1 << 0,
+        Channel_Fade     = 1 << 1,
+        Channel_Emotion  = 1 << 2,
+        Channel_Blink    = 1 << 3,
+    };
+
+    /** Что нужно применить к актёру после параллельного прохода */
+    enum EOutput : uint16
+    {
+        Output_Location        = 1 << 0,
+        Output_Scale           = 1 << 1,
+        Output_Color           = 1 << 2,
+        Output_SpriteOpacity   = 1 << 3,
+        Output_SkeletalOpacity = 1 << 4,
+        Output_MoveFinished    = 1 << 5,
+        Output_FadeFinished    = 1 << 6,
+        Output_EmotionFinished = 1 << 7,
+    };
+
+    int32 FindOrAddSlot(ACharacter2DActor* Actor);
+    int32 FindSlot(ACharacter2DActor* Actor) const;
+    void ReleaseSlot(int32 Slot);
+
+    /** Твин канала слота: берётся из пула при первом запуске, переиспользуется при повторном */
+    FCharacter2DTween* AcquireTween(int32& Handle);
+    void ReleaseTween(int32& Handle);
+    /** Держит кривую твина Handle, пока он в работе (его таблица в FCharacter2DCurveCache живёт, пока жива кривая) */
+    void SetTweenCurve(int32 Handle, const UCurveFloat* Curve);
+
+    /** Расчёт одного слота; безопасно вызывать с worker-потоков */
+    void EvaluateSlot(int32 Slot, float DeltaTime);
+
+    /** Применение результатов слота к актёру; только game thread */
+    void CommitSlot(int32 Slot);
+
+    /** Ставит таймер моргания слота в колесо (или запоминает остаток, если слот на паузе) */
+    void ScheduleBlinkTimer(int32 Slot, float Delay, bool bRestorePhase);
+    /** Все сработавшие за кадр моргания одним проходом */
+    void FireDueBlinks(float DeltaTime);
+
+    /** stat Character2D: активные каналы и моргания в секунду */
+    void UpdateStats(float DeltaTime);
+
+    /* ─── Общие ─── */
+    TArray<TWeakObjectPtr<ACharacter2DActor>> SlotActors;
+    TArray<uint8> SlotChannels;
+    TArray<uint16> SlotOutputs;
+    TArray<FRandomStream> SlotRandom;
+    TArray<int32> FreeSlots;
+    TMap<TWeakObjectPtr<ACharacter2DActor>, int32> SlotLookup;
+
+    FCharacter2DTweenPool TweenPool{TweenPoolCapacity};
+    /** Кривые твинов по хэндлу пула */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UCurveFloat>> TweenCurves;
+
+    /* ─── Movement ─── */
+    TArray<FVector> MoveFrom;
+    TArray<FVector> MoveTo;
+    TArray<int32> MoveTween;
+
+    /* ─── Fade ─── */
+    TArray<bool> FadeIn;
+    TArray<int32> FadeTween;
+
+    /* ─── Emotion ─── */
+    TArray<ECharacter2DEmotionEffect> EmotionType;
+    TArray<float> EmotionIntensity;
+    TArray<FLinearColor> EmotionColor;
+    TArray<FVector> EmotionBaseLocation;
+    TArray<FVector> EmotionBaseScale;
+    TArray<bool> EmotionOnGpu;
+    TArray<int32> EmotionTween;
+
+    /** Время, на которое продвинуты твины при запуске; выставляет директор на время применения команды */
+    float StartOffset = 0.0f;
+
+    /* ─── Blink ─── */
+    FCharacter2DTimingWheel BlinkWheel;
+    TArray<FCharacter2DTimingWheel::FEntry> DueBlinks;
+    /** Меняется при каждой перестановке/отмене: записи колеса со старым значением устарели */
+    TArray<uint32> BlinkCookie;
+    TArray<uint64> BlinkFireTick;
+    /** Остаток до срабатывания, пока слот на паузе */
+    TArray<float> BlinkRemaining;
+    TArray<bool> BlinkRestorePhase;
+    TArray<bool> BlinkPaused;
+    int32 BlinksThisSecond = 0;
+    float BlinkStatWindow = 0.0f;
+
+    /* ─── Результаты прохода ─── */
+    TArray<FVector> OutLocation;
+    TArray<FVector> OutScale;
+    TArray<FLinearColor> OutColor;
+    TArray<float> OutOpacity;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Queue.h"
+#include "Character2DAsset.h"
+#include <atomic>
+#include "Character2DDirector.generated.h"
+
+class ACharacter2DActor;
+
+/* ───────────────────────────── Command ───────────────────────────── */
+UENUM(BlueprintType)
+enum class ECharacter2DCommandType : uint8
+{
+    Move,
+    FadeIn,
+    FadeOut,
+    Emotion,
+    StopEmotion,
+    Blinking,
+    Talking,
+    Expression,
+    SpritesVisible,
+    SkeletalVisible
+};
+
+/** Команда персонажу для UCharacter2DDirector; используются только поля своего типа */
+struct FCharacter2DCommand
+{
+    TWeakObjectPtr<ACharacter2DActor> Actor;
+    ECharacter2DCommandType Type = ECharacter2DCommandType::Move;
+
+    /** Время мира (UWorld::GetTimeSeconds) в момент выдачи; ставится в Enqueue, отрицательное — ещё не выдана */
+    double IssueTime = -1.0;
+
+    /* Move */
+    FVector Location = FVector::ZeroVector;
+    FCharacter2DMovementSettings Movement;
+
+    /* FadeIn / FadeOut */
+    float Duration = 1.0f;
+
+    /* Emotion */
+    ECharacter2DEmotionEffect Emotion = ECharacter2DEmotionEffect::None;
+    FCharacter2DEmotionSettings EmotionSettings;
+
+    /* Blinking / Talking / SpritesVisible / SkeletalVisible */
+    bool bEnable = false;
+
+    /* Expression */
+    FName Expression;
+};
+
+/**
+ * Пакетное применение команд сценария к персонажам мира.
+ *
+ * Команды принимаются с любого потока (парсер диалогов, загрузка сцены) в
+ * lock-free очередь MPSC; раз в кадр game thread забирает всё накопленное,
+ * сводит команды одного персонажа (последняя побеждает, fade-in и fade-out
+ * в одном кадре взаимно гасятся) и применяет одним проходом.
+ * Анимации стартуют со сдвигом на время от выдачи до применения, поэтому
+ * команда, выданная посреди кадра, идёт в той же фазе, что и вызванная сразу.
+ */
+UCLASS()
+class CHARACTER2DRUNTIME_API UCharacter2DDirector : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    static UCharacter2DDirector* Get(const UObject* WorldContextObject);
+
+    /** Потокобезопасно; актёр должен оставаться живым до выдачи (слабая ссылка берётся на вызывающем потоке) */
+    void Enqueue(FCharacter2DCommand&& Command);
+
+    /* ─── Convenience (любой поток) ─── */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void MoveTo(ACharacter2DActor* Actor, const FVector& Location, const FCharacter2DMovementSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void FadeIn(ACharacter2DActor* Actor, float Duration = 1.0f);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void FadeOut(ACharacter2DActor* Actor, float Duration = 1.0f);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void PlayEmotion(ACharacter2DActor* Actor, ECharacter2DEmotionEffect Emotion, const FCharacter2DEmotionSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void StopEmotion(ACharacter2DActor* Actor);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void SetBlinking(ACharacter2DActor* Actor, bool bEnable);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void SetTalking(ACharacter2DActor* Actor, bool bEnable);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void SetExpression(ACharacter2DActor* Actor, FName Expression);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void SetSpritesVisible(ACharacter2DActor* Actor, bool bVisible);
+
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void SetSkeletalVisible(ACharacter2DActor* Actor, bool bVisible);
+
+    /** Применить накопленное сейчас, не дожидаясь Tick (game thread) */
+    UFUNCTION(BlueprintCallable, Category="Character2D|Director")
+    void Flush();
+
+    /** Команд применено / отброшено сведением с начала мира */
+    int32 GetNumApplied() const { return NumApplied; }
+    int32 GetNumCoalesced() const { return NumCoalesced; }
+
+    //~ Begin USubsystem / UWorldSubsystem Interface
+    virtual void Deinitialize() override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~ End USubsystem / UWorldSubsystem Interface
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~ End FTickableGameObject Interface
+
+private:
+    /** Итог кадра для одного персонажа: индексы в Drained по видам команд */
+    struct FPendingBatch
+    {
+        int32 Move = INDEX_NONE;
+        int32 Fade = INDEX_NONE;
+        int32 Emotion = INDEX_NONE;
+        int32 Blinking = INDEX_NONE;
+        int32 Talking = INDEX_NONE;
+        int32 Expression = INDEX_NONE;
+        int32 SpritesVisible = INDEX_NONE;
+        int32 SkeletalVisible = INDEX_NONE;
+    };
+
+    void Enqueue(ACharacter2DActor* Actor, ECharacter2DCommandType Type, TFunctionRef<void(FCharacter2DCommand&)> Setup);
+    /** Сводит Drained в Batches; возвращает число отброшенных команд */
+    int32 Coalesce();
+    void ApplyBatch(ACharacter2DActor* Actor, const FPendingBatch& Batch, double ApplyTime, float MaxCatchUp);
+
+    /**
+     * Часы команд — время мира: стоит на паузе, учитывает замедление времени и хитчи, поглощённые миром.
+     * На game thread читается из мира, с других потоков — значение, опубликованное в последнем Tick
+     */
+    double GetCommandClock() const;
+
+    TQueue<FCharacter2DCommand, EQueueMode::Mpsc> Commands;
+
+    /** Переиспользуемые между кадрами буферы */
+    TArray<FCharacter2DCommand> Drained;
+    TMap<TWeakObjectPtr<ACharacter2DActor>, FPendingBatch> Batches;
+
+    float LastDeltaTime = 0.0f;
+    /** UWorld::GetTimeSeconds() на последнем Tick — для Enqueue не с game thread */
+    std::atomic<double> PublishedWorldTime{0.0};
+    bool bFlushing = false;
+    int32 NumApplied = 0;
+    int32 NumCoalesced = 0;
+};
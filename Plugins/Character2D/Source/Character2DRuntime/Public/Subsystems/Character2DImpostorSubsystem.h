@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Character2DImpostorSubsystem.generated.h"
+
+class ACharacter2DActor;
+class ASceneCapture2D;
+class UTextureRenderTarget2D;
+
+/**
+ * Импосторы персонажей: статичная композиция (спрайтовые слои + скелетные части)
+ * один раз снимается ортографической камерой в render target из пула и дальше
+ * рисуется одним квадом UCharacter2DLayeredSpriteComponent.
+ *
+ * Запекание по запросу ACharacter2DActor::InvalidateImpostor, не больше
+ * Character2D.Impostor.MaxBakesPerFrame за кадр.
+ */
+UCLASS()
+class CHARACTER2DRUNTIME_API UCharacter2DImpostorSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** Шаг размеров render target: близкие размеры переиспользуют одну цель */
+    static constexpr int32 TargetSizeStep = 64;
+    static constexpr int32 MaxTargetSize = 2048;
+
+    /** Сколько свободных целей держать в пуле */
+    static constexpr int32 MaxPooledTargets = 16;
+
+    static UCharacter2DImpostorSubsystem* Get(const UObject* WorldContextObject);
+
+    static bool IsEnabled();
+
+    /** Запечь импостор актёра на ближайшем тике (повторный запрос не дублируется) */
+    void RequestBake(ACharacter2DActor* Actor);
+    void CancelBake(ACharacter2DActor* Actor);
+
+    /** Вернуть цель в пул */
+    void ReleaseTarget(UTextureRenderTarget2D* Target);
+
+    int32 GetNumPooledTargets() const { return FreeTargets.Num(); }
+
+    //~ Begin USubsystem / UWorldSubsystem Interface
+    virtual void Deinitialize() override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~ End USubsystem / UWorldSubsystem Interface
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~ End FTickableGameObject Interface
+
+private:
+    bool Bake(ACharacter2DActor& Actor);
+    UTextureRenderTarget2D* AcquireTarget(FIntPoint Size);
+    ASceneCapture2D* GetOrCreateCapture();
+
+    TArray<TWeakObjectPtr<ACharacter2DActor>> PendingBakes;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UTextureRenderTarget2D>> FreeTargets;
+
+    UPROPERTY(Transient)
+    TObjectPtr<ASceneCapture2D> CaptureActor;
+};
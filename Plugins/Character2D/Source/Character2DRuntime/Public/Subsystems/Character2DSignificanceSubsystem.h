@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Character2DEnums.h"
+#include "Character2DSignificanceSubsystem.generated.h"
+
+class ACharacter2DActor;
+
+/**
+ * Значимость персонажей мира: оценка по размеру на экране, видимости и роли
+ * говорящего, по оценке — уровень детализации (Full / Reduced / Dormant).
+ *
+ * Пороги и бюджеты уровней — консольные переменные Character2D.Significance.*;
+ * пересчёт раз в UpdateInterval, актёру уровень применяется только при смене.
+ */
+UCLASS()
+class CHARACTER2DRUNTIME_API UCharacter2DSignificanceSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** Добавка к оценке говорящего: он всегда впереди очереди на Full */
+    static constexpr float SpeakerScoreBonus = 1000.0f;
+
+    static UCharacter2DSignificanceSubsystem* Get(const UObject* WorldContextObject);
+
+    /** Параметры уровня Reduced (CVar), применяются актёром */
+    static float GetReducedBlinkIntervalScale();
+    static float GetReducedFlipbookTickInterval();
+
+    void Register(ACharacter2DActor* Actor);
+    void Unregister(ACharacter2DActor* Actor);
+
+    /** Пересчитать уровни на следующем тике (смена говорящего и т.п.) */
+    void RequestUpdate() { TimeUntilUpdate = 0.0f; }
+
+    int32 GetNumInTier(ECharacter2DSignificanceTier Tier) const;
+
+    //~ Begin USubsystem / UWorldSubsystem Interface
+    virtual void Deinitialize() override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~ End USubsystem / UWorldSubsystem Interface
+
+    //~ Begin FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~ End FTickableGameObject Interface
+
+private:
+    /** Точка обзора локального игрока для оценки размера на экране */
+    struct FViewInfo
+    {
+        FVector Location = FVector::ZeroVector;
+        float TanHalfFOV = 1.0f;
+        float OrthoWidth = 0.0f;   // > 0 — ортографическая камера
+    };
+
+    void GatherViews(TArray<FViewInfo, TInlineAllocator<4>>& OutViews) const;
+    float CalcScore(const ACharacter2DActor& Actor, TConstArrayView<FViewInfo> Views) const;
+    void UpdateTiers();
+
+    /** Выключение CVar Enable: всех вернуть в Full */
+    void ResetTiers();
+
+    TArray<TWeakObjectPtr<ACharacter2DActor>> Actors;
+    TArray<ECharacter2DSignificanceTier> Tiers;
+    TArray<float> Scores;
+
+    float TimeUntilUpdate = 0.0f;
+    bool bWasEnabled = false;
+};